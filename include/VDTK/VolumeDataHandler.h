@@ -1,34 +1,114 @@
 #pragma once
+#include <memory>
+#include <mutex>
 
 #include "common/CommonDataTypes.h"
 
 namespace VDTK {
+class BrickMinMaxMap;
+class PointOperationChain;
+class StatisticsSampler;
+
+// Point operations (applyWindow, invertVoxelData, convertEndianness) are recorded and applied
+// together in a single pass as soon as the voxels are needed (other operations, exports or
+// reading the volume). Const methods may apply them, the lazily computed state is guarded by a
+// mutex, so const methods can be called from several threads at the same time
 class VolumeDataHandler {
 public:
     VolumeDataHandler(
         const std::size_t numberOfUsableThreads = std::thread::hardware_concurrency());
+    VolumeDataHandler(const VolumeDataHandler& other);
     ~VolumeDataHandler();
 
+    // 8, 12 (packed, two voxels in three bytes) or 16 bit
     bool importRawFile(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
-                       const VolumeSize& size, const VolumeSpacing& spacing);
+                       const VolumeSize& size, const VolumeSpacing& spacing,
+                       const Endianness endianness = Endianness::Little);
+    // imports every stride-th voxel of the box [regionOffset, regionOffset + regionSize) of a RAW
+    // file with fileVolumeSize, only the needed parts of the file are read. The spacing gets
+    // multiplied with the stride
+    bool importRawFileRegion(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+                             const VolumeSize& fileVolumeSize, const VolumeSpacing& spacing,
+                             const VolumeSize& regionOffset, const VolumeSize& regionSize,
+                             const VolumeSize& stride = VolumeSize(1),
+                             const Endianness endianness = Endianness::Little);
+    // voxel value = rescaled value (raw * slope + intercept) + 32768
+    bool importRawFileSigned16Bit(const std::filesystem::path& filePath, const VolumeSize& size,
+                                  const VolumeSpacing& spacing, const float rescaleSlope = 1.0f,
+                                  const float rescaleIntercept = 0.0f,
+                                  const Endianness endianness = Endianness::Little);
+    // [minimum, maximum] gets mapped to [0, UINT16_MAX]. If minimum is not smaller than maximum,
+    // the range of the file gets used
+    bool importRawFileFloat32(const std::filesystem::path& filePath, const VolumeSize& size,
+                              const VolumeSpacing& spacing, const float minimum = 0.0f,
+                              const float maximum = 0.0f,
+                              const Endianness endianness = Endianness::Little);
+
+    // MetaImage header (.mhd with detached data or .mha), the data gets mapped into memory.
+    // Signed voxels get an offset of 32768, float voxels are mapped from their range
+    bool importMetaImageFile(const std::filesystem::path& filePath);
+    // NRRD header (.nrrd or .nhdr with detached data), converted like MetaImage files
+    bool importNrrdFile(const std::filesystem::path& filePath);
+    // native container with size, spacing and compressed bricks
+    bool importVdtkFile(const std::filesystem::path& filePath);
+    // reads only the bricks overlapping the box [regionOffset, regionOffset + regionSize)
+    bool importVdtkFileRegion(const std::filesystem::path& filePath,
+                              const VolumeSize& regionOffset, const VolumeSize& regionSize);
 
     bool importMonochromBitmapFolder(const std::filesystem::path& directoryPath,
                                      const VolumeAxis axis, const VolumeSpacing& spacing);
     bool importColorBitmapFolder(const std::filesystem::path& directoryPath, const VolumeAxis axis,
                                  const VolumeSpacing& spacing);
 
+    // pixels of a slice file are stored row by row: x fastest for XY and XZ slices, y fastest for
+    // YZ slices
     bool importBinarySlices(const std::filesystem::path& directoryPath, const uint8_t bitsPerVoxel,
                             const VolumeAxis axis, const VolumeSize& size,
-                            const VolumeSpacing& spacing);
-
-    // export with 8 or 16 bit
-    bool exportRawFile(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel) const;
+                            const VolumeSpacing& spacing,
+                            const Endianness endianness = Endianness::Little);
+
+    // export with 8, 12 (packed) or 16 bit
+    // with directIO the page cache gets bypassed (Linux only, if supported by the file system)
+    bool exportRawFile(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+                       const bool directIO = false) const;
+    // inverse of importRawFileSigned16Bit
+    bool exportRawFileSigned16Bit(const std::filesystem::path& filePath,
+                                  const float rescaleSlope = 1.0f,
+                                  const float rescaleIntercept = 0.0f,
+                                  const bool directIO = false) const;
+    // [0, UINT16_MAX] gets mapped to [minimum, maximum]
+    bool exportRawFileFloat32(const std::filesystem::path& filePath, const float minimum = 0.0f,
+                              const float maximum = 1.0f, const bool directIO = false) const;
+    // 16 bit voxels, .mha files contain the data, .mhd headers get a .raw file next to them
+    bool exportMetaImageFile(const std::filesystem::path& filePath) const;
+    // 16 bit voxels, .nhdr headers get a .raw file next to them, other files contain the data
+    bool exportNrrdFile(const std::filesystem::path& filePath) const;
+    // every brick gets compressed on its own, bricks at the borders are cut to the volume
+    bool exportVdtkFile(const std::filesystem::path& filePath,
+                        const VolumeSize& brickSize = VolumeSize(64)) const;
     // if path is a directory path, generic file name gets generated
     bool exportToBitmapColor(const std::filesystem::path& directoryPath) const;
     // if path is a directory path, generic file name gets generated
     bool exportToBitmapMonochrom(const std::filesystem::path& directoryPath) const;
-
-    // gets the raw voxel value from the curren volume on a given position
+    // exports slices firstSlice, firstSlice + stride, ... up to lastSlice (inclusive) of the
+    // selected axes. lastSlice gets clamped to the last slice of each axis
+    bool exportToBitmapColor(const std::filesystem::path& directoryPath,
+                             const std::vector<VolumeAxis>& axes, const std::size_t firstSlice,
+                             const std::size_t lastSlice, const std::size_t stride = 1) const;
+    bool exportToBitmapMonochrom(const std::filesystem::path& directoryPath,
+                                 const std::vector<VolumeAxis>& axes, const std::size_t firstSlice,
+                                 const std::size_t lastSlice, const std::size_t stride = 1) const;
+    // single slice into one bitmap file, e.g. a projection
+    bool exportSliceToBitmapColor(const std::filesystem::path& filePath,
+                                  const VolumeSlice& slice) const;
+    bool exportSliceToBitmapMonochrom(const std::filesystem::path& filePath,
+                                      const VolumeSlice& slice) const;
+    // binary STL (triangles with normals) or PLY (shared vertices), e.g. an isosurface
+    bool exportMeshToStl(const std::filesystem::path& filePath, const SurfaceMesh& mesh) const;
+    bool exportMeshToPly(const std::filesystem::path& filePath, const SurfaceMesh& mesh) const;
+
+    // gets the raw voxel value from the curren volume on a given position, recorded point
+    // operations are applied to this voxel only
     uint16_t getRawValue(const std::size_t x, const std::size_t y, const std::size_t z) const;
     const VolumeData getVolumeData() const;
     const VolumeSize getVolumeSize() const;
@@ -43,9 +123,18 @@ public:
     void cutBorders(const float thresholdISO);
     // threshold between 0 and UINT16_MAX
     void cutBorders(const uint16_t thresholdISO);
+    // crops the volume to the box [offset, offset + size), which has to be inside of the volume
+    bool crop(const VolumeSize& offset, const VolumeSize& size);
 
     void invertVoxelData();
 
+    // reorders the axes of the volume, e.g. (Axis::Z, Axis::Y, Axis::X) swaps x and z
+    // every axis has to be used exactly once
+    void permuteAxes(const Axis newX, const Axis newY, const Axis newZ);
+    void flipAxis(const Axis axis);
+    // rotates counterclockwise around the given axis by a multiple of 90 degree
+    void rotate90(const Axis rotationAxis, const int quarterTurns = 1);
+
     // scales volume to the choosen size
     void scaleToSize(const ScaleMode scaleMode, const VolumeSize& size);
     // scales each dimension to so each dimension has choosen spacing
@@ -57,20 +146,100 @@ public:
     void scaleWithFactor(const ScaleMode scaleMode, const float factorX, const float factorY,
                          const float factorZ);
 
+    // applies an affine transformation (rotation, shear, scaling, translation) given in physical
+    // coordinates (voxel index * spacing). Size and spacing of the volume stay the same
+    // returns false if the transformation can not be inverted
+    bool applyAffineTransform(const ScaleMode scaleMode, const AffineMatrix& transformation);
+    // resamples the transformed volume onto a new grid (for example the grid of another volume)
+    // origin is the physical position of the first voxel of the new grid, a spacing of zero is
+    // treated as unit spacing
+    bool resampleToGrid(const ScaleMode scaleMode, const AffineMatrix& transformation,
+                        const VolumeSize& size, const VolumeSpacing& spacing,
+                        const Vector3D<float>& origin = Vector3D<float>(0.0f));
+
+    // maximum, minimum or average of the slices [firstSlice, lastSlice] of the axis (lastSlice gets
+    // clamped), e.g. XYAxis projects along z. Width and height are the same as for getSlice
+    const VolumeSlice getProjection(const ProjectionMode mode, const VolumeAxis axis,
+                                    const std::size_t firstSlice = 0,
+                                    const std::size_t lastSlice = SIZE_MAX) const;
+
+    // direct volume rendering on the CPU, the image can be exported with exportSliceToBitmap*
+    const VolumeSlice renderVolume(const RenderSettings& settings) const;
+    // marching cubes surface around the voxels greater or equal to isoValue, vertices in physical
+    // coordinates (voxel index * spacing)
+    const SurfaceMesh extractIsosurface(const uint16_t isoValue) const;
+
     const std::vector<uint16_t> getHistogram() const;
     const std::vector<uint16_t> getHistogramWidthWindowing(WindowingFunction func,
                                                            int32_t windowCenter, int32_t windowWidth,
                                                            int32_t windowOffset) const;
+    // computed in one parallel pass and cached until the volume changes. The reference stays
+    // valid until then
+    const VolumeStatistics& getStatistics() const;
+    // estimated from samplesPerBrick random voxels of every 16x16x16 brick, with error bounds
+    ApproximateVolumeStatistics getApproximateStatistics(
+        const std::size_t samplesPerBrick = 64) const;
+    // refines the estimate in the background with more samples per round until it is exact.
+    // Every change of the volume stops the refinement
+    void startStatisticsRefinement(const std::size_t initialSamplesPerBrick = 64);
+    // most precise estimate of the refinement so far
+    ApproximateVolumeStatistics getRefinedStatistics() const;
+    // connected components of the voxels in [lowerThreshold, upperThreshold] with label volume,
+    // voxel counts and bounding boxes. Returns false if the volume has UINT32_MAX or more voxels
+    bool labelConnectedComponents(const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                                  const Connectivity connectivity,
+                                  ComponentLabels* const components) const;
+    // exact euclidean distance of every voxel to the voxels in [lowerThreshold, upperThreshold],
+    // respecting the spacing. Signed distances are negative inside of the interval
+    const DistanceMap getDistanceMap(const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                                     const bool signedDistance = false) const;
+    // region growing: voxels in [lowerThreshold, upperThreshold] connected (6 neighbours) to one
+    // of the seed positions, several seeds are grown in parallel
+    const VolumeMask growRegion(const std::vector<VolumeSize>& seeds,
+                                const uint16_t lowerThreshold,
+                                const uint16_t upperThreshold) const;
 
     void convertEndianness();
 
+    // applies the recorded point operations now
+    void applyPendingOperations();
+
+    // keeps the minimum and maximum of every brick (edge length in voxels), so operations like
+    // cutBorders can skip bricks. It gets rebuilt when needed after the volume changed
+    void enableBrickMinMax(const std::size_t brickSize = 16);
+    void disableBrickMinMax();
+
     static void printLegalNotice();
 
 private:
-    // voxel data is stored here
-    VolumeData m_VolumeData = VolumeData(VolumeSize(0, 0, 0), VolumeSpacing(0.0, 0.0, 0.0));
+    // voxel data is stored here, mutable so const accessors can apply recorded point operations
+    // (guarded by m_lazyStateMutex)
+    mutable VolumeData m_VolumeData =
+        VolumeData(VolumeSize(0, 0, 0), VolumeSpacing(0.0, 0.0, 0.0));
+    // point operations that are not applied to m_VolumeData yet
+    const std::unique_ptr<PointOperationChain> m_pendingOperations;
+    // built on demand, brick size 0 disables it
+    const std::unique_ptr<BrickMinMaxMap> m_brickMinMaxMap;
+    // reads m_VolumeData in the background, declared after it to be destroyed first
+    const std::unique_ptr<StatisticsSampler> m_statisticsSampler;
+    std::size_t m_brickMinMaxSize = 0;
+    mutable VolumeStatistics m_statistics;
+    mutable bool m_statisticsValid = false;
+    // guards everything const methods change: pending operations, statistics and brick map
+    mutable std::mutex m_lazyStateMutex;
     const std::size_t m_numberOfThreads;
 
+    void materialize() const;
+    // recorded point operations belong to the replaced volume
+    bool replaceVolume(const bool imported);
+    // called before every change of the voxels
+    void prepareVolumeChange();
+    // stops background work on the voxels and drops everything computed from them, has to be
+    // called before the voxels change
+    void invalidateDerivedData() const;
+    // nullptr if disabled
+    const BrickMinMaxMap* getBrickMinMaxMap() const;
+
     void scaleVolume(const ScaleMode scaleMode, const float factorX, const float factorY,
                      const float factorZ);
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "common/CommonDataTypes.h"
+
+namespace VDTK {
+// Streams a volume from a source through a chain of operations into a sink, slab by slab along
+// the z axis, so the whole volume is never held in memory.
+// Every operation declares how many neighbouring slices it needs (halo). Each slab is read with
+// the halos of all operations and only its inner slices are written. The next slab is read while
+// the current one is processed and written slabs are flushed on a background thread, so at most
+// a few slabs are held in memory
+class VolumePipeline {
+public:
+    VolumePipeline(const std::size_t numberOfUsableThreads = std::thread::hardware_concurrency());
+    ~VolumePipeline();
+
+    // 8, 12 (packed) or 16 bit RAW file
+    void setRawFileSource(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+                          const VolumeSize& size, const VolumeSpacing& spacing,
+                          const Endianness endianness = Endianness::Little);
+    // series of 8 or 16 bit XY binary slices, one file per z slice in natural file name order
+    void setBinarySliceSource(const std::filesystem::path& directoryPath,
+                              const uint8_t bitsPerVoxel, const VolumeSize& size,
+                              const VolumeSpacing& spacing,
+                              const Endianness endianness = Endianness::Little);
+    // 8, 12 (packed) or 16 bit little endian RAW file
+    void setRawFileSink(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel);
+
+    // operations are executed in the order they are added
+    void addWindow(const WindowingFunction func, const int32_t windowCenter,
+                   const int32_t windowWidth, const int32_t windowOffset);
+    // needs kernel size / 2 slices on each side
+    void addGridFilter(const FilterKernel& filter);
+    void addInvert();
+    void clearOperations();
+
+    // number of output slices processed at once
+    void setSlabThickness(const std::size_t numberOfSlices);
+
+    bool execute() const;
+
+private:
+    enum class SourceType { None, RawFile, BinarySlices };
+    enum class OperationType { Window, GridFilter, Invert };
+
+    struct Operation {
+        OperationType type = OperationType::Invert;
+        WindowingFunction func = WindowingFunction::Linear;
+        int32_t windowCenter = 0;
+        int32_t windowWidth = 0;
+        int32_t windowOffset = 0;
+        // index into m_filterKernels
+        std::size_t filterIndex = 0;
+    };
+
+    // number of slices needed on each side of a slab by all operations together
+    std::size_t getHalo() const;
+    // reads the slices [firstSlice, lastSlice) of the source
+    bool readSlab(const std::vector<std::filesystem::path>& slicePaths,
+                  const std::size_t firstSlice, const std::size_t lastSlice,
+                  VolumeData* const slab) const;
+    void applyOperations(VolumeData* const slab) const;
+
+    SourceType m_sourceType = SourceType::None;
+    std::filesystem::path m_sourcePath;
+    uint8_t m_sourceBitsPerVoxel = 16;
+    VolumeSize m_size = VolumeSize(0);
+    VolumeSpacing m_spacing = VolumeSpacing(0.0f);
+    Endianness m_sourceEndianness = Endianness::Little;
+
+    std::filesystem::path m_sinkPath;
+    uint8_t m_sinkBitsPerVoxel = 16;
+
+    std::vector<Operation> m_operations;
+    std::vector<FilterKernel> m_filterKernels;
+
+    std::size_t m_slabThickness = 16;
+    const std::size_t m_numberOfThreads;
+};
+} // namespace VDTK
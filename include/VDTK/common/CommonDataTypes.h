@@ -1,5 +1,8 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -14,9 +17,20 @@ enum class ScaleMode { NearestNeighbor, Linear, Cubic };
 
 enum class VolumeAxis { YZAxis, XZAxis, XYAxis };
 
+enum class Axis { X, Y, Z };
+
+// byte order of voxel values with more than 8 bit in files
+enum class Endianness { Little, Big };
+
 // VOI LUT functions
 enum class WindowingFunction { Linear, LinearExact, Sigmoid };
 
+// maximum (MIP), minimum (MinIP) or average intensity projection
+enum class ProjectionMode { Maximum, Minimum, Average };
+
+// neighbours sharing a face (6), a face or an edge (18) or any corner (26)
+enum class Connectivity { Face, Edge, Corner };
+
 template <typename T>
 class Vector3D {
 public:
@@ -146,6 +160,111 @@ private:
 typedef Vector3D<std::size_t> VolumeSize;
 typedef Vector3D<float> VolumeSpacing;
 
+// camera and transfer function of the volume renderer
+// positions are physical coordinates (voxel index * spacing)
+struct RenderSettings {
+    enum class Projection { Orthographic, Perspective };
+
+    Projection projection = Projection::Perspective;
+    // if eye and target are equal, the camera looks from the front (-y) onto the volume center
+    Vector3D<float> eye = Vector3D<float>(0.0f);
+    Vector3D<float> target = Vector3D<float>(0.0f);
+    Vector3D<float> up = Vector3D<float>(0.0f, 0.0f, 1.0f);
+    // vertical field of view in degree (perspective)
+    float fieldOfView = 30.0f;
+    // visible height in physical units (orthographic), 0 fits the whole volume into the image
+    float viewHeight = 0.0f;
+    std::size_t imageWidth = 512;
+    std::size_t imageHeight = 512;
+
+    // the windowed voxel value is the brightness and the density of a sample
+    WindowingFunction windowingFunction = WindowingFunction::Linear;
+    int32_t windowCenter = 32768;
+    int32_t windowWidth = 65536;
+    int32_t windowOffset = 0;
+    // opacity coefficient per physical unit of a sample with the maximum windowed value
+    float density = 0.05f;
+    // distance between two samples of a ray in voxels of the smallest spacing
+    float sampleDistance = 0.5f;
+};
+
+// triangle mesh with shared vertices, positions are physical coordinates (voxel index * spacing)
+// triangles are counterclockwise seen from outside
+struct SurfaceMesh {
+    std::vector<std::array<float, 3>> vertices;
+    std::vector<std::array<uint32_t, 3>> triangles;
+};
+
+// voxel count and bounding box [offset, offset + size) of a connected component
+struct ConnectedComponent {
+    uint64_t voxelCount = 0;
+    VolumeSize offset = VolumeSize(0);
+    VolumeSize size = VolumeSize(0);
+};
+
+// label per voxel in zyx order, 0 is background and label i belongs to components[i - 1]
+// components are ordered by their first voxel
+struct ComponentLabels {
+    VolumeSize size = VolumeSize(0);
+    std::vector<uint32_t> labels;
+    std::vector<ConnectedComponent> components;
+};
+
+// distance per voxel in zyx order in physical units (voxel index * spacing)
+struct DistanceMap {
+    VolumeSize size = VolumeSize(0);
+    std::vector<float> distances;
+};
+
+// one bit per voxel in zyx order, e.g. a segmented region
+class VolumeMask {
+public:
+    VolumeMask(const VolumeSize& size)
+        : m_size(size), m_words((size.getX() * size.getY() * size.getZ() + 63) / 64, 0) {}
+
+    const VolumeSize& getSize() const {
+        return m_size;
+    }
+
+    bool get(const std::size_t x, const std::size_t y, const std::size_t z) const {
+        // check if position is within volume size
+        assert(x < m_size.getX() && y < m_size.getY() && z < m_size.getZ());
+        const std::size_t index = x + m_size.getX() * (y + m_size.getY() * z);
+        return ((m_words[index / 64] >> (index % 64)) & 1) != 0;
+    }
+    void set(const std::size_t x, const std::size_t y, const std::size_t z, const bool value) {
+        // check if position is within volume size
+        assert(x < m_size.getX() && y < m_size.getY() && z < m_size.getZ());
+        const std::size_t index = x + m_size.getX() * (y + m_size.getY() * z);
+        const uint64_t bit = uint64_t(1) << (index % 64);
+        m_words[index / 64] = value ? (m_words[index / 64] | bit) : (m_words[index / 64] & ~bit);
+    }
+
+    // number of set voxels
+    std::size_t getCount() const {
+        std::size_t count = 0;
+        for (const uint64_t word : m_words) {
+            count += std::bitset<64>(word).count();
+        }
+        return count;
+    }
+
+    // voxel i is bit i % 64 of word i / 64
+    std::vector<uint64_t>& getWords() {
+        return m_words;
+    }
+    const std::vector<uint64_t>& getWords() const {
+        return m_words;
+    }
+
+private:
+    VolumeSize m_size = VolumeSize(0);
+    std::vector<uint64_t> m_words;
+};
+
+// 4x4 matrix in row major order for affine transformations of homogeneous coordinates (x, y, z, 1)
+typedef std::array<std::array<double, 4>, 4> AffineMatrix;
+
 class VolumeSlice {
 public:
     VolumeSlice(const VolumeAxis axis, const std::size_t width, const std::size_t height)
@@ -195,6 +314,16 @@ public:
         // initialize volume data with size and all values equal to zero
         m_Data = std::vector<uint16_t>(m_VoxelCount, 0);
     }
+    // takes ownership of already existing voxel data (stored in zyx order)
+    VolumeData(const VDTK::VolumeSize size, const VDTK::VolumeSpacing spacing,
+               std::vector<uint16_t>&& data) {
+        m_Size = size;
+        m_Spacing = spacing;
+        m_VoxelCount = m_Size.getX() * m_Size.getY() * m_Size.getZ();
+
+        assert(data.size() == m_VoxelCount);
+        m_Data = std::move(data);
+    }
 
     const VDTK::VolumeSize getSize() const {
         return m_Size;
@@ -290,6 +419,10 @@ public:
     const std::vector<uint16_t>& getRawVolumeData() const {
         return m_Data;
     }
+    // direct write access for filters working on whole rows or slices
+    std::vector<uint16_t>& getRawVolumeData() {
+        return m_Data;
+    }
 
 private:
     uint64_t m_VoxelCount = 0;
@@ -377,6 +510,211 @@ private:
     }
 };
 
+// minimum, maximum, mean, standard deviation and percentiles of all voxel values, derived from
+// the number of voxels per value
+class VolumeStatistics {
+public:
+    VolumeStatistics() {}
+    // histogram has one entry per 16 bit value
+    explicit VolumeStatistics(std::vector<uint64_t>&& histogram) {
+        assert(histogram.size() == UINT16_MAX + 1);
+        m_histogram = std::move(histogram);
+
+        double sum = 0.0;
+        for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+            if (m_histogram[value] > 0) {
+                if (m_voxelCount == 0) {
+                    m_minimum = static_cast<uint16_t>(value);
+                }
+                m_maximum = static_cast<uint16_t>(value);
+                m_voxelCount += m_histogram[value];
+                sum += static_cast<double>(m_histogram[value]) * static_cast<double>(value);
+            }
+        }
+        if (m_voxelCount == 0) {
+            return;
+        }
+        m_mean = sum / static_cast<double>(m_voxelCount);
+
+        // second pass over the histogram, so large volumes do not lose precision
+        double squaredDeviations = 0.0;
+        for (std::size_t value = m_minimum; value <= m_maximum; value++) {
+            const double deviation = static_cast<double>(value) - m_mean;
+            squaredDeviations += static_cast<double>(m_histogram[value]) * deviation * deviation;
+        }
+        m_standardDeviation = std::sqrt(squaredDeviations / static_cast<double>(m_voxelCount));
+    }
+
+    uint64_t getVoxelCount() const {
+        return m_voxelCount;
+    }
+    uint16_t getMinimum() const {
+        return m_minimum;
+    }
+    uint16_t getMaximum() const {
+        return m_maximum;
+    }
+    double getMean() const {
+        return m_mean;
+    }
+    // population standard deviation
+    double getStandardDeviation() const {
+        return m_standardDeviation;
+    }
+    // number of voxels per value
+    const std::vector<uint64_t>& getHistogram() const {
+        return m_histogram;
+    }
+    // smallest value with at least percentile (0.0 to 100.0) percent of all voxels less or equal
+    uint16_t getPercentile(const double percentile) const {
+        const double clampedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+        const uint64_t rank = std::max<uint64_t>(
+            static_cast<uint64_t>(
+                std::ceil(clampedPercentile / 100.0 * static_cast<double>(m_voxelCount))),
+            1);
+        uint64_t count = 0;
+        for (std::size_t value = m_minimum; value < m_maximum; value++) {
+            count += m_histogram[value];
+            if (count >= rank) {
+                return static_cast<uint16_t>(value);
+            }
+        }
+        return m_maximum;
+    }
+
+private:
+    uint64_t m_voxelCount = 0;
+    uint16_t m_minimum = 0;
+    uint16_t m_maximum = 0;
+    double m_mean = 0.0;
+    double m_standardDeviation = 0.0;
+    std::vector<uint64_t> m_histogram = std::vector<uint64_t>(0);
+};
+
+// statistics estimated from a sample of the voxels, with 95 % confidence bounds
+class ApproximateVolumeStatistics {
+public:
+    ApproximateVolumeStatistics() {}
+    // estimatedHistogram has the estimated number of voxels per 16 bit value, exact if every voxel
+    // was sampled
+    ApproximateVolumeStatistics(std::vector<double>&& estimatedHistogram,
+                                const uint64_t sampleCount, const uint64_t voxelCount,
+                                const bool exact)
+        : m_sampleCount(sampleCount), m_voxelCount(voxelCount), m_exact(exact) {
+        assert(estimatedHistogram.size() == UINT16_MAX + 1);
+        m_estimatedHistogram = std::move(estimatedHistogram);
+
+        double sum = 0.0;
+        bool found = false;
+        for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+            if (m_estimatedHistogram[value] > 0.0) {
+                if (!found) {
+                    m_minimum = static_cast<uint16_t>(value);
+                    found = true;
+                }
+                m_maximum = static_cast<uint16_t>(value);
+                m_estimatedVoxelCount += m_estimatedHistogram[value];
+                sum += m_estimatedHistogram[value] * static_cast<double>(value);
+            }
+        }
+        if (!found || m_sampleCount == 0) {
+            return;
+        }
+        m_mean = sum / m_estimatedVoxelCount;
+
+        double squaredDeviations = 0.0;
+        for (std::size_t value = m_minimum; value <= m_maximum; value++) {
+            const double deviation = static_cast<double>(value) - m_mean;
+            squaredDeviations += m_estimatedHistogram[value] * deviation * deviation;
+        }
+        m_standardDeviation = std::sqrt(squaredDeviations / m_estimatedVoxelCount);
+
+        if (!m_exact) {
+            // standard error with finite population correction (voxels of a brick are sampled
+            // without replacement), the stratified sample is at least as precise as a simple
+            // random sample of the same size
+            const double samples = static_cast<double>(m_sampleCount);
+            const double populationCorrection =
+                std::max(1.0 - samples / static_cast<double>(m_voxelCount), 0.0);
+            m_meanError =
+                1.96 * m_standardDeviation / std::sqrt(samples) * std::sqrt(populationCorrection);
+            // Dvoretzky-Kiefer-Wolfowitz inequality: sup |F_sample - F| <= e with 95 %
+            m_rankError = std::sqrt(std::log(2.0 / 0.05) / (2.0 * samples));
+        }
+    }
+
+    uint64_t getVoxelCount() const {
+        return m_voxelCount;
+    }
+    uint64_t getSampleCount() const {
+        return m_sampleCount;
+    }
+    // true if every voxel was counted, all error bounds are 0
+    bool isExact() const {
+        return m_exact;
+    }
+    // of the sample, the minimum of the volume can only be smaller
+    uint16_t getMinimum() const {
+        return m_minimum;
+    }
+    // of the sample, the maximum of the volume can only be larger
+    uint16_t getMaximum() const {
+        return m_maximum;
+    }
+    double getMean() const {
+        return m_mean;
+    }
+    // half width of the 95 % confidence interval getMean() +- getMeanError() of the mean of the
+    // volume, an estimate and not a guaranteed bound
+    double getMeanError() const {
+        return m_meanError;
+    }
+    double getStandardDeviation() const {
+        return m_standardDeviation;
+    }
+    // estimated number of voxels per value
+    const std::vector<double>& getEstimatedHistogram() const {
+        return m_estimatedHistogram;
+    }
+    // maximum error of the fraction of voxels less or equal any value (0.0 to 1.0)
+    double getRankError() const {
+        return m_rankError;
+    }
+    // smallest value with at least percentile (0.0 to 100.0) percent of the estimated voxels
+    // less or equal
+    uint16_t getPercentile(const double percentile) const {
+        const double clampedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+        const double rank = clampedPercentile / 100.0 * m_estimatedVoxelCount;
+        double count = 0.0;
+        for (std::size_t value = m_minimum; value < m_maximum; value++) {
+            count += m_estimatedHistogram[value];
+            if (count >= rank && m_estimatedHistogram[value] > 0.0) {
+                return static_cast<uint16_t>(value);
+            }
+        }
+        return m_maximum;
+    }
+    // the percentile of the volume is within [lowerBound, upperBound]
+    void getPercentileBounds(const double percentile, uint16_t* const lowerBound,
+                             uint16_t* const upperBound) const {
+        *lowerBound = getPercentile(percentile - 100.0 * m_rankError);
+        *upperBound = getPercentile(percentile + 100.0 * m_rankError);
+    }
+
+private:
+    uint64_t m_sampleCount = 0;
+    uint64_t m_voxelCount = 0;
+    bool m_exact = false;
+    double m_estimatedVoxelCount = 0.0;
+    uint16_t m_minimum = 0;
+    uint16_t m_maximum = 0;
+    double m_mean = 0.0;
+    double m_meanError = 0.0;
+    double m_standardDeviation = 0.0;
+    double m_rankError = 0.0;
+    std::vector<double> m_estimatedHistogram = std::vector<double>(0);
+};
+
 class FilterKernel {
 public:
     // only kernel size 3x3x3 and 5x5x5 are supported
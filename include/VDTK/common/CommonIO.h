@@ -1,7 +1,9 @@
 #pragma once
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <assert.h>
 #include <stdint.h>
@@ -22,7 +24,7 @@ static std::size_t numberOfDigits(std::size_t number) {
 }
 
 // checks if a character in a string is a digit
-static bool isADigit(const std::string& s, const std::size_t index) {
+inline bool isADigit(const std::string& s, const std::size_t index) {
     if (index >= s.size()) {
         return false;
     }
@@ -31,6 +33,77 @@ static bool isADigit(const std::string& s, const std::size_t index) {
     return number <= 9;
 }
 
+// compares file names in natural order, so numbers inside of the names are compared by value
+// ("slice_9" comes before "slice_10")
+inline bool naturalLess(const std::string& lhs, const std::string& rhs) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < lhs.size() && j < rhs.size()) {
+        if (isADigit(lhs, i) && isADigit(rhs, j)) {
+            // skip leading zeros and compare the numbers by length first, then digit by digit
+            while (i < lhs.size() && lhs.at(i) == '0') {
+                i++;
+            }
+            while (j < rhs.size() && rhs.at(j) == '0') {
+                j++;
+            }
+            std::size_t endI = i;
+            std::size_t endJ = j;
+            while (isADigit(lhs, endI)) {
+                endI++;
+            }
+            while (isADigit(rhs, endJ)) {
+                endJ++;
+            }
+            if (endI - i != endJ - j) {
+                return endI - i < endJ - j;
+            }
+            const int result = lhs.compare(i, endI - i, rhs, j, endJ - j);
+            if (result != 0) {
+                return result < 0;
+            }
+            i = endI;
+            j = endJ;
+        } else {
+            if (lhs.at(i) != rhs.at(j)) {
+                return lhs.at(i) < rhs.at(j);
+            }
+            i++;
+            j++;
+        }
+    }
+    if (lhs.size() - i != rhs.size() - j) {
+        return lhs.size() - i < rhs.size() - j;
+    }
+    // names only differ in leading zeros
+    return lhs < rhs;
+}
+
+// scans the directory once and returns all regular files with one of the given extensions (all
+// files if no extension is given), sorted in natural order of their file names.
+// directory_iterator itself does not guarantee any order
+inline std::vector<std::filesystem::path> getSortedFilesInDirectory(
+    const std::filesystem::path& directoryPath,
+    const std::vector<std::string>& validExtensions = {}) {
+    std::vector<std::filesystem::path> filePaths;
+    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath)) {
+        const bool isFile = std::filesystem::is_regular_file(directoryEntry);
+        const bool hasValidExtension =
+            validExtensions.empty() ||
+            std::find(validExtensions.begin(), validExtensions.end(),
+                      directoryEntry.path().extension()) != validExtensions.end();
+        if (isFile && hasValidExtension) {
+            filePaths.push_back(directoryEntry.path());
+        }
+    }
+
+    std::sort(filePaths.begin(), filePaths.end(),
+              [](const std::filesystem::path& lhs, const std::filesystem::path& rhs) {
+                  return naturalLess(lhs.filename().string(), rhs.filename().string());
+              });
+    return filePaths;
+}
+
 static void renameIndexedFilesInDirectory(const std::filesystem::path& directoryPath,
                                           const std::string& sliceName = "_IMG",
                                           const std::string& fileExtension = {}) {
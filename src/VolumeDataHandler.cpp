@@ -3,70 +3,241 @@
 #include "file_io/binary_slice/BinarySliceImporter.h"
 #include "file_io/bitmap/BitmapExporter.h"
 #include "file_io/bitmap/BitmapImporter.h"
-#include "file_io/endian_conversion/EndianConverter.h"
+#include "file_io/mesh/MeshWriter.h"
+#include "file_io/meta_image/MetaImageReader.h"
+#include "file_io/meta_image/MetaImageWriter.h"
+#include "file_io/nrrd/NrrdReader.h"
+#include "file_io/nrrd/NrrdWriter.h"
 #include "file_io/raw/RawReader.h"
 #include "file_io/raw/RawWriter.h"
+#include "file_io/vdtk/VdtkReader.h"
+#include "file_io/vdtk/VdtkWriter.h"
 // Filter
+#include "filter/AffineTransformer.h"
 #include "filter/GridFilter.h"
-#include "filter/InvertVoxelsFilter.h"
+#include "filter/PointOperationChain.h"
 #include "filter/VolumeResizer.h"
-#include "filter/WindowFilter.h"
 // Manipulation
 #include "manipulation/EdgeCutter.h"
+#include "manipulation/VolumeReorienter.h"
+// Rendering
+#include "rendering/IntensityProjector.h"
+#include "rendering/MarchingCubes.h"
+#include "rendering/VolumeRenderer.h"
 // Image analysis
+#include "imaga_analysis/BrickMinMaxMap.h"
+#include "imaga_analysis/ConnectedComponentLabeler.h"
+#include "imaga_analysis/DistanceTransform.h"
+#include "imaga_analysis/RegionGrower.h"
+#include "imaga_analysis/StatisticsSampler.h"
 #include "imaga_analysis/histogram.h"
 
 namespace VDTK {
 
 VolumeDataHandler::VolumeDataHandler(const std::size_t numberOfUsableThreads)
-    : m_numberOfThreads((numberOfUsableThreads > 0) ? numberOfUsableThreads : 1) {}
+    : m_pendingOperations(std::make_unique<PointOperationChain>()),
+      m_brickMinMaxMap(std::make_unique<BrickMinMaxMap>()),
+      m_statisticsSampler(std::make_unique<StatisticsSampler>()),
+      m_numberOfThreads((numberOfUsableThreads > 0) ? numberOfUsableThreads : 1) {}
+
+VolumeDataHandler::VolumeDataHandler(const VolumeDataHandler& other)
+    : m_VolumeData(other.m_VolumeData),
+      m_pendingOperations(std::make_unique<PointOperationChain>(*other.m_pendingOperations)),
+      m_brickMinMaxMap(std::make_unique<BrickMinMaxMap>(*other.m_brickMinMaxMap)),
+      m_statisticsSampler(std::make_unique<StatisticsSampler>()),
+      m_brickMinMaxSize(other.m_brickMinMaxSize), m_statistics(other.m_statistics),
+      m_statisticsValid(other.m_statisticsValid), m_numberOfThreads(other.m_numberOfThreads) {}
 
 VolumeDataHandler::~VolumeDataHandler() {}
 
 bool VolumeDataHandler::importRawFile(const std::filesystem::path& filePath,
                                       const uint8_t bitsPerVoxel, const VolumeSize& size,
-                                      const VolumeSpacing& spacing) {
-    return RawReader::read(&m_VolumeData, filePath, bitsPerVoxel, size, spacing);
+                                      const VolumeSpacing& spacing, const Endianness endianness) {
+    invalidateDerivedData();
+    return replaceVolume(RawReader::read(&m_VolumeData, filePath, bitsPerVoxel, size, spacing,
+                                         endianness, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importRawFileRegion(const std::filesystem::path& filePath,
+                                            const uint8_t bitsPerVoxel,
+                                            const VolumeSize& fileVolumeSize,
+                                            const VolumeSpacing& spacing,
+                                            const VolumeSize& regionOffset,
+                                            const VolumeSize& regionSize, const VolumeSize& stride,
+                                            const Endianness endianness) {
+    invalidateDerivedData();
+    return replaceVolume(RawReader::readRegion(&m_VolumeData, filePath, bitsPerVoxel,
+                                               fileVolumeSize, spacing, regionOffset, regionSize,
+                                               stride, endianness, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importRawFileSigned16Bit(const std::filesystem::path& filePath,
+                                                 const VolumeSize& size,
+                                                 const VolumeSpacing& spacing,
+                                                 const float rescaleSlope,
+                                                 const float rescaleIntercept,
+                                                 const Endianness endianness) {
+    invalidateDerivedData();
+    return replaceVolume(RawReader::readSigned16Bit(&m_VolumeData, filePath, size, spacing,
+                                                    rescaleSlope, rescaleIntercept, endianness,
+                                                    m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importRawFileFloat32(const std::filesystem::path& filePath,
+                                             const VolumeSize& size, const VolumeSpacing& spacing,
+                                             const float minimum, const float maximum,
+                                             const Endianness endianness) {
+    invalidateDerivedData();
+    return replaceVolume(RawReader::readFloat32(&m_VolumeData, filePath, size, spacing, minimum,
+                                                maximum, endianness, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importMetaImageFile(const std::filesystem::path& filePath) {
+    invalidateDerivedData();
+    return replaceVolume(MetaImageReader::read(&m_VolumeData, filePath, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importNrrdFile(const std::filesystem::path& filePath) {
+    invalidateDerivedData();
+    return replaceVolume(NrrdReader::read(&m_VolumeData, filePath, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importVdtkFile(const std::filesystem::path& filePath) {
+    invalidateDerivedData();
+    return replaceVolume(VdtkReader::read(&m_VolumeData, filePath, m_numberOfThreads));
+}
+
+bool VolumeDataHandler::importVdtkFileRegion(const std::filesystem::path& filePath,
+                                             const VolumeSize& regionOffset,
+                                             const VolumeSize& regionSize) {
+    invalidateDerivedData();
+    return replaceVolume(VdtkReader::readRegion(&m_VolumeData, filePath, regionOffset, regionSize,
+                                                m_numberOfThreads));
 }
 
 bool VolumeDataHandler::importMonochromBitmapFolder(const std::filesystem::path& directoryPath,
                                                     const VolumeAxis axis,
                                                     const VolumeSpacing& spacing) {
-    return BitmapImporter::importMonochrom(&m_VolumeData, directoryPath, axis, spacing);
+    invalidateDerivedData();
+    return replaceVolume(BitmapImporter::importMonochrom(&m_VolumeData, directoryPath, axis,
+                                                         spacing, m_numberOfThreads));
 }
 
 bool VolumeDataHandler::importColorBitmapFolder(const std::filesystem::path& directoryPath,
                                                 const VolumeAxis axis,
                                                 const VolumeSpacing& spacing) {
-    return BitmapImporter::importColor(&m_VolumeData, directoryPath, axis, spacing);
+    invalidateDerivedData();
+    return replaceVolume(BitmapImporter::importColor(&m_VolumeData, directoryPath, axis, spacing,
+                                                     m_numberOfThreads));
 }
 
 bool VolumeDataHandler::importBinarySlices(const std::filesystem::path& directoryPath,
                                            const uint8_t bitsPerVoxel, const VolumeAxis axis,
-                                           const VolumeSize& size, const VolumeSpacing& spacing) {
-    return BinarySliceImporter::import(&m_VolumeData, directoryPath, bitsPerVoxel, axis, size,
-                                       spacing);
+                                           const VolumeSize& size, const VolumeSpacing& spacing,
+                                           const Endianness endianness) {
+    invalidateDerivedData();
+    return replaceVolume(BinarySliceImporter::import(&m_VolumeData, directoryPath, bitsPerVoxel,
+                                                     axis, size, spacing, endianness,
+                                                     m_numberOfThreads));
 }
 
 bool VolumeDataHandler::exportRawFile(const std::filesystem::path& filePath,
-                                      const uint8_t bitsPerVoxel) const {
-    return RawWriter::write(filePath, bitsPerVoxel, m_VolumeData);
+                                      const uint8_t bitsPerVoxel, const bool directIO) const {
+    materialize();
+    return RawWriter::write(filePath, bitsPerVoxel, m_VolumeData, directIO, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportRawFileSigned16Bit(const std::filesystem::path& filePath,
+                                                 const float rescaleSlope,
+                                                 const float rescaleIntercept,
+                                                 const bool directIO) const {
+    materialize();
+    return RawWriter::writeSigned16Bit(filePath, m_VolumeData, rescaleSlope, rescaleIntercept,
+                                       directIO, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportRawFileFloat32(const std::filesystem::path& filePath,
+                                             const float minimum, const float maximum,
+                                             const bool directIO) const {
+    materialize();
+    return RawWriter::writeFloat32(filePath, m_VolumeData, minimum, maximum, directIO,
+                                   m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportMetaImageFile(const std::filesystem::path& filePath) const {
+    materialize();
+    return MetaImageWriter::write(filePath, m_VolumeData, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportNrrdFile(const std::filesystem::path& filePath) const {
+    materialize();
+    return NrrdWriter::write(filePath, m_VolumeData, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportVdtkFile(const std::filesystem::path& filePath,
+                                       const VolumeSize& brickSize) const {
+    materialize();
+    return VdtkWriter::write(filePath, m_VolumeData, brickSize, m_numberOfThreads);
 }
 
 bool VolumeDataHandler::exportToBitmapColor(const std::filesystem::path& directoryPath) const {
-    return BitmapExporter::writeColor(directoryPath, m_VolumeData);
+    materialize();
+    return BitmapExporter::writeColor(directoryPath, m_VolumeData, m_numberOfThreads);
 }
 
 bool VolumeDataHandler::exportToBitmapMonochrom(const std::filesystem::path& directoryPath) const {
-    return BitmapExporter::writeMonochrom(directoryPath, m_VolumeData);
+    materialize();
+    return BitmapExporter::writeMonochrom(directoryPath, m_VolumeData, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportToBitmapColor(const std::filesystem::path& directoryPath,
+                                            const std::vector<VolumeAxis>& axes,
+                                            const std::size_t firstSlice,
+                                            const std::size_t lastSlice,
+                                            const std::size_t stride) const {
+    materialize();
+    return BitmapExporter::writeColor(directoryPath, m_VolumeData, axes, firstSlice, lastSlice,
+                                      stride, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportToBitmapMonochrom(const std::filesystem::path& directoryPath,
+                                                const std::vector<VolumeAxis>& axes,
+                                                const std::size_t firstSlice,
+                                                const std::size_t lastSlice,
+                                                const std::size_t stride) const {
+    materialize();
+    return BitmapExporter::writeMonochrom(directoryPath, m_VolumeData, axes, firstSlice,
+                                          lastSlice, stride, m_numberOfThreads);
+}
+
+bool VolumeDataHandler::exportSliceToBitmapColor(const std::filesystem::path& filePath,
+                                                 const VolumeSlice& slice) const {
+    return BitmapExporter::writeSliceColor(filePath, slice);
+}
+
+bool VolumeDataHandler::exportSliceToBitmapMonochrom(const std::filesystem::path& filePath,
+                                                     const VolumeSlice& slice) const {
+    return BitmapExporter::writeSliceMonochrom(filePath, slice);
+}
+
+bool VolumeDataHandler::exportMeshToStl(const std::filesystem::path& filePath,
+                                        const SurfaceMesh& mesh) const {
+    return MeshWriter::writeStl(filePath, mesh);
+}
+
+bool VolumeDataHandler::exportMeshToPly(const std::filesystem::path& filePath,
+                                        const SurfaceMesh& mesh) const {
+    return MeshWriter::writePly(filePath, mesh);
 }
 
 uint16_t VolumeDataHandler::getRawValue(const std::size_t x, const std::size_t y,
                                         const std::size_t z) const {
-    return m_VolumeData.getVoxelValue(x, y, z);
+    std::lock_guard<std::mutex> lock(m_lazyStateMutex);
+    return m_pendingOperations->apply(m_VolumeData.getVoxelValue(x, y, z));
 }
 
 const VolumeData VolumeDataHandler::getVolumeData() const {
+    materialize();
     return m_VolumeData;
 }
 
@@ -81,27 +252,52 @@ const VolumeSpacing VolumeDataHandler::getVolumeSpacing() const {
 void VolumeDataHandler::applyWindow(WindowingFunction func, const int32_t windowCenter,
                                     const int32_t windowWidth,
                                     const int32_t windowOffset) {
-    WindowFilter::applyWindow(&m_VolumeData, func, windowCenter, windowWidth,
-                              windowOffset,
-                              m_numberOfThreads);
+    m_pendingOperations->appendWindow(func, windowCenter, windowWidth, windowOffset);
 }
 
 void VolumeDataHandler::applyGridFilter(const FilterKernel& filter) {
+    prepareVolumeChange();
     GridFilter::applyFilter(&m_VolumeData, filter, m_numberOfThreads);
 }
 
 void VolumeDataHandler::cutBorders(const float thresholdISO) {
     if (thresholdISO >= 0.0f && thresholdISO <= 1.0f) {
-        EdgeCutter::cutBorders(&m_VolumeData, static_cast<uint16_t>(thresholdISO * UINT16_MAX));
+        cutBorders(static_cast<uint16_t>(thresholdISO * UINT16_MAX));
     }
 }
 
 void VolumeDataHandler::cutBorders(const uint16_t thresholdISO) {
-    EdgeCutter::cutBorders(&m_VolumeData, thresholdISO);
+    // the brick map applies the recorded point operations and is only valid before the cut
+    const BrickMinMaxMap* const bricks = getBrickMinMaxMap();
+    materialize();
+    m_statisticsSampler->stopRefinement();
+    EdgeCutter::cutBorders(&m_VolumeData, thresholdISO, m_numberOfThreads, bricks);
+    invalidateDerivedData();
+}
+
+bool VolumeDataHandler::crop(const VolumeSize& offset, const VolumeSize& size) {
+    // point operations can still be applied afterwards to less voxels
+    invalidateDerivedData();
+    return EdgeCutter::crop(&m_VolumeData, offset, size, m_numberOfThreads);
 }
 
 void VolumeDataHandler::invertVoxelData() {
-    InvertVoxelFilter::invertVoxelData(m_VolumeData);
+    m_pendingOperations->appendInvert();
+}
+
+void VolumeDataHandler::permuteAxes(const Axis newX, const Axis newY, const Axis newZ) {
+    prepareVolumeChange();
+    VolumeReorienter::permuteAxes(&m_VolumeData, newX, newY, newZ, m_numberOfThreads);
+}
+
+void VolumeDataHandler::flipAxis(const Axis axis) {
+    prepareVolumeChange();
+    VolumeReorienter::flipAxis(&m_VolumeData, axis, m_numberOfThreads);
+}
+
+void VolumeDataHandler::rotate90(const Axis rotationAxis, const int quarterTurns) {
+    prepareVolumeChange();
+    VolumeReorienter::rotate90(&m_VolumeData, rotationAxis, quarterTurns, m_numberOfThreads);
 }
 
 void VolumeDataHandler::scaleToSize(const ScaleMode scaleMode, const VolumeSize& size) {
@@ -144,18 +340,135 @@ void VolumeDataHandler::scaleWithFactor(const ScaleMode scaleMode, const float f
     scaleVolume(scaleMode, factorX, factorY, factorZ);
 }
 
+bool VolumeDataHandler::applyAffineTransform(const ScaleMode scaleMode,
+                                             const AffineMatrix& transformation) {
+    return resampleToGrid(scaleMode, transformation, m_VolumeData.getSize(),
+                          m_VolumeData.getSpacing());
+}
+
+bool VolumeDataHandler::resampleToGrid(const ScaleMode scaleMode,
+                                       const AffineMatrix& transformation, const VolumeSize& size,
+                                       const VolumeSpacing& spacing,
+                                       const Vector3D<float>& origin) {
+    prepareVolumeChange();
+    return AffineTransformer::resample(&m_VolumeData, transformation, scaleMode, size, spacing,
+                                       origin, m_numberOfThreads);
+}
+
+const VolumeSlice VolumeDataHandler::getProjection(const ProjectionMode mode,
+                                                   const VolumeAxis axis,
+                                                   const std::size_t firstSlice,
+                                                   const std::size_t lastSlice) const {
+    materialize();
+    return IntensityProjector::project(m_VolumeData, mode, axis, firstSlice, lastSlice,
+                                       m_numberOfThreads);
+}
+
+const VolumeSlice VolumeDataHandler::renderVolume(const RenderSettings& settings) const {
+    materialize();
+    const BrickMinMaxMap* bricks = getBrickMinMaxMap();
+    // without the cached brick map a temporary one is built, it is much cheaper than a render
+    BrickMinMaxMap temporaryBricks;
+    if (bricks == nullptr) {
+        temporaryBricks.build(m_VolumeData, 16, m_numberOfThreads);
+        bricks = &temporaryBricks;
+    }
+    return VolumeRenderer::render(m_VolumeData, settings, *bricks, m_numberOfThreads);
+}
+
+const SurfaceMesh VolumeDataHandler::extractIsosurface(const uint16_t isoValue) const {
+    materialize();
+    const BrickMinMaxMap* bricks = getBrickMinMaxMap();
+    // without the cached brick map a temporary one is built to skip cells far from the surface
+    BrickMinMaxMap temporaryBricks;
+    if (bricks == nullptr) {
+        temporaryBricks.build(m_VolumeData, 16, m_numberOfThreads);
+        bricks = &temporaryBricks;
+    }
+    return MarchingCubes::extract(m_VolumeData, isoValue, *bricks, m_numberOfThreads);
+}
+
 const std::vector<uint16_t> VolumeDataHandler::getHistogram() const {
+    materialize();
     return HistogramGenerator::getHistogram(&m_VolumeData);
 }
 
 const std::vector<uint16_t> VolumeDataHandler::getHistogramWidthWindowing(
     WindowingFunction func, int32_t windowCenter, int32_t windowWidth, int32_t windowOffset) const {
+    materialize();
     return HistogramGenerator::getHistogramWidthWindowing(&m_VolumeData, func, windowCenter,
                                                           windowWidth, windowOffset);
 }
 
+const VolumeStatistics& VolumeDataHandler::getStatistics() const {
+    materialize();
+    std::lock_guard<std::mutex> lock(m_lazyStateMutex);
+    if (!m_statisticsValid) {
+        m_statistics =
+            VolumeStatistics(HistogramGenerator::getFullHistogram(m_VolumeData, m_numberOfThreads));
+        m_statisticsValid = true;
+    }
+    return m_statistics;
+}
+
+ApproximateVolumeStatistics VolumeDataHandler::getApproximateStatistics(
+    const std::size_t samplesPerBrick) const {
+    materialize();
+    return StatisticsSampler::sample(m_VolumeData, samplesPerBrick, m_numberOfThreads);
+}
+
+void VolumeDataHandler::startStatisticsRefinement(const std::size_t initialSamplesPerBrick) {
+    materialize();
+    m_statisticsSampler->startRefinement(m_VolumeData, initialSamplesPerBrick, m_numberOfThreads);
+}
+
+ApproximateVolumeStatistics VolumeDataHandler::getRefinedStatistics() const {
+    return m_statisticsSampler->getRefinedStatistics();
+}
+
+bool VolumeDataHandler::labelConnectedComponents(const uint16_t lowerThreshold,
+                                                 const uint16_t upperThreshold,
+                                                 const Connectivity connectivity,
+                                                 ComponentLabels* const components) const {
+    materialize();
+    return ConnectedComponentLabeler::label(m_VolumeData, lowerThreshold, upperThreshold,
+                                            connectivity, components, m_numberOfThreads);
+}
+
+const DistanceMap VolumeDataHandler::getDistanceMap(const uint16_t lowerThreshold,
+                                                    const uint16_t upperThreshold,
+                                                    const bool signedDistance) const {
+    materialize();
+    return DistanceTransform::compute(m_VolumeData, lowerThreshold, upperThreshold, signedDistance,
+                                      m_numberOfThreads);
+}
+
+const VolumeMask VolumeDataHandler::growRegion(const std::vector<VolumeSize>& seeds,
+                                               const uint16_t lowerThreshold,
+                                               const uint16_t upperThreshold) const {
+    materialize();
+    return RegionGrower::grow(m_VolumeData, seeds, lowerThreshold, upperThreshold,
+                              m_numberOfThreads);
+}
+
 void VolumeDataHandler::convertEndianness() {
-    EndianConverter::flipEndianness(&m_VolumeData);
+    m_pendingOperations->appendByteSwap();
+}
+
+void VolumeDataHandler::applyPendingOperations() {
+    materialize();
+}
+
+void VolumeDataHandler::enableBrickMinMax(const std::size_t brickSize) {
+    if (brickSize != m_brickMinMaxSize) {
+        m_brickMinMaxMap->clear();
+    }
+    m_brickMinMaxSize = brickSize;
+}
+
+void VolumeDataHandler::disableBrickMinMax() {
+    m_brickMinMaxSize = 0;
+    m_brickMinMaxMap->clear();
 }
 
 void VolumeDataHandler::printLegalNotice() {
@@ -206,8 +519,49 @@ void VolumeDataHandler::printLegalNotice() {
     std::cout << std::endl;
 }
 
+void VolumeDataHandler::materialize() const {
+    std::lock_guard<std::mutex> lock(m_lazyStateMutex);
+    if (!m_pendingOperations->isEmpty()) {
+        invalidateDerivedData();
+        m_pendingOperations->apply(&m_VolumeData, m_numberOfThreads);
+        m_pendingOperations->clear();
+    }
+}
+
+bool VolumeDataHandler::replaceVolume(const bool imported) {
+    if (imported) {
+        m_pendingOperations->clear();
+    }
+    return imported;
+}
+
+void VolumeDataHandler::prepareVolumeChange() {
+    materialize();
+    invalidateDerivedData();
+}
+
+void VolumeDataHandler::invalidateDerivedData() const {
+    m_statisticsSampler->stopRefinement();
+    m_brickMinMaxMap->clear();
+    m_statisticsValid = false;
+}
+
+const BrickMinMaxMap* VolumeDataHandler::getBrickMinMaxMap() const {
+    if (m_brickMinMaxSize == 0) {
+        return nullptr;
+    }
+
+    materialize();
+    std::lock_guard<std::mutex> lock(m_lazyStateMutex);
+    if (!m_brickMinMaxMap->isValid()) {
+        m_brickMinMaxMap->build(m_VolumeData, m_brickMinMaxSize, m_numberOfThreads);
+    }
+    return m_brickMinMaxMap.get();
+}
+
 void VolumeDataHandler::scaleVolume(const ScaleMode scaleMode, const float factorX,
                                     const float factorY, const float factorZ) {
+    prepareVolumeChange();
     // if spacing is "1, 1, 1" we do not need to scale
     if (factorX != 1.0f || factorY != 1.0f || factorZ != 1.0f) {
         switch (scaleMode) {
@@ -0,0 +1,261 @@
+#include "../include/VDTK/VolumePipeline.h"
+
+#include <future>
+#include <threadpool/ThreadPool.h>
+
+#include "../include/VDTK/common/CommonIO.h"
+// IO
+#include "file_io/AsyncFileWriter.h"
+#include "file_io/VoxelConverter.h"
+#include "file_io/binary_slice/BinarySliceImporter.h"
+#include "file_io/raw/RawReader.h"
+// Filter
+#include "filter/GridFilter.h"
+#include "filter/InvertVoxelsFilter.h"
+#include "filter/WindowFilter.h"
+
+namespace VDTK {
+VolumePipeline::VolumePipeline(const std::size_t numberOfUsableThreads)
+    : m_numberOfThreads((numberOfUsableThreads > 0) ? numberOfUsableThreads : 1) {}
+
+VolumePipeline::~VolumePipeline() {}
+
+void VolumePipeline::setRawFileSource(const std::filesystem::path& filePath,
+                                      const uint8_t bitsPerVoxel, const VolumeSize& size,
+                                      const VolumeSpacing& spacing, const Endianness endianness) {
+    m_sourceType = SourceType::RawFile;
+    m_sourcePath = filePath;
+    m_sourceBitsPerVoxel = bitsPerVoxel;
+    m_size = size;
+    m_spacing = spacing;
+    m_sourceEndianness = endianness;
+}
+
+void VolumePipeline::setBinarySliceSource(const std::filesystem::path& directoryPath,
+                                          const uint8_t bitsPerVoxel, const VolumeSize& size,
+                                          const VolumeSpacing& spacing,
+                                          const Endianness endianness) {
+    m_sourceType = SourceType::BinarySlices;
+    m_sourcePath = directoryPath;
+    m_sourceBitsPerVoxel = bitsPerVoxel;
+    m_size = size;
+    m_spacing = spacing;
+    m_sourceEndianness = endianness;
+}
+
+void VolumePipeline::setRawFileSink(const std::filesystem::path& filePath,
+                                    const uint8_t bitsPerVoxel) {
+    m_sinkPath = filePath;
+    m_sinkBitsPerVoxel = bitsPerVoxel;
+}
+
+void VolumePipeline::addWindow(const WindowingFunction func, const int32_t windowCenter,
+                               const int32_t windowWidth, const int32_t windowOffset) {
+    Operation operation;
+    operation.type = OperationType::Window;
+    operation.func = func;
+    operation.windowCenter = windowCenter;
+    operation.windowWidth = windowWidth;
+    operation.windowOffset = windowOffset;
+    m_operations.push_back(operation);
+}
+
+void VolumePipeline::addGridFilter(const FilterKernel& filter) {
+    Operation operation;
+    operation.type = OperationType::GridFilter;
+    operation.filterIndex = m_filterKernels.size();
+    m_filterKernels.push_back(filter);
+    m_operations.push_back(operation);
+}
+
+void VolumePipeline::addInvert() {
+    Operation operation;
+    operation.type = OperationType::Invert;
+    m_operations.push_back(operation);
+}
+
+void VolumePipeline::clearOperations() {
+    m_operations.clear();
+    m_filterKernels.clear();
+}
+
+void VolumePipeline::setSlabThickness(const std::size_t numberOfSlices) {
+    m_slabThickness = (numberOfSlices > 0) ? numberOfSlices : 1;
+}
+
+bool VolumePipeline::execute() const {
+    if (m_sourceType == SourceType::None || m_sinkPath.empty() ||
+        (m_sinkBitsPerVoxel != 8 && m_sinkBitsPerVoxel != 12 && m_sinkBitsPerVoxel != 16)) {
+        // incomplete pipeline or unsupported voxel format
+        return false;
+    }
+
+    const std::size_t sliceVoxelCount = m_size.getX() * m_size.getY();
+    const std::size_t numberOfSlices = m_size.getZ();
+    if (sliceVoxelCount == 0 || numberOfSlices == 0) {
+        return false;
+    }
+
+    std::vector<std::filesystem::path> slicePaths;
+    if (m_sourceType == SourceType::BinarySlices) {
+        if (!std::filesystem::exists(m_sourcePath) ||
+            (m_sourceBitsPerVoxel != 8 && m_sourceBitsPerVoxel != 16)) {
+            return false;
+        }
+
+        slicePaths = FileIOCommon::getSortedFilesInDirectory(m_sourcePath);
+        if (slicePaths.size() > numberOfSlices) {
+            // more slice files than slices in the volume
+            return false;
+        }
+    }
+
+    // packed 12 bit slabs have to end at a whole byte
+    std::size_t slabThickness = m_slabThickness;
+    if (m_sinkBitsPerVoxel == 12 && sliceVoxelCount % 2 != 0 && slabThickness % 2 != 0) {
+        slabThickness++;
+    }
+
+    const std::size_t halo = getHalo();
+    const std::size_t numberOfSlabs = (numberOfSlices + slabThickness - 1) / slabThickness;
+    const auto getFirstInputSlice = [&](const std::size_t slabIndex) {
+        return (slabIndex * slabThickness > halo) ? slabIndex * slabThickness - halo : 0;
+    };
+    const auto getLastInputSlice = [&](const std::size_t slabIndex) {
+        return std::min((slabIndex + 1) * slabThickness + halo, numberOfSlices);
+    };
+
+    AsyncFileWriter file(
+        VoxelConverter::getByteCount(sliceVoxelCount * slabThickness, m_sinkBitsPerVoxel));
+    if (!file.open(m_sinkPath)) {
+        // unable to create file
+        return false;
+    }
+
+    VolumeData nextSlab(VolumeSize(0), m_spacing);
+    const auto readNextSlab = [&](const std::size_t slabIndex) {
+        return std::async(std::launch::async, [&, slabIndex]() {
+            return readSlab(slicePaths, getFirstInputSlice(slabIndex),
+                            getLastInputSlice(slabIndex), &nextSlab);
+        });
+    };
+
+    ThreadPool threadPool(m_numberOfThreads);
+    std::vector<std::future<void>> results;
+    std::future<bool> nextSlabRead = readNextSlab(0);
+    bool success = true;
+
+    for (std::size_t slabIndex = 0; slabIndex < numberOfSlabs; slabIndex++) {
+        if (!nextSlabRead.get()) {
+            // unable to read source
+            success = false;
+            break;
+        }
+
+        // the next slab gets read while the current one is processed
+        VolumeData slab = std::move(nextSlab);
+        if (slabIndex + 1 < numberOfSlabs) {
+            nextSlabRead = readNextSlab(slabIndex + 1);
+        }
+
+        applyOperations(&slab);
+
+        // only the inner slices of the slab are written, the halos belong to the neighbours
+        const std::size_t firstSlice = slabIndex * slabThickness;
+        const std::size_t voxelCount =
+            (std::min(firstSlice + slabThickness, numberOfSlices) - firstSlice) * sliceVoxelCount;
+        const uint16_t* const source = slab.getRawVolumeData().data() +
+                                       (firstSlice - getFirstInputSlice(slabIndex)) *
+                                           sliceVoxelCount;
+        char* const buffer = file.acquireBuffer();
+
+        // split the slab into even parts for all threads, so packed 12 bit parts start at a
+        // whole byte
+        const std::size_t partVoxelCount =
+            ((voxelCount + m_numberOfThreads - 1) / m_numberOfThreads + 1) & ~std::size_t(1);
+        results.clear();
+        for (std::size_t part = 0; part < voxelCount; part += partVoxelCount) {
+            const std::size_t count = std::min(partVoxelCount, voxelCount - part);
+            char* const destination =
+                buffer + VoxelConverter::getByteCount(part, m_sinkBitsPerVoxel);
+            results.push_back(threadPool.enqueue([this, source, destination, part, count]() {
+                VoxelConverter::convertFrom16Bit(source + part, m_sinkBitsPerVoxel,
+                                                 Endianness::Little, destination, count);
+            }));
+        }
+        for (std::future<void>& result : results) {
+            result.wait();
+        }
+
+        file.submitBuffer(VoxelConverter::getByteCount(voxelCount, m_sinkBitsPerVoxel));
+    }
+
+    if (nextSlabRead.valid()) {
+        nextSlabRead.wait();
+    }
+    return file.close() && success;
+}
+
+std::size_t VolumePipeline::getHalo() const {
+    std::size_t halo = 0;
+    for (const Operation& operation : m_operations) {
+        if (operation.type == OperationType::GridFilter) {
+            // wrong values at the slab borders move inwards by the kernel radius with every
+            // filter
+            halo += m_filterKernels[operation.filterIndex].getKernelSize() / 2;
+        }
+    }
+    return halo;
+}
+
+bool VolumePipeline::readSlab(const std::vector<std::filesystem::path>& slicePaths,
+                              const std::size_t firstSlice, const std::size_t lastSlice,
+                              VolumeData* const slab) const {
+    const VolumeSize slabSize(m_size.getX(), m_size.getY(), lastSlice - firstSlice);
+
+    switch (m_sourceType) {
+    case SourceType::RawFile: {
+        return RawReader::readRegion(slab, m_sourcePath, m_sourceBitsPerVoxel, m_size, m_spacing,
+                                     VolumeSize(0, 0, firstSlice), slabSize, VolumeSize(1),
+                                     m_sourceEndianness, m_numberOfThreads);
+    }
+    case SourceType::BinarySlices: {
+        // slices without a file stay empty
+        VolumeData volume(slabSize, m_spacing);
+        for (std::size_t z = firstSlice; z < std::min(lastSlice, slicePaths.size()); z++) {
+            if (!BinarySliceImporter::importSlice(&volume, slicePaths[z], m_sourceBitsPerVoxel,
+                                                  m_sourceEndianness, VolumeAxis::XYAxis,
+                                                  z - firstSlice)) {
+                return false;
+            }
+        }
+        *slab = std::move(volume);
+        return true;
+    }
+    default: { return false; }
+    }
+}
+
+void VolumePipeline::applyOperations(VolumeData* const slab) const {
+    for (const Operation& operation : m_operations) {
+        switch (operation.type) {
+        case OperationType::Window: {
+            WindowFilter::applyWindow(slab, operation.func, operation.windowCenter,
+                                      operation.windowWidth, operation.windowOffset,
+                                      m_numberOfThreads);
+            break;
+        }
+        case OperationType::GridFilter: {
+            GridFilter::applyFilter(slab, m_filterKernels[operation.filterIndex],
+                                    m_numberOfThreads);
+            break;
+        }
+        case OperationType::Invert: {
+            InvertVoxelFilter::invertVoxelData(*slab);
+            break;
+        }
+        default: { break; }
+        }
+    }
+}
+} // namespace VDTK
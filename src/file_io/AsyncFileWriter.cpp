@@ -0,0 +1,173 @@
+
+#include <cerrno>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "AsyncFileWriter.h"
+
+namespace {
+void* allocateAligned(const std::size_t size, const std::size_t alignment) {
+#if defined(__unix__) || defined(__APPLE__)
+    void* data = nullptr;
+    return (posix_memalign(&data, alignment, size) == 0) ? data : nullptr;
+#else
+    (void)alignment;
+    return std::malloc(size);
+#endif
+}
+} // namespace
+
+namespace VDTK {
+AsyncFileWriter::AsyncFileWriter(const std::size_t bufferSize, const bool directIO)
+    : m_bufferSize(bufferSize), m_directIO(directIO) {
+    for (Buffer& buffer : m_buffers) {
+        buffer.data = std::unique_ptr<char, void (*)(void*)>(
+            static_cast<char*>(allocateAligned(m_bufferSize, m_alignment)), std::free);
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const std::filesystem::path& filePath) {
+    if (!m_buffers[0].data || !m_buffers[1].data || m_thread.joinable()) {
+        return false;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#if defined(O_DIRECT)
+    if (m_directIO && m_bufferSize % m_alignment == 0) {
+        // not every file system supports direct I/O
+        m_fileDescriptor = ::open(filePath.c_str(), flags | O_DIRECT, 0644);
+        m_directIOActive = m_fileDescriptor >= 0;
+    }
+#endif
+    if (m_fileDescriptor < 0) {
+        m_fileDescriptor = ::open(filePath.c_str(), flags, 0644);
+    }
+    if (m_fileDescriptor < 0) {
+        // unable to create file
+        return false;
+    }
+#else
+    m_file.open(filePath, std::ios::out | std::ios::binary);
+    if (m_file.fail()) {
+        // unable to create file
+        return false;
+    }
+#endif
+
+    m_closing = false;
+    m_success = true;
+    m_nextBuffer = 0;
+    m_thread = std::thread(&AsyncFileWriter::writeBuffers, this);
+    return true;
+}
+
+char* AsyncFileWriter::acquireBuffer() {
+    Buffer& buffer = m_buffers[m_nextBuffer];
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [&buffer]() { return !buffer.filled; });
+    return buffer.data.get();
+}
+
+void AsyncFileWriter::submitBuffer(const std::size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers[m_nextBuffer].size = size;
+        m_buffers[m_nextBuffer].filled = true;
+    }
+    m_condition.notify_all();
+    m_nextBuffer = 1 - m_nextBuffer;
+}
+
+bool AsyncFileWriter::close() {
+    if (!m_thread.joinable()) {
+        return m_success;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+#if defined(__unix__) || defined(__APPLE__)
+    if (::close(m_fileDescriptor) != 0) {
+        m_success = false;
+    }
+    m_fileDescriptor = -1;
+    m_directIOActive = false;
+#else
+    m_file.close();
+    if (m_file.fail()) {
+        m_success = false;
+    }
+#endif
+    return m_success;
+}
+
+void AsyncFileWriter::writeBuffers() {
+    // buffers are written in the order they got submitted
+    std::size_t current = 0;
+    while (true) {
+        Buffer& buffer = m_buffers[current];
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [&]() { return buffer.filled || m_closing; });
+            if (!buffer.filled) {
+                // closing and nothing left to write
+                return;
+            }
+        }
+
+        // after a failed write the remaining buffers are only released
+        const bool success = m_success && writeData(buffer.data.get(), buffer.size);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_success = success;
+            buffer.filled = false;
+        }
+        m_condition.notify_all();
+        current = 1 - current;
+    }
+}
+
+bool AsyncFileWriter::writeData(const char* const data, const std::size_t size) {
+#if defined(__unix__) || defined(__APPLE__)
+#if defined(O_DIRECT)
+    if (m_directIOActive && size % m_alignment != 0) {
+        // the last, partly filled buffer can not be written with direct I/O
+        const int flags = fcntl(m_fileDescriptor, F_GETFL);
+        if (flags < 0 || fcntl(m_fileDescriptor, F_SETFL, flags & ~O_DIRECT) != 0) {
+            return false;
+        }
+        m_directIOActive = false;
+    }
+#endif
+    std::size_t bytesWritten = 0;
+    while (bytesWritten < size) {
+        const ssize_t result = ::write(m_fileDescriptor, data + bytesWritten, size - bytesWritten);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0) {
+            // unable to write file
+            return false;
+        }
+        bytesWritten += static_cast<std::size_t>(result);
+    }
+    return true;
+#else
+    return static_cast<bool>(m_file.write(data, size));
+#endif
+}
+} // namespace VDTK
@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Writes a file from two buffers on a background thread. While one buffer gets written, the
+// caller fills the other one, so producing the data overlaps with the disk I/O.
+// With direct I/O (Linux only) the page cache is bypassed, the buffers are aligned and all
+// buffers except the last one have to be filled completely
+class AsyncFileWriter {
+public:
+    // bufferSize has to be a multiple of m_alignment for direct I/O
+    AsyncFileWriter(const std::size_t bufferSize, const bool directIO = false);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    bool open(const std::filesystem::path& filePath);
+    // returns the buffer to fill next, waits until its previous content is written
+    char* acquireBuffer();
+    // queues the first size bytes of the acquired buffer for writing
+    void submitBuffer(const std::size_t size);
+    // waits for all queued buffers, returns false if any write failed
+    bool close();
+
+    static constexpr std::size_t m_alignment = 4096;
+
+private:
+    struct Buffer {
+        std::unique_ptr<char, void (*)(void*)> data = {nullptr, nullptr};
+        std::size_t size = 0;
+        bool filled = false;
+    };
+
+    void writeBuffers();
+    bool writeData(const char* const data, const std::size_t size);
+
+    const std::size_t m_bufferSize;
+    const bool m_directIO;
+    Buffer m_buffers[2];
+    std::size_t m_nextBuffer = 0;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_closing = false;
+    bool m_success = true;
+
+#if defined(__unix__) || defined(__APPLE__)
+    int m_fileDescriptor = -1;
+    bool m_directIOActive = false;
+#else
+    std::ofstream m_file;
+#endif
+};
+} // namespace VDTK
@@ -0,0 +1,84 @@
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace VDTK {
+MappedFile::MappedFile() {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::filesystem::path& filePath) {
+    close();
+
+    std::size_t fileSize = 0;
+    try {
+        fileSize = std::filesystem::file_size(filePath);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    if (fileSize == 0) {
+        // nothing to map
+        return true;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    const int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        // unable to open file
+        return false;
+    }
+
+    // the mapping stays valid after the file descriptor is closed
+    void* const data = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    ::close(fileDescriptor);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    // the whole file gets converted, start reading ahead right away
+    madvise(data, fileSize, MADV_WILLNEED);
+    m_data = static_cast<const char*>(data);
+#else
+    std::ifstream file(filePath, std::ios::binary);
+    m_buffer.resize(fileSize);
+    if (!file.is_open() || !file.read(m_buffer.data(), fileSize)) {
+        // unable to read file
+        m_buffer.clear();
+        return false;
+    }
+    m_data = m_buffer.data();
+#endif
+
+    m_size = fileSize;
+    return true;
+}
+
+void MappedFile::close() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#else
+    m_buffer.clear();
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const char* MappedFile::getData() const {
+    return m_data;
+}
+
+std::size_t MappedFile::getSize() const {
+    return m_size;
+}
+} // namespace VDTK
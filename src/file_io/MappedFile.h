@@ -0,0 +1,29 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Read only view of a whole file. On POSIX systems the file gets mapped into memory, so the data
+// is read by the page cache on first access without a copy. Other systems read the file into a
+// buffer
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::filesystem::path& filePath);
+    void close();
+
+    const char* getData() const;
+    std::size_t getSize() const;
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::vector<char> m_buffer;
+#endif
+};
+} // namespace VDTK
@@ -0,0 +1,63 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// describes where the pixels of one slice are stored inside of the volume data
+// pixel (column, row) of the slice is stored at offset + column * columnStride + row * rowStride
+struct SliceLayout {
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t offset = 0;
+    std::size_t columnStride = 0;
+    std::size_t rowStride = 0;
+};
+
+inline std::size_t getNumberOfSlices(const VolumeSize& size, const VolumeAxis axis) {
+    switch (axis) {
+    case VolumeAxis::YZAxis: {
+        return size.getX();
+    }
+    case VolumeAxis::XZAxis: {
+        return size.getY();
+    }
+    case VolumeAxis::XYAxis: {
+        return size.getZ();
+    }
+    default: { return 0; }
+    }
+}
+
+// slice width and height are the same as for VolumeData::getSlice
+inline SliceLayout getSliceLayout(const VolumeSize& size, const VolumeAxis axis,
+                                  const std::size_t sliceIndex) {
+    SliceLayout layout;
+    switch (axis) {
+    case VolumeAxis::YZAxis: {
+        layout.width = size.getY();
+        layout.height = size.getZ();
+        layout.offset = sliceIndex;
+        layout.columnStride = size.getX();
+        layout.rowStride = size.getX() * size.getY();
+        break;
+    }
+    case VolumeAxis::XZAxis: {
+        layout.width = size.getX();
+        layout.height = size.getZ();
+        layout.offset = sliceIndex * size.getX();
+        layout.columnStride = 1;
+        layout.rowStride = size.getX() * size.getY();
+        break;
+    }
+    case VolumeAxis::XYAxis: {
+        layout.width = size.getX();
+        layout.height = size.getY();
+        layout.offset = sliceIndex * size.getX() * size.getY();
+        layout.columnStride = 1;
+        layout.rowStride = size.getX();
+        break;
+    }
+    default: { break; }
+    }
+    return layout;
+}
+} // namespace VDTK
@@ -0,0 +1,374 @@
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef VDTK_IO_URING
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "UringFileReader.h"
+
+namespace {
+// registered buffers are pinned in memory, limit them per ring
+constexpr std::size_t maxBufferMemory = 32 * 1024 * 1024;
+constexpr std::size_t maxBatchSize = 32;
+// every file is read with a chain of three operations
+constexpr std::size_t operationsPerFile = 3;
+enum Operation { Open = 0, Read = 1, Close = 2 };
+} // namespace
+
+namespace VDTK {
+#ifdef VDTK_IO_URING
+namespace {
+int ioUringSetup(const unsigned entries, io_uring_params* const params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(const int ringFd, const unsigned toSubmit, const unsigned minComplete,
+                 const unsigned flags) {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(const int ringFd, const unsigned opcode, const void* const arg,
+                    const unsigned numberOfArgs) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, numberOfArgs));
+}
+} // namespace
+
+struct UringFileReader::Ring {
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // maps the submission and completion queues shared with the kernel
+    bool create(const unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = ioUringSetup(entries, &params);
+        if (fd < 0) {
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            return false;
+        }
+        cqRing = singleMmap ? sqRing
+                            : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                    IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* const sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries = params.sq_entries;
+
+        char* const cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        localSqTail = *sqTail;
+        return true;
+    }
+
+    // opening into registered file slots needs at least Linux 5.15
+    bool supportsOperations() const {
+        constexpr unsigned numberOfOps = 256;
+        std::vector<char> probeMemory(sizeof(io_uring_probe) +
+                                      numberOfOps * sizeof(io_uring_probe_op));
+        io_uring_probe* const probe = reinterpret_cast<io_uring_probe*>(probeMemory.data());
+        if (ioUringRegister(fd, IORING_REGISTER_PROBE, probe, numberOfOps) < 0) {
+            return false;
+        }
+        for (const unsigned operation : {static_cast<unsigned>(IORING_OP_OPENAT),
+                                         static_cast<unsigned>(IORING_OP_READ_FIXED),
+                                         static_cast<unsigned>(IORING_OP_CLOSE)}) {
+            if (operation > probe->last_op ||
+                (probe->ops[operation].flags & IO_URING_OP_SUPPORTED) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    io_uring_sqe* getSqe() {
+        const unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (localSqTail - head >= sqEntries) {
+            // submission queue is full
+            return nullptr;
+        }
+        const unsigned index = localSqTail & sqMask;
+        sqArray[index] = index;
+        localSqTail++;
+
+        io_uring_sqe* const sqe = static_cast<io_uring_sqe*>(sqes) + index;
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        return sqe;
+    }
+
+    // submitted is the number of operations the kernel consumed, only these get completions
+    bool submit(unsigned* const submitted) {
+        const unsigned toSubmit = localSqTail - *sqTail;
+        __atomic_store_n(sqTail, localSqTail, __ATOMIC_RELEASE);
+        *submitted = 0;
+        while (*submitted < toSubmit) {
+            const int result = ioUringEnter(fd, toSubmit - *submitted, 0, 0);
+            if (result == 0 ||
+                (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)) {
+                return false;
+            }
+            *submitted += (result > 0) ? static_cast<unsigned>(result) : 0;
+        }
+        return true;
+    }
+
+    bool waitForCompletion() {
+        const int result = ioUringEnter(fd, 0, 1, IORING_ENTER_GETEVENTS);
+        return result >= 0 || errno == EINTR;
+    }
+
+    int fd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    void* sqes = MAP_FAILED;
+    std::size_t sqRingSize = 0;
+    std::size_t cqRingSize = 0;
+    std::size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned localSqTail = 0;
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+};
+
+UringFileReader::UringFileReader(const std::size_t maxFileSize)
+    : m_bufferSize(std::max<std::size_t>(maxFileSize, 1)) {
+    m_batchSize = std::clamp<std::size_t>(maxBufferMemory / (2 * m_bufferSize), 1, maxBatchSize);
+    const std::size_t numberOfSlots = 2 * m_batchSize;
+
+    m_ring = std::make_unique<Ring>();
+    if (!m_ring->create(static_cast<unsigned>(numberOfSlots * operationsPerFile)) ||
+        !m_ring->supportsOperations()) {
+        m_ring.reset();
+        return;
+    }
+
+    // the kernel pins the buffers once instead of mapping them for every read
+    m_buffers.resize(numberOfSlots * m_bufferSize);
+    std::vector<iovec> bufferVectors(numberOfSlots);
+    for (std::size_t slot = 0; slot < numberOfSlots; slot++) {
+        bufferVectors[slot].iov_base = m_buffers.data() + slot * m_bufferSize;
+        bufferVectors[slot].iov_len = m_bufferSize;
+    }
+    // empty file slots, the open operations place their descriptors directly into them
+    const std::vector<int> fileSlots(numberOfSlots, -1);
+    if (ioUringRegister(m_ring->fd, IORING_REGISTER_BUFFERS, bufferVectors.data(),
+                        static_cast<unsigned>(numberOfSlots)) < 0 ||
+        ioUringRegister(m_ring->fd, IORING_REGISTER_FILES, fileSlots.data(),
+                        static_cast<unsigned>(numberOfSlots)) < 0) {
+        m_ring.reset();
+        m_buffers = std::vector<char>();
+        return;
+    }
+
+    m_slotPaths.resize(numberOfSlots);
+    m_slotResults.resize(numberOfSlots);
+}
+
+void UringFileReader::submitBatch(const std::vector<std::filesystem::path>& filePaths,
+                                  const std::size_t batch, const std::size_t firstFile,
+                                  const std::size_t numberOfFiles) {
+    for (std::size_t file = 0; file < numberOfFiles; file++) {
+        const std::size_t slot = batch * m_batchSize + file;
+        // the path has to stay valid until the open operation is completed
+        m_slotPaths[slot] = filePaths[firstFile + file].string();
+        m_slotResults[slot] = -ECANCELED;
+
+        // the queue is sized for two full batches, so there is always room
+        io_uring_sqe* const open = m_ring->getSqe();
+        open->opcode = IORING_OP_OPENAT;
+        open->fd = AT_FDCWD;
+        open->addr = reinterpret_cast<uint64_t>(m_slotPaths[slot].c_str());
+        open->open_flags = O_RDONLY;
+        open->file_index = static_cast<uint32_t>(slot + 1);
+        // read only if the file got opened
+        open->flags = IOSQE_IO_LINK;
+        open->user_data = slot * operationsPerFile + Operation::Open;
+
+        io_uring_sqe* const read = m_ring->getSqe();
+        read->opcode = IORING_OP_READ_FIXED;
+        read->fd = static_cast<int32_t>(slot);
+        read->addr = reinterpret_cast<uint64_t>(m_buffers.data() + slot * m_bufferSize);
+        read->len = static_cast<uint32_t>(m_bufferSize);
+        read->off = 0;
+        read->buf_index = static_cast<uint16_t>(slot);
+        // a short read breaks a normal link, but the file must be closed anyway
+        read->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        read->user_data = slot * operationsPerFile + Operation::Read;
+
+        io_uring_sqe* const close = m_ring->getSqe();
+        close->opcode = IORING_OP_CLOSE;
+        close->file_index = static_cast<uint32_t>(slot + 1);
+        close->user_data = slot * operationsPerFile + Operation::Close;
+    }
+}
+
+bool UringFileReader::submitQueued(const std::size_t batch) {
+    unsigned submitted = 0;
+    const bool success = m_ring->submit(&submitted);
+    m_pendingCompletions[batch] += submitted;
+    return success;
+}
+
+bool UringFileReader::waitForBatch(const std::size_t batch) {
+    while (m_pendingCompletions[batch] > 0) {
+        unsigned head = *m_ring->cqHead;
+        const unsigned tail = __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            if (!m_ring->waitForCompletion()) {
+                return false;
+            }
+            continue;
+        }
+
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = m_ring->cqes[head & m_ring->cqMask];
+            const std::size_t slot = cqe.user_data / operationsPerFile;
+            const std::size_t operation = cqe.user_data % operationsPerFile;
+            if (operation == Operation::Read || (operation == Operation::Open && cqe.res < 0)) {
+                m_slotResults[slot] = cqe.res;
+            }
+            m_pendingCompletions[slot / m_batchSize]--;
+        }
+        __atomic_store_n(m_ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+bool UringFileReader::readFiles(const std::vector<std::filesystem::path>& filePaths,
+                                const std::size_t firstFile, const std::size_t lastFile,
+                                const FileConsumer& consumer) {
+    if (!isValid()) {
+        return false;
+    }
+
+    bool success = true;
+    // false if the ring itself failed, not a file
+    bool ringValid = true;
+    std::size_t batchFirstFile = firstFile;
+    std::size_t batch = 0;
+
+    std::size_t numberOfFiles = std::min(m_batchSize, lastFile - batchFirstFile);
+    submitBatch(filePaths, batch, batchFirstFile, numberOfFiles);
+    ringValid = submitQueued(batch);
+    success = ringValid;
+
+    while (success && numberOfFiles > 0) {
+        // the next batch gets read by the kernel while the current one is processed
+        const std::size_t nextFirstFile = batchFirstFile + numberOfFiles;
+        const std::size_t nextNumberOfFiles = std::min(m_batchSize, lastFile - nextFirstFile);
+        if (nextNumberOfFiles > 0) {
+            submitBatch(filePaths, 1 - batch, nextFirstFile, nextNumberOfFiles);
+            ringValid = submitQueued(1 - batch);
+            success = ringValid;
+        }
+
+        if (success) {
+            ringValid = waitForBatch(batch);
+            success = ringValid;
+        }
+        for (std::size_t file = 0; success && file < numberOfFiles; file++) {
+            const std::size_t slot = batch * m_batchSize + file;
+            success = m_slotResults[slot] >= 0 &&
+                      consumer(batchFirstFile + file, m_buffers.data() + slot * m_bufferSize,
+                               static_cast<std::size_t>(m_slotResults[slot]));
+        }
+
+        batch = 1 - batch;
+        batchFirstFile = nextFirstFile;
+        numberOfFiles = nextNumberOfFiles;
+    }
+
+    // buffers and paths of operations still in flight must stay valid, operations the kernel did
+    // not consume are dropped with the ring
+    if (!waitForBatch(0) || !waitForBatch(1) || !ringValid) {
+        // the ring is in an unknown state, the caller has to read the files itself
+        m_ring.reset();
+        m_pendingCompletions[0] = 0;
+        m_pendingCompletions[1] = 0;
+        return false;
+    }
+    return success;
+}
+#else
+struct UringFileReader::Ring {};
+
+UringFileReader::UringFileReader(const std::size_t maxFileSize) : m_bufferSize(maxFileSize) {}
+
+void UringFileReader::submitBatch(const std::vector<std::filesystem::path>&, const std::size_t,
+                                  const std::size_t, const std::size_t) {}
+
+bool UringFileReader::submitQueued(const std::size_t) {
+    return false;
+}
+
+bool UringFileReader::waitForBatch(const std::size_t) {
+    return false;
+}
+
+bool UringFileReader::readFiles(const std::vector<std::filesystem::path>&, const std::size_t,
+                                const std::size_t, const FileConsumer&) {
+    return false;
+}
+#endif
+
+UringFileReader::~UringFileReader() {}
+
+bool UringFileReader::isValid() const {
+    return m_ring != nullptr;
+}
+} // namespace VDTK
@@ -0,0 +1,54 @@
+#pragma once
+#include <functional>
+#include <memory>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Reads many small files with io_uring (Linux only). Open, read and close of a file are submitted
+// as one linked chain, a whole batch of files is submitted with a single system call and read
+// into registered buffers. While one batch gets processed the next one is already in flight.
+// If io_uring is not available (not compiled in, old kernel, blocked by seccomp or locked memory
+// limit too low) the reader is invalid and the caller has to read the files itself
+class UringFileReader {
+public:
+    // files larger than maxFileSize get truncated to maxFileSize bytes
+    UringFileReader(const std::size_t maxFileSize);
+    ~UringFileReader();
+
+    UringFileReader(const UringFileReader&) = delete;
+    UringFileReader& operator=(const UringFileReader&) = delete;
+
+    // called for every file in order with the content of the file
+    typedef std::function<bool(const std::size_t fileIndex, const char* const data,
+                               const std::size_t size)>
+        FileConsumer;
+
+    bool isValid() const;
+
+    // reads the files [firstFile, lastFile) of filePaths, fails if a file can not be read or the
+    // consumer fails. If io_uring itself fails, the reader becomes invalid and the caller has to
+    // read the files itself
+    bool readFiles(const std::vector<std::filesystem::path>& filePaths, const std::size_t firstFile,
+                   const std::size_t lastFile, const FileConsumer& consumer);
+
+private:
+    struct Ring;
+
+    void submitBatch(const std::vector<std::filesystem::path>& filePaths,
+                     const std::size_t batch, const std::size_t firstFile,
+                     const std::size_t numberOfFiles);
+    // submits the queued operations of a batch, false if the kernel did not take all of them
+    bool submitQueued(const std::size_t batch);
+    bool waitForBatch(const std::size_t batch);
+
+    std::unique_ptr<Ring> m_ring;
+    std::size_t m_bufferSize = 0;
+    std::size_t m_batchSize = 0;
+    // two batches with m_batchSize slots each, every slot owns a file descriptor and a buffer
+    std::vector<char> m_buffers;
+    std::vector<std::string> m_slotPaths;
+    std::vector<int> m_slotResults;
+    std::size_t m_pendingCompletions[2] = {0, 0};
+};
+} // namespace VDTK
@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "VoxelConverter.h"
+
+namespace {
+inline uint16_t swap16(const uint16_t value) {
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+// 8 bit to 16 bit is the same as multiplying with UINT8_MAX
+inline uint16_t expand8(const uint8_t value) {
+    return static_cast<uint16_t>(value) * UINT8_MAX;
+}
+
+// 12 bit to 16 bit repeats the highest bits, so 0xFFF becomes 0xFFFF
+inline uint16_t expand12(const uint16_t value) {
+    return static_cast<uint16_t>((value << 4) | (value >> 8));
+}
+
+inline uint16_t load16(const char* const source) {
+    // the source is not necessarily aligned for uint16_t
+    uint16_t value;
+    std::memcpy(&value, source, sizeof(uint16_t));
+    return value;
+}
+
+inline void store16(char* const destination, const uint16_t value) {
+    std::memcpy(destination, &value, sizeof(uint16_t));
+}
+
+inline float loadFloat(const char* const source, const bool swap) {
+    uint32_t bits;
+    std::memcpy(&bits, source, sizeof(uint32_t));
+    if (swap) {
+        bits = (bits << 24) | ((bits << 8) & 0xFF0000) | ((bits >> 8) & 0xFF00) | (bits >> 24);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+inline void storeFloat(char* const destination, const float value, const bool swap) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    if (swap) {
+        bits = (bits << 24) | ((bits << 8) & 0xFF0000) | ((bits >> 8) & 0xFF00) | (bits >> 24);
+    }
+    std::memcpy(destination, &bits, sizeof(uint32_t));
+}
+
+// NaN is mapped to the lower bound, the same as the vectorized versions do
+inline float clampToRange(const float value, const float lowerBound, const float upperBound) {
+    if (!(value >= lowerBound)) {
+        return lowerBound;
+    }
+    return (value > upperBound) ? upperBound : value;
+}
+
+// rounds to nearest even like the vectorized conversions
+inline int32_t roundToInt(const float value) {
+    return static_cast<int32_t>(std::nearbyint(value));
+}
+
+constexpr float signedOffset = 32768.0f;
+
+#if defined(__SSE2__)
+inline __m128i swap16x8(const __m128i voxels) {
+    return _mm_or_si128(_mm_slli_epi16(voxels, 8), _mm_srli_epi16(voxels, 8));
+}
+
+inline __m128i swap32x4(const __m128i values) {
+    // swap the bytes of each half, then the halves
+    const __m128i halves = swap16x8(values);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves, _MM_SHUFFLE(2, 3, 0, 1)),
+                               _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// rounds eight floats in [-32768, 32767] and stores them with an offset of 32768 as uint16
+inline __m128i packWithOffset(const __m128i low, const __m128i high) {
+    // signed saturation followed by flipping the sign bit is the same as adding 32768
+    return _mm_xor_si128(_mm_packs_epi32(low, high), _mm_set1_epi16(INT16_MIN));
+}
+#endif
+} // namespace
+
+namespace VDTK {
+VoxelConverter::VoxelConverter() {}
+
+VoxelConverter::~VoxelConverter() {}
+
+bool VoxelConverter::isNativeEndianness(const Endianness endianness) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return endianness == Endianness::Big;
+#else
+    return endianness == Endianness::Little;
+#endif
+}
+
+std::size_t VoxelConverter::getByteCount(const std::size_t voxelCount,
+                                         const uint8_t bitsPerVoxel) {
+    return (voxelCount * bitsPerVoxel + 7) / 8;
+}
+
+void VoxelConverter::convertTo16Bit(const char* const source, const uint8_t bitsPerVoxel,
+                                    const Endianness endianness, uint16_t* const destination,
+                                    const std::size_t voxelCount) {
+    switch (bitsPerVoxel) {
+    case 8: {
+        expand8Bit(reinterpret_cast<const uint8_t*>(source), destination, voxelCount);
+        break;
+    }
+    case 12: {
+        // packed voxels are defined byte by byte, the endianness does not matter
+        unpack12Bit(reinterpret_cast<const uint8_t*>(source), destination, voxelCount);
+        break;
+    }
+    case 16: {
+        if (isNativeEndianness(endianness)) {
+            std::memcpy(destination, source, voxelCount * sizeof(uint16_t));
+        } else {
+            copySwapped16Bit(source, destination, voxelCount);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void VoxelConverter::convertTo16Bit(const char* const source, const uint8_t bitsPerVoxel,
+                                    const Endianness endianness, uint16_t* const destination,
+                                    const std::size_t voxelCount,
+                                    const std::size_t destinationStride) {
+    if (destinationStride == 1) {
+        convertTo16Bit(source, bitsPerVoxel, endianness, destination, voxelCount);
+        return;
+    }
+
+    switch (bitsPerVoxel) {
+    case 8: {
+        const uint8_t* const voxels = reinterpret_cast<const uint8_t*>(source);
+        for (std::size_t index = 0; index < voxelCount; index++) {
+            destination[index * destinationStride] = expand8(voxels[index]);
+        }
+        break;
+    }
+    case 16: {
+        const bool swap = !isNativeEndianness(endianness);
+        for (std::size_t index = 0; index < voxelCount; index++) {
+            const uint16_t value = load16(source + index * sizeof(uint16_t));
+            destination[index * destinationStride] = swap ? swap16(value) : value;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void VoxelConverter::convertSigned16BitTo16Bit(const char* const source,
+                                               const Endianness endianness, const float slope,
+                                               const float intercept, uint16_t* const destination,
+                                               const std::size_t voxelCount) {
+    const bool swap = !isNativeEndianness(endianness);
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128 slopes = _mm_set1_ps(slope);
+    const __m128 intercepts = _mm_set1_ps(intercept);
+    const __m128 lowerBounds = _mm_set1_ps(INT16_MIN);
+    const __m128 upperBounds = _mm_set1_ps(INT16_MAX);
+    for (; index + 8 <= voxelCount; index += 8) {
+        __m128i voxels = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(source + index * sizeof(uint16_t)));
+        if (swap) {
+            voxels = swap16x8(voxels);
+        }
+        // sign extension to 32 bit
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(voxels, voxels), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(voxels, voxels), 16);
+
+        __m128 lowValues = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(low), slopes), intercepts);
+        __m128 highValues = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(high), slopes), intercepts);
+        lowValues = _mm_min_ps(_mm_max_ps(lowValues, lowerBounds), upperBounds);
+        highValues = _mm_min_ps(_mm_max_ps(highValues, lowerBounds), upperBounds);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         packWithOffset(_mm_cvtps_epi32(lowValues), _mm_cvtps_epi32(highValues)));
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        uint16_t bits = load16(source + index * sizeof(uint16_t));
+        if (swap) {
+            bits = swap16(bits);
+        }
+        const float value = static_cast<int16_t>(bits) * slope + intercept;
+        destination[index] =
+            static_cast<uint16_t>(roundToInt(clampToRange(value, INT16_MIN, INT16_MAX)) +
+                                  static_cast<int32_t>(signedOffset));
+    }
+}
+
+void VoxelConverter::convertFloat32To16Bit(const char* const source, const Endianness endianness,
+                                           const float minimum, const float maximum,
+                                           uint16_t* const destination,
+                                           const std::size_t voxelCount) {
+    const bool swap = !isNativeEndianness(endianness);
+    const float scale = (maximum > minimum) ? UINT16_MAX / (maximum - minimum) : 0.0f;
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128 minimums = _mm_set1_ps(minimum);
+    const __m128 scales = _mm_set1_ps(scale);
+    const __m128 lowerBounds = _mm_setzero_ps();
+    const __m128 upperBounds = _mm_set1_ps(UINT16_MAX);
+    const __m128 offsets = _mm_set1_ps(signedOffset);
+    for (; index + 8 <= voxelCount; index += 8) {
+        const char* const values = source + index * sizeof(float);
+        __m128i lowBits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        __m128i highBits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 16));
+        if (swap) {
+            lowBits = swap32x4(lowBits);
+            highBits = swap32x4(highBits);
+        }
+
+        __m128 low = _mm_mul_ps(_mm_sub_ps(_mm_castsi128_ps(lowBits), minimums), scales);
+        __m128 high = _mm_mul_ps(_mm_sub_ps(_mm_castsi128_ps(highBits), minimums), scales);
+        low = _mm_sub_ps(_mm_min_ps(_mm_max_ps(low, lowerBounds), upperBounds), offsets);
+        high = _mm_sub_ps(_mm_min_ps(_mm_max_ps(high, lowerBounds), upperBounds), offsets);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         packWithOffset(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high)));
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        const float value = (loadFloat(source + index * sizeof(float), swap) - minimum) * scale;
+        destination[index] = static_cast<uint16_t>(
+            roundToInt(clampToRange(value, 0.0f, static_cast<float>(UINT16_MAX))));
+    }
+}
+
+void VoxelConverter::findFloat32Range(const char* const source, const Endianness endianness,
+                                      const std::size_t voxelCount, float* const minimum,
+                                      float* const maximum) {
+    const bool swap = !isNativeEndianness(endianness);
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    __m128 minimums = _mm_set1_ps(*minimum);
+    __m128 maximums = _mm_set1_ps(*maximum);
+    const __m128 zero = _mm_setzero_ps();
+    for (; index + 4 <= voxelCount; index += 4) {
+        __m128i bits =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index * sizeof(float)));
+        if (swap) {
+            bits = swap32x4(bits);
+        }
+        const __m128 values = _mm_castsi128_ps(bits);
+        // x - x is 0 only for finite values, infinite and NaN values keep the current range
+        const __m128 finite = _mm_cmpeq_ps(_mm_sub_ps(values, values), zero);
+        minimums = _mm_or_ps(_mm_and_ps(finite, _mm_min_ps(values, minimums)),
+                             _mm_andnot_ps(finite, minimums));
+        maximums = _mm_or_ps(_mm_and_ps(finite, _mm_max_ps(values, maximums)),
+                             _mm_andnot_ps(finite, maximums));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, minimums);
+    *minimum = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+    _mm_store_ps(lanes, maximums);
+    *maximum = std::max({lanes[0], lanes[1], lanes[2], lanes[3]});
+#endif
+    for (; index < voxelCount; index++) {
+        const float value = loadFloat(source + index * sizeof(float), swap);
+        if (std::isfinite(value)) {
+            *minimum = std::min(*minimum, value);
+            *maximum = std::max(*maximum, value);
+        }
+    }
+}
+
+void VoxelConverter::convertFrom16Bit(const uint16_t* const source, const uint8_t bitsPerVoxel,
+                                      const Endianness endianness, char* const destination,
+                                      const std::size_t voxelCount) {
+    switch (bitsPerVoxel) {
+    case 8: {
+        uint8_t* const voxels = reinterpret_cast<uint8_t*>(destination);
+        std::size_t index = 0;
+#if defined(__SSE2__)
+        // v / 255 = (v * 0x8081) >> 23 for all 16 bit values, packing saturates to 255
+        const __m128i reciprocal = _mm_set1_epi16(static_cast<int16_t>(0x8081));
+        for (; index + 16 <= voxelCount; index += 16) {
+            const __m128i low = _mm_srli_epi16(
+                _mm_mulhi_epu16(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index)),
+                    reciprocal),
+                7);
+            const __m128i high = _mm_srli_epi16(
+                _mm_mulhi_epu16(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index + 8)),
+                    reciprocal),
+                7);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(voxels + index),
+                             _mm_packus_epi16(low, high));
+        }
+#endif
+        for (; index < voxelCount; index++) {
+            // values above 65279 would exceed 8 bit
+            voxels[index] = static_cast<uint8_t>(std::min(source[index] / UINT8_MAX, UINT8_MAX));
+        }
+        break;
+    }
+    case 12: {
+        // two voxels are packed into three bytes
+        uint8_t* voxels = reinterpret_cast<uint8_t*>(destination);
+        std::size_t index = 0;
+        // four voxels are the lower 48 bits of a little endian 64 bit word
+        for (; index + 4 <= voxelCount; index += 4) {
+            uint64_t word = static_cast<uint64_t>(source[index] >> 4) |
+                            (static_cast<uint64_t>(source[index + 1] >> 4) << 12) |
+                            (static_cast<uint64_t>(source[index + 2] >> 4) << 24) |
+                            (static_cast<uint64_t>(source[index + 3] >> 4) << 36);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            word = __builtin_bswap64(word);
+#endif
+            std::memcpy(voxels, &word, 6);
+            voxels += 6;
+        }
+        for (; index + 2 <= voxelCount; index += 2) {
+            const uint16_t first = source[index] >> 4;
+            const uint16_t second = source[index + 1] >> 4;
+            voxels[0] = static_cast<uint8_t>(first);
+            voxels[1] = static_cast<uint8_t>((first >> 8) | ((second & 0xF) << 4));
+            voxels[2] = static_cast<uint8_t>(second >> 4);
+            voxels += 3;
+        }
+        if (index < voxelCount) {
+            const uint16_t last = source[index] >> 4;
+            voxels[0] = static_cast<uint8_t>(last);
+            voxels[1] = static_cast<uint8_t>(last >> 8);
+        }
+        break;
+    }
+    case 16: {
+        if (isNativeEndianness(endianness)) {
+            std::memcpy(destination, source, voxelCount * sizeof(uint16_t));
+        } else {
+            for (std::size_t index = 0; index < voxelCount; index++) {
+                store16(destination + index * sizeof(uint16_t), swap16(source[index]));
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void VoxelConverter::convert16BitToSigned16Bit(const uint16_t* const source,
+                                               const Endianness endianness, const float slope,
+                                               const float intercept, char* const destination,
+                                               const std::size_t voxelCount) {
+    const bool swap = !isNativeEndianness(endianness);
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128 offsets = _mm_set1_ps(signedOffset + intercept);
+    const __m128 reciprocalSlopes = _mm_set1_ps(1.0f / slope);
+    const __m128 lowerBounds = _mm_set1_ps(INT16_MIN);
+    const __m128 upperBounds = _mm_set1_ps(INT16_MAX);
+    const __m128i zero = _mm_setzero_si128();
+    for (; index + 8 <= voxelCount; index += 8) {
+        const __m128i voxels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        __m128 low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(voxels, zero));
+        __m128 high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(voxels, zero));
+        low = _mm_mul_ps(_mm_sub_ps(low, offsets), reciprocalSlopes);
+        high = _mm_mul_ps(_mm_sub_ps(high, offsets), reciprocalSlopes);
+        low = _mm_min_ps(_mm_max_ps(low, lowerBounds), upperBounds);
+        high = _mm_min_ps(_mm_max_ps(high, lowerBounds), upperBounds);
+
+        __m128i values = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+        if (swap) {
+            values = swap16x8(values);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index * sizeof(int16_t)),
+                         values);
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        const float value =
+            (static_cast<float>(source[index]) - (signedOffset + intercept)) * (1.0f / slope);
+        uint16_t bits = static_cast<uint16_t>(
+            static_cast<int16_t>(roundToInt(clampToRange(value, INT16_MIN, INT16_MAX))));
+        if (swap) {
+            bits = swap16(bits);
+        }
+        store16(destination + index * sizeof(uint16_t), bits);
+    }
+}
+
+void VoxelConverter::convert16BitToFloat32(const uint16_t* const source,
+                                           const Endianness endianness, const float minimum,
+                                           const float maximum, char* const destination,
+                                           const std::size_t voxelCount) {
+    const bool swap = !isNativeEndianness(endianness);
+    const float scale = (maximum - minimum) / UINT16_MAX;
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128 minimums = _mm_set1_ps(minimum);
+    const __m128 scales = _mm_set1_ps(scale);
+    const __m128i zero = _mm_setzero_si128();
+    for (; index + 8 <= voxelCount; index += 8) {
+        const __m128i voxels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        __m128i low = _mm_castps_si128(_mm_add_ps(
+            minimums, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(voxels, zero)), scales)));
+        __m128i high = _mm_castps_si128(_mm_add_ps(
+            minimums, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(voxels, zero)), scales)));
+        if (swap) {
+            low = swap32x4(low);
+            high = swap32x4(high);
+        }
+        char* const values = destination + index * sizeof(float);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + 16), high);
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        storeFloat(destination + index * sizeof(float), minimum + source[index] * scale, swap);
+    }
+}
+
+void VoxelConverter::swapBytes(uint16_t* const data, const std::size_t voxelCount) {
+    copySwapped16Bit(reinterpret_cast<const char*>(data), data, voxelCount);
+}
+
+void VoxelConverter::expand8Bit(const uint8_t* const source, uint16_t* const destination,
+                                const std::size_t voxelCount) {
+    std::size_t index = 0;
+#if defined(__AVX2__)
+    for (; index + 16 <= voxelCount; index += 16) {
+        const __m256i voxels = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index)));
+        // v * 255 = (v << 8) - v
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + index),
+                            _mm256_sub_epi16(_mm256_slli_epi16(voxels, 8), voxels));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; index + 16 <= voxelCount; index += 16) {
+        const __m128i voxels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        const __m128i low = _mm_unpacklo_epi8(voxels, zero);
+        const __m128i high = _mm_unpackhi_epi8(voxels, zero);
+        // v * 255 = (v << 8) - v
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         _mm_sub_epi16(_mm_slli_epi16(low, 8), low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index + 8),
+                         _mm_sub_epi16(_mm_slli_epi16(high, 8), high));
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        destination[index] = expand8(source[index]);
+    }
+}
+
+void VoxelConverter::unpack12Bit(const uint8_t* const source, uint16_t* const destination,
+                                 const std::size_t voxelCount) {
+    const std::size_t byteCount = getByteCount(voxelCount, 12);
+    std::size_t index = 0;
+#if defined(__SSSE3__)
+    // eight voxels are stored in twelve bytes, every 16 bit lane gets the two bytes its voxel
+    // overlaps with. Even voxels are the lower 12 bits, odd voxels the upper 12 bits of a lane
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+    const __m128i evenLanes = _mm_setr_epi16(-1, 0, -1, 0, -1, 0, -1, 0);
+    const __m128i lowBits = _mm_set1_epi16(0x0FFF);
+    for (; (index * 3) / 2 + 16 <= byteCount && index + 8 <= voxelCount; index += 8) {
+        const __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + (index * 3) / 2));
+        const __m128i lanes = _mm_shuffle_epi8(bytes, shuffle);
+        const __m128i voxels =
+            _mm_or_si128(_mm_and_si128(evenLanes, _mm_and_si128(lanes, lowBits)),
+                         _mm_andnot_si128(evenLanes, _mm_srli_epi16(lanes, 4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         _mm_or_si128(_mm_slli_epi16(voxels, 4), _mm_srli_epi16(voxels, 8)));
+    }
+#endif
+    // four voxels are the lower 48 bits of a little endian 64 bit word
+    for (; (index * 3) / 2 + 8 <= byteCount && index + 4 <= voxelCount; index += 4) {
+        uint64_t word;
+        std::memcpy(&word, source + (index * 3) / 2, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        destination[index] = expand12(static_cast<uint16_t>(word & 0xFFF));
+        destination[index + 1] = expand12(static_cast<uint16_t>((word >> 12) & 0xFFF));
+        destination[index + 2] = expand12(static_cast<uint16_t>((word >> 24) & 0xFFF));
+        destination[index + 3] = expand12(static_cast<uint16_t>((word >> 36) & 0xFFF));
+    }
+    for (; index < voxelCount; index++) {
+        const uint8_t* const bytes = source + (index / 2) * 3;
+        const uint16_t voxel = (index % 2 == 0) ? (bytes[0] | ((bytes[1] & 0xF) << 8))
+                                                : ((bytes[1] >> 4) | (bytes[2] << 4));
+        destination[index] = expand12(voxel);
+    }
+}
+
+void VoxelConverter::copySwapped16Bit(const char* const source, uint16_t* const destination,
+                                      const std::size_t voxelCount) {
+    std::size_t index = 0;
+#if defined(__AVX2__)
+    const __m256i shuffle =
+        _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4,
+                         7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (; index + 16 <= voxelCount; index += 16) {
+        const __m256i voxels = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(source + index * sizeof(uint16_t)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + index),
+                            _mm256_shuffle_epi8(voxels, shuffle));
+    }
+#elif defined(__SSSE3__)
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (; index + 8 <= voxelCount; index += 8) {
+        const __m128i voxels = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(source + index * sizeof(uint16_t)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         _mm_shuffle_epi8(voxels, shuffle));
+    }
+#elif defined(__SSE2__)
+    for (; index + 8 <= voxelCount; index += 8) {
+        const __m128i voxels = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(source + index * sizeof(uint16_t)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         _mm_or_si128(_mm_slli_epi16(voxels, 8), _mm_srli_epi16(voxels, 8)));
+    }
+#endif
+    for (; index < voxelCount; index++) {
+        destination[index] = swap16(load16(source + index * sizeof(uint16_t)));
+    }
+}
+} // namespace VDTK
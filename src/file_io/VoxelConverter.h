@@ -0,0 +1,71 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Converts voxels of files into 16 bit voxels of the native byte order and back. Byte swap and
+// bit depth conversion are done in the same pass, vectorized if the compiler targets SSE2, SSSE3
+// or AVX2.
+//
+// Supported file formats:
+//  8 bit:  upscaled with UINT8_MAX
+//  12 bit: packed, two voxels in three bytes. v0 = b0 | (b1 & 0xF) << 8, v1 = b1 >> 4 | b2 << 4.
+//          Upscaled with (v << 4) | (v >> 8)
+//  16 bit: unsigned
+//  signed 16 bit: rescaled with slope and intercept and stored with an offset of 32768, so the
+//                 whole signed range fits (e.g. Hounsfield units)
+//  32 bit float: the range [minimum, maximum] gets mapped to [0, UINT16_MAX]
+class VoxelConverter {
+public:
+    VoxelConverter();
+    ~VoxelConverter();
+
+    static bool isNativeEndianness(const Endianness endianness);
+
+    // size of voxelCount voxels in a file, the last byte of odd 12 bit volumes is half used
+    static std::size_t getByteCount(const std::size_t voxelCount, const uint8_t bitsPerVoxel);
+
+    // 8, 12 or 16 bit voxels. For 12 bit the source has to start at an even voxel
+    static void convertTo16Bit(const char* const source, const uint8_t bitsPerVoxel,
+                               const Endianness endianness, uint16_t* const destination,
+                               const std::size_t voxelCount);
+    // 8 or 16 bit voxels, writes every voxel destinationStride elements apart
+    static void convertTo16Bit(const char* const source, const uint8_t bitsPerVoxel,
+                               const Endianness endianness, uint16_t* const destination,
+                               const std::size_t voxelCount, const std::size_t destinationStride);
+    // source and destination may be the same buffer
+    static void convertSigned16BitTo16Bit(const char* const source, const Endianness endianness,
+                                          const float slope, const float intercept,
+                                          uint16_t* const destination,
+                                          const std::size_t voxelCount);
+    static void convertFloat32To16Bit(const char* const source, const Endianness endianness,
+                                      const float minimum, const float maximum,
+                                      uint16_t* const destination, const std::size_t voxelCount);
+    // range of all finite values, minimum and maximum get only narrowed
+    static void findFloat32Range(const char* const source, const Endianness endianness,
+                                 const std::size_t voxelCount, float* const minimum,
+                                 float* const maximum);
+
+    // inverse conversions for writing files
+    // 8, 12 or 16 bit voxels. For 12 bit the destination has to start at an even voxel
+    static void convertFrom16Bit(const uint16_t* const source, const uint8_t bitsPerVoxel,
+                                 const Endianness endianness, char* const destination,
+                                 const std::size_t voxelCount);
+    static void convert16BitToSigned16Bit(const uint16_t* const source,
+                                          const Endianness endianness, const float slope,
+                                          const float intercept, char* const destination,
+                                          const std::size_t voxelCount);
+    static void convert16BitToFloat32(const uint16_t* const source, const Endianness endianness,
+                                      const float minimum, const float maximum,
+                                      char* const destination, const std::size_t voxelCount);
+
+    static void swapBytes(uint16_t* const data, const std::size_t voxelCount);
+
+private:
+    static void expand8Bit(const uint8_t* const source, uint16_t* const destination,
+                           const std::size_t voxelCount);
+    static void unpack12Bit(const uint8_t* const source, uint16_t* const destination,
+                            const std::size_t voxelCount);
+    static void copySwapped16Bit(const char* const source, uint16_t* const destination,
+                                 const std::size_t voxelCount);
+};
+} // namespace VDTK
@@ -1,4 +1,18 @@
 
+#include <atomic>
+#include <cstring>
+#include <threadpool/ThreadPool.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../include/VDTK/common/CommonIO.h"
+#include "../UringFileReader.h"
+#include "../VoxelConverter.h"
+
 #include "BinarySliceImporter.h"
 
 namespace VDTK {
@@ -10,113 +24,195 @@ BinarySliceImporter::~BinarySliceImporter() {}
 bool BinarySliceImporter::import(VolumeData* const volumeData,
                                  const std::filesystem::path& directoryPath,
                                  const uint8_t bitsPerVoxel, const VolumeAxis axis,
-                                 const VDTK::VolumeSize size, const VDTK::VolumeSpacing spacing) {
+                                 const VDTK::VolumeSize size, const VDTK::VolumeSpacing spacing,
+                                 const Endianness endianness, const std::size_t numberOfThreads) {
     if (!std::filesystem::exists(directoryPath)) {
         // Directory does not exist
         return false;
     }
 
-    VolumeData volume(size, spacing);
-
-    std::size_t sliceWidth = 0;
-    std::size_t sliceHeight = 0;
-
-    switch (axis) {
-    case VolumeAxis::XZAxis: {
-        sliceWidth = size.getX();
-        sliceHeight = size.getZ();
-        break;
+    if (bitsPerVoxel != 8 && bitsPerVoxel != 16) {
+        // unsupported voxel format
+        return false;
     }
-    case VolumeAxis::XYAxis: {
-        sliceWidth = size.getX();
-        sliceHeight = size.getY();
-        break;
+
+    // scan the directory only once, slice order is given by the index in the file names
+    const std::vector<std::filesystem::path> slicePaths =
+        FileIOCommon::getSortedFilesInDirectory(directoryPath);
+    if (slicePaths.size() > getNumberOfSlices(size, axis)) {
+        // more slice files than slices in the volume
+        return false;
     }
-    case VolumeAxis::YZAxis:
-    default: {
-        sliceWidth = size.getY();
-        sliceHeight = size.getZ();
-        break;
+
+    VolumeData volume(size, spacing);
+    std::atomic<bool> success = true;
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // every worker reads a contiguous range of files and places the slices directly into the
+        // volume
+        const std::size_t numberOfChunks = std::min(numberOfThreads, slicePaths.size());
+        for (std::size_t chunk = 0; chunk < numberOfChunks; chunk++) {
+            const std::size_t firstSlice = (chunk * slicePaths.size()) / numberOfChunks;
+            const std::size_t lastSlice = ((chunk + 1) * slicePaths.size()) / numberOfChunks;
+            threadPool.enqueue([&, firstSlice, lastSlice]() {
+                if (!importSlices(&volume, slicePaths, firstSlice, lastSlice, bitsPerVoxel,
+                                  endianness, axis, success)) {
+                    success = false;
+                }
+            });
+        }
     }
+
+    if (!success) {
+        return false;
     }
 
-    std::size_t sliceIndex = 0;
-    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath)) {
-        // skip subdirectories
-        if (std::filesystem::is_regular_file(directoryEntry)) {
-            VolumeSlice slice(VDTK::VolumeAxis::XYAxis, 0, 0);
+    *volumeData = std::move(volume);
+    return true;
+}
 
-            if (!loadSlice(&slice, directoryEntry, bitsPerVoxel, axis, sliceWidth, sliceHeight)) {
-                return false;
-            }
-            volume.setSlice(slice, sliceIndex);
-            sliceIndex++;
+bool BinarySliceImporter::importSlices(VolumeData* const volume,
+                                       const std::vector<std::filesystem::path>& slicePaths,
+                                       const std::size_t firstSlice, const std::size_t lastSlice,
+                                       const uint8_t bitsPerVoxel, const Endianness endianness,
+                                       const VolumeAxis axis, const std::atomic<bool>& success) {
+    const SliceLayout firstLayout = getSliceLayout(volume->getSize(), axis, firstSlice);
+    const std::size_t fileSize = (firstLayout.width * firstLayout.height * bitsPerVoxel) / 8;
+
+    // one more byte than expected, so larger files get detected
+    UringFileReader reader(fileSize + 1);
+    if (reader.isValid()) {
+        const bool read = reader.readFiles(
+            slicePaths, firstSlice, lastSlice,
+            [&](const std::size_t sliceIndex, const char* const data, const std::size_t size) {
+                if (!success || size != fileSize) {
+                    // slice dimensions and filesize do not fit together
+                    return false;
+                }
+                convertTo16Bit(data, bitsPerVoxel, endianness, volume->getRawVolumeData().data(),
+                               getSliceLayout(volume->getSize(), axis, sliceIndex));
+                return true;
+            });
+        if (read || reader.isValid()) {
+            return read;
         }
+        // io_uring failed, the files are read again below
     }
 
-    *volumeData = volume;
+    // io_uring is not available or failed, every file is read with its own system calls
+    for (std::size_t sliceIndex = firstSlice; sliceIndex < lastSlice; sliceIndex++) {
+        if (!success ||
+            !importSlice(volume, slicePaths[sliceIndex], bitsPerVoxel, endianness, axis,
+                         sliceIndex)) {
+            return false;
+        }
+    }
     return true;
 }
 
-bool BinarySliceImporter::loadSlice(VolumeSlice* const volumeSlice,
-                                    const std::filesystem::path& filePath,
-                                    const uint8_t bitsPerVoxel, const VolumeAxis axis,
-                                    const std::size_t width, const std::size_t height) {
-    std::size_t fileSize = 0;
-    try {
-        fileSize = std::filesystem::file_size(filePath);
-    } catch (std::filesystem::filesystem_error& e) {
-        std::cout << e.what() << std::endl;
+bool BinarySliceImporter::importSlice(VolumeData* const volume,
+                                      const std::filesystem::path& filePath,
+                                      const uint8_t bitsPerVoxel, const Endianness endianness,
+                                      const VolumeAxis axis, const std::size_t sliceIndex) {
+    const SliceLayout layout = getSliceLayout(volume->getSize(), axis, sliceIndex);
+    const std::size_t fileSize = (layout.width * layout.height * bitsPerVoxel) / 8;
+    uint16_t* const destination = volume->getRawVolumeData().data();
+
+    // XY slices with 16 bit are stored contiguous in the volume and can be read in place
+    if (bitsPerVoxel == 16 && layout.columnStride == 1 && layout.rowStride == layout.width) {
+        if (!readFile(filePath, reinterpret_cast<char*>(destination + layout.offset), fileSize)) {
+            return false;
+        }
+        if (!VoxelConverter::isNativeEndianness(endianness)) {
+            VoxelConverter::swapBytes(destination + layout.offset, layout.width * layout.height);
+        }
+        return true;
+    }
+
+    // every worker thread keeps its read buffer, so importing a stack does not allocate after the
+    // first slice
+    thread_local std::vector<char> buffer;
+    buffer.resize(fileSize);
+    if (!readFile(filePath, buffer.data(), fileSize)) {
         return false;
     }
 
-    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+    convertTo16Bit(buffer.data(), bitsPerVoxel, endianness, destination, layout);
+    return true;
+}
+
+bool BinarySliceImporter::readFile(const std::filesystem::path& filePath, char* const buffer,
+                                   const std::size_t fileSize) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
         // unable to open file
         return false;
     }
 
-    // fileSize is given in bytes, but voxel data can be 12 bit for example.
-    // Therefore we have to calculate the total bits of the file before and then
-    // convert then to bytes by dividing with 8
-    if (fileSize != ((width * height) * bitsPerVoxel) / 8) {
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 ||
+        static_cast<std::size_t>(fileStatus.st_size) != fileSize) {
         // slice dimensions and filesize do not fit together
+        close(fileDescriptor);
         return false;
     }
 
-    std::vector<char> buffer(fileSize);
-    file.seekg(0, std::ios::beg);
-    file.read(buffer.data(), fileSize);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    // the whole file gets read at once, let the kernel read ahead aggressively
+    posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+
+    std::size_t bytesRead = 0;
+    while (bytesRead < fileSize) {
+        const ssize_t result = pread(fileDescriptor, buffer + bytesRead, fileSize - bytesRead,
+                                     static_cast<off_t>(bytesRead));
+        if (result <= 0) {
+            // unable to read file
+            close(fileDescriptor);
+            return false;
+        }
+        bytesRead += static_cast<std::size_t>(result);
+    }
 
-    *volumeSlice =
-        VolumeSlice(axis, convertTo16Bit(&buffer, bitsPerVoxel, width * height), width, height);
+    close(fileDescriptor);
     return true;
-}
-
-const std::vector<uint16_t> BinarySliceImporter::convertTo16Bit(std::vector<char>* buffer,
-                                                                const uint8_t bitsPerPixel,
-                                                                const uint64_t pixelCount) {
-    std::vector<uint16_t> convertedData(pixelCount);
-
-    switch (bitsPerPixel) {
-    case 8: {
-        const uint8_t* const ptr = reinterpret_cast<uint8_t*>(buffer->data());
-        for (uint64_t index = 0; index < pixelCount; index++) {
-            convertedData[index] = static_cast<uint16_t>(ptr[index]) * UINT8_MAX;
-        }
-        break;
+#else
+    std::size_t actualFileSize = 0;
+    try {
+        actualFileSize = std::filesystem::file_size(filePath);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
     }
-    case 16: {
-        const uint16_t* const ptr = reinterpret_cast<uint16_t*>(buffer->data());
-        for (uint64_t index = 0; index < pixelCount; index++) {
-            convertedData[index] = ptr[index];
-        }
-        break;
+
+    if (actualFileSize != fileSize) {
+        // slice dimensions and filesize do not fit together
+        return false;
     }
-    default:
-        break;
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        // unable to open file
+        return false;
     }
+    return static_cast<bool>(file.read(buffer, fileSize));
+#endif
+}
 
-    return convertedData;
+void BinarySliceImporter::convertTo16Bit(const char* const buffer, const uint8_t bitsPerVoxel,
+                                         const Endianness endianness, uint16_t* const destination,
+                                         const SliceLayout& layout) {
+    const std::size_t bytesPerRow = (layout.width * bitsPerVoxel) / 8;
+    for (std::size_t row = 0; row < layout.height; row++) {
+        VoxelConverter::convertTo16Bit(buffer + row * bytesPerRow, bitsPerVoxel, endianness,
+                                       destination + layout.offset + row * layout.rowStride,
+                                       layout.width, layout.columnStride);
+    }
 }
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
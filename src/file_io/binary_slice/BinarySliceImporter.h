@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+
 #include "../include/VDTK/common/CommonDataTypes.h"
+#include "../SliceLayout.h"
 
 namespace VDTK {
 
@@ -8,16 +11,30 @@ public:
     BinarySliceImporter();
     ~BinarySliceImporter();
 
+    // slice order is given by the index in the file names, every regular file in the directory
+    // is interpreted as one slice
     static bool import(VolumeData* const volumeData, const std::filesystem::path& directoryPath,
                        const uint8_t bitsPerVoxel, const VolumeAxis axis,
-                       const VDTK::VolumeSize size, const VDTK::VolumeSpacing spacing);
+                       const VDTK::VolumeSize size, const VDTK::VolumeSpacing spacing,
+                       const Endianness endianness, const std::size_t numberOfThreads);
+
+    // reads one slice file and converts its voxels directly into the given slice of the volume
+    static bool importSlice(VolumeData* const volume, const std::filesystem::path& filePath,
+                            const uint8_t bitsPerVoxel, const Endianness endianness,
+                            const VolumeAxis axis, const std::size_t sliceIndex);
 
 private:
-    static bool loadSlice(VolumeSlice* const volumeSlice, const std::filesystem::path& filePath,
-                          const uint8_t bitsPerVoxel, const VolumeAxis axis,
-                          const std::size_t width, const std::size_t height);
-    static const std::vector<uint16_t> convertTo16Bit(std::vector<char>* buffer,
-                                                      const uint8_t bitsPerPixel,
-                                                      const uint64_t pixelCount);
+    // imports the slices [firstSlice, lastSlice), batched with io_uring if available
+    static bool importSlices(VolumeData* const volume,
+                             const std::vector<std::filesystem::path>& slicePaths,
+                             const std::size_t firstSlice, const std::size_t lastSlice,
+                             const uint8_t bitsPerVoxel, const Endianness endianness,
+                             const VolumeAxis axis, const std::atomic<bool>& success);
+    // reads exactly fileSize bytes, fails if the file has a different size
+    static bool readFile(const std::filesystem::path& filePath, char* const buffer,
+                         const std::size_t fileSize);
+    static void convertTo16Bit(const char* const buffer, const uint8_t bitsPerVoxel,
+                               const Endianness endianness, uint16_t* const destination,
+                               const SliceLayout& layout);
 };
 } // namespace VDTK
@@ -0,0 +1,233 @@
+#include <array>
+#include <cstdlib>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <libbmpread/bmpread.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "BitmapDecoder.h"
+
+namespace {
+// bitmap headers are always stored in little endian
+uint16_t readUInt16(const unsigned char* const data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t readUInt32(const unsigned char* const data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+int32_t readInt32(const unsigned char* const data) {
+    return static_cast<int32_t>(readUInt32(data));
+}
+
+constexpr std::size_t fileHeaderSize = 14;
+constexpr std::size_t infoHeaderSize = 40;
+constexpr uint32_t compressionNone = 0;
+} // namespace
+
+namespace VDTK {
+BitmapDecoder::BitmapDecoder() {}
+
+BitmapDecoder::~BitmapDecoder() {}
+
+bool BitmapDecoder::readSize(const std::filesystem::path& filePath, std::size_t* const width,
+                             std::size_t* const height) {
+    std::ifstream file(filePath, std::ios::binary);
+    std::array<unsigned char, fileHeaderSize + infoHeaderSize> header;
+    if (file.read(reinterpret_cast<char*>(header.data()), header.size()) && header[0] == 'B' &&
+        header[1] == 'M' && readUInt32(&header[fileHeaderSize]) >= infoHeaderSize) {
+        const int32_t fileWidth = readInt32(&header[18]);
+        const int32_t fileHeight = readInt32(&header[22]);
+        if (fileWidth <= 0 || fileHeight == 0 || fileHeight == INT32_MIN) {
+            // invalid size, the height of INT32_MIN has no positive counterpart
+            return false;
+        }
+        *width = static_cast<std::size_t>(fileWidth);
+        *height = static_cast<std::size_t>(std::abs(fileHeight));
+        return true;
+    }
+
+    // older header formats
+    bmpread_t bitmap;
+    if (!bmpread(filePath.string().c_str(), BMPREAD_ANY_SIZE, &bitmap)) {
+        return false;
+    }
+    *width = static_cast<std::size_t>(bitmap.width);
+    *height = static_cast<std::size_t>(bitmap.height);
+    bmpread_free(&bitmap);
+    return true;
+}
+
+bool BitmapDecoder::parseHeader(const unsigned char* const file, const std::size_t fileSize,
+                                BitmapHeader* const header) {
+    if (fileSize < fileHeaderSize + infoHeaderSize || file[0] != 'B' || file[1] != 'M') {
+        return false;
+    }
+
+    const unsigned char* const info = file + fileHeaderSize;
+    const uint32_t infoSize = readUInt32(info);
+    const int32_t width = readInt32(info + 4);
+    const int32_t height = readInt32(info + 8);
+    const uint16_t planes = readUInt16(info + 12);
+
+    header->bitsPerPixel = readUInt16(info + 14);
+    header->compression = readUInt32(info + 16);
+    header->pixelDataOffset = readUInt32(file + 10);
+
+    const bool supportedFormat =
+        infoSize >= infoHeaderSize && planes == 1 && width > 0 && height != 0 &&
+        height != INT32_MIN &&
+        header->compression == compressionNone &&
+        (header->bitsPerPixel == 8 || header->bitsPerPixel == 24 || header->bitsPerPixel == 32);
+    if (!supportedFormat) {
+        return false;
+    }
+
+    header->width = static_cast<std::size_t>(width);
+    header->height = static_cast<std::size_t>(std::abs(height));
+    // negative height marks a bitmap with the top row first
+    header->topDown = height < 0;
+
+    if (header->bitsPerPixel == 8) {
+        const uint32_t colorsUsed = readUInt32(info + 32);
+        header->paletteSize = (colorsUsed == 0) ? 256 : colorsUsed;
+        header->paletteOffset = fileHeaderSize + infoSize;
+        if (header->paletteSize > 256 ||
+            header->paletteOffset + 4 * header->paletteSize > fileSize) {
+            return false;
+        }
+    }
+
+    // rows are padded to a multiple of four bytes
+    const std::size_t rowSize = ((header->bitsPerPixel * header->width + 31) / 32) * 4;
+    return header->pixelDataOffset + rowSize * header->height <= fileSize;
+}
+
+bool BitmapDecoder::decode(const std::filesystem::path& filePath, const PixelMode pixelMode,
+                           uint16_t* const destination, const std::size_t columnStride,
+                           const std::size_t rowStride, const std::size_t expectedWidth,
+                           const std::size_t expectedHeight) {
+    // every worker thread keeps its file buffer, so decoding a stack does not allocate after the
+    // first slice
+    thread_local std::vector<unsigned char> file;
+
+    std::ifstream fileStream(filePath, std::ios::binary | std::ios::ate);
+    if (!fileStream.is_open()) {
+        // unable to open file
+        return false;
+    }
+    const std::size_t fileSize = static_cast<std::size_t>(fileStream.tellg());
+    file.resize(fileSize);
+    fileStream.seekg(0, std::ios::beg);
+    if (!fileStream.read(reinterpret_cast<char*>(file.data()), fileSize)) {
+        // unable to read file
+        return false;
+    }
+
+    return decode(file.data(), fileSize, filePath, pixelMode, destination, columnStride, rowStride,
+                  expectedWidth, expectedHeight);
+}
+
+bool BitmapDecoder::decode(const unsigned char* const file, const std::size_t fileSize,
+                           const std::filesystem::path& filePath, const PixelMode pixelMode,
+                           uint16_t* const destination, const std::size_t columnStride,
+                           const std::size_t rowStride, const std::size_t expectedWidth,
+                           const std::size_t expectedHeight) {
+    BitmapHeader header;
+    if (!parseHeader(file, fileSize, &header)) {
+        return decodeWithBmpread(filePath, pixelMode, destination, columnStride, rowStride,
+                                 expectedWidth, expectedHeight);
+    }
+
+    if (header.width != expectedWidth || header.height != expectedHeight) {
+        return false;
+    }
+
+    const auto toVoxel = (pixelMode == PixelMode::RGBColor) ? &pixelRGBColorToVoxel
+                                                            : &pixelRGBMonochromToVoxel;
+
+    // palette entries are stored as blue, green, red, reserved
+    std::array<uint16_t, 256> paletteLUT = {};
+    for (std::size_t index = 0; index < header.paletteSize; index++) {
+        const unsigned char* const color = file + header.paletteOffset + 4 * index;
+        paletteLUT[index] = toVoxel(color[2], color[1], color[0]);
+    }
+
+    const std::size_t rowSize = ((header.bitsPerPixel * header.width + 31) / 32) * 4;
+    const std::size_t bytesPerPixel = header.bitsPerPixel / 8;
+
+    for (std::size_t row = 0; row < header.height; row++) {
+        // bottom up bitmaps store the last row first
+        const std::size_t fileRow = header.topDown ? row : header.height - 1 - row;
+        const unsigned char* const source = file + header.pixelDataOffset + fileRow * rowSize;
+        uint16_t* const destinationRow = destination + row * rowStride;
+
+        if (header.bitsPerPixel == 8) {
+            for (std::size_t column = 0; column < header.width; column++) {
+                destinationRow[column * columnStride] = paletteLUT[source[column]];
+            }
+        } else if (pixelMode == PixelMode::RGBColor) {
+            // pixels are stored as blue, green, red (, reserved)
+            for (std::size_t column = 0; column < header.width; column++) {
+                const unsigned char* const pixel = source + column * bytesPerPixel;
+                destinationRow[column * columnStride] =
+                    pixelRGBColorToVoxel(pixel[2], pixel[1], pixel[0]);
+            }
+        } else {
+            for (std::size_t column = 0; column < header.width; column++) {
+                const unsigned char* const pixel = source + column * bytesPerPixel;
+                destinationRow[column * columnStride] =
+                    pixelRGBMonochromToVoxel(pixel[2], pixel[1], pixel[0]);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool BitmapDecoder::decodeWithBmpread(const std::filesystem::path& filePath,
+                                      const PixelMode pixelMode, uint16_t* const destination,
+                                      const std::size_t columnStride,
+                                      const std::size_t rowStride,
+                                      const std::size_t expectedWidth,
+                                      const std::size_t expectedHeight) {
+    // top line first, no padding at the end of each line and no power of two restriction
+    bmpread_t bitmap;
+    if (!bmpread(filePath.string().c_str(),
+                 BMPREAD_TOP_DOWN | BMPREAD_BYTE_ALIGN | BMPREAD_ANY_SIZE, &bitmap)) {
+        return false;
+    }
+
+    const std::size_t width = static_cast<std::size_t>(bitmap.width);
+    const std::size_t height = static_cast<std::size_t>(bitmap.height);
+    if (width != expectedWidth || height != expectedHeight) {
+        bmpread_free(&bitmap);
+        return false;
+    }
+
+    const auto toVoxel = (pixelMode == PixelMode::RGBColor) ? &pixelRGBColorToVoxel
+                                                            : &pixelRGBMonochromToVoxel;
+
+    for (std::size_t row = 0; row < height; row++) {
+        // each pixel spans three bytes: the red, green, and blue color components in that order
+        const unsigned char* const source = bitmap.data + 3 * width * row;
+        uint16_t* const destinationRow = destination + row * rowStride;
+        for (std::size_t column = 0; column < width; column++) {
+            destinationRow[column * columnStride] =
+                toVoxel(source[3 * column], source[3 * column + 1], source[3 * column + 2]);
+        }
+    }
+
+    // empty ram from bitmap
+    bmpread_free(&bitmap);
+    return true;
+}
+} // namespace VDTK
@@ -0,0 +1,73 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Decodes bitmap files directly into voxel rows without any allocation per pixel.
+// Uncompressed 8 bit (palette or grayscale), 24 bit and 32 bit bitmaps are decoded natively,
+// all other formats are decoded with libbmpread
+class BitmapDecoder {
+public:
+    BitmapDecoder();
+    ~BitmapDecoder();
+
+    enum class PixelMode { RGBColor, RGBMonochrom };
+
+    static bool readSize(const std::filesystem::path& filePath, std::size_t* const width,
+                         std::size_t* const height);
+
+    // pixel (column, row) with row 0 as top row gets written to
+    // destination[column * columnStride + row * rowStride]
+    // fails if the bitmap does not have the expected size
+    static bool decode(const std::filesystem::path& filePath, const PixelMode pixelMode,
+                       uint16_t* const destination, const std::size_t columnStride,
+                       const std::size_t rowStride, const std::size_t expectedWidth,
+                       const std::size_t expectedHeight);
+    // decodes a bitmap file that is already loaded into memory, filePath is only used if the
+    // format is not decoded natively
+    static bool decode(const unsigned char* const file, const std::size_t fileSize,
+                       const std::filesystem::path& filePath, const PixelMode pixelMode,
+                       uint16_t* const destination, const std::size_t columnStride,
+                       const std::size_t rowStride, const std::size_t expectedWidth,
+                       const std::size_t expectedHeight);
+
+    // POSSIBLE INFORMATION LOSS (24 bit RGB pixel to 16 bit voxel value)
+    // inverse of the 16 bit to 24 bit conversion of the BitmapExporter
+    static inline uint16_t pixelRGBColorToVoxel(const uint8_t red, const uint8_t green,
+                                                const uint8_t blue) {
+        const uint32_t pixel24Bit = static_cast<uint32_t>(red) |
+                                    (static_cast<uint32_t>(green) << 8) |
+                                    (static_cast<uint32_t>(blue) << 16);
+        // convert 24 bit to 16 bit
+        return static_cast<uint16_t>(std::min((pixel24Bit * 2 + 2) / 3, uint32_t(UINT16_MAX)));
+    }
+    // if bitmap is monochrom pixel only got 8 bit. Gets converted to 16 bit voxel value
+    static inline uint16_t pixelRGBMonochromToVoxel(const uint8_t red, const uint8_t green,
+                                                    const uint8_t blue) {
+        // calculate averange of 3 8-bit channels (RGB) and upscale to 16 bit
+        return static_cast<uint16_t>(
+            ((static_cast<uint32_t>(red) + static_cast<uint32_t>(green) + blue) / 3) * UINT8_MAX);
+    }
+
+private:
+    struct BitmapHeader {
+        std::size_t width = 0;
+        std::size_t height = 0;
+        bool topDown = false;
+        uint16_t bitsPerPixel = 0;
+        uint32_t compression = 0;
+        std::size_t pixelDataOffset = 0;
+        std::size_t paletteOffset = 0;
+        std::size_t paletteSize = 0;
+    };
+
+    // returns false if the header can not be parsed or the format is not decoded natively
+    static bool parseHeader(const unsigned char* const file, const std::size_t fileSize,
+                            BitmapHeader* const header);
+
+    static bool decodeWithBmpread(const std::filesystem::path& filePath,
+                                  const PixelMode pixelMode, uint16_t* const destination,
+                                  const std::size_t columnStride, const std::size_t rowStride,
+                                  const std::size_t expectedWidth,
+                                  const std::size_t expectedHeight);
+};
+} // namespace VDTK
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstring>
+
+#include "BitmapEncoder.h"
+
+namespace {
+// bitmap headers are always stored in little endian
+void writeUInt16(unsigned char* const data, const uint16_t value) {
+    data[0] = static_cast<unsigned char>(value);
+    data[1] = static_cast<unsigned char>(value >> 8);
+}
+
+void writeUInt32(unsigned char* const data, const uint32_t value) {
+    data[0] = static_cast<unsigned char>(value);
+    data[1] = static_cast<unsigned char>(value >> 8);
+    data[2] = static_cast<unsigned char>(value >> 16);
+    data[3] = static_cast<unsigned char>(value >> 24);
+}
+
+constexpr std::size_t headerSize = 14 + 40;
+// 72 DPI
+constexpr uint32_t pixelsPerMeter = 2835;
+} // namespace
+
+namespace VDTK {
+BitmapEncoder::BitmapEncoder() {}
+
+BitmapEncoder::~BitmapEncoder() {}
+
+const BitmapEncoder::PixelLUT BitmapEncoder::createRGBColorLUT() {
+    PixelLUT lut(UINT16_MAX + 1);
+    for (uint32_t value = 0; value <= UINT16_MAX; value++) {
+        // convert 16 bit to 24 bit, the highest byte goes into the blue channel and the lowest
+        // byte into the red channel
+        const uint32_t pixel24Bit = (value * 3) / 2;
+        lut[value] = {static_cast<uint8_t>(pixel24Bit >> 16), static_cast<uint8_t>(pixel24Bit >> 8),
+                      static_cast<uint8_t>(pixel24Bit)};
+    }
+    return lut;
+}
+
+const BitmapEncoder::PixelLUT BitmapEncoder::createRGBMonochromLUT() {
+    PixelLUT lut(UINT16_MAX + 1);
+    for (uint32_t value = 0; value <= UINT16_MAX; value++) {
+        // convert 16 bit to 8 bit (inverse of the upscaling with UINT8_MAX while importing, values
+        // above 255 * 255 stay 255), each channel gets same value (monochrom)
+        const uint8_t pixel8Bit =
+            static_cast<uint8_t>(std::min<uint32_t>(value / UINT8_MAX, UINT8_MAX));
+        lut[value] = {pixel8Bit, pixel8Bit, pixel8Bit};
+    }
+    return lut;
+}
+
+const BitmapEncoder::PixelLUT& BitmapEncoder::getLUT(const PixelMode pixelMode) {
+    // created once on first use and shared by all threads afterwards
+    static const PixelLUT colorLUT = createRGBColorLUT();
+    static const PixelLUT monochromLUT = createRGBMonochromLUT();
+
+    return (pixelMode == PixelMode::RGBColor) ? colorLUT : monochromLUT;
+}
+
+bool BitmapEncoder::encode(const std::filesystem::path& filePath, const PixelMode pixelMode,
+                           const uint16_t* const source, const SliceLayout& layout) {
+    const PixelLUT& lut = getLUT(pixelMode);
+
+    // rows are padded to a multiple of four bytes
+    const std::size_t rowSize = ((24 * layout.width + 31) / 32) * 4;
+    const std::size_t imageSize = rowSize * layout.height;
+
+    // every worker thread keeps its file buffer, so encoding a stack does not allocate after the
+    // first slice
+    thread_local std::vector<unsigned char> file;
+    file.assign(headerSize + imageSize, 0);
+
+    // file header
+    file[0] = 'B';
+    file[1] = 'M';
+    writeUInt32(&file[2], static_cast<uint32_t>(file.size()));
+    writeUInt32(&file[10], static_cast<uint32_t>(headerSize));
+    // info header
+    writeUInt32(&file[14], 40);
+    writeUInt32(&file[18], static_cast<uint32_t>(layout.width));
+    writeUInt32(&file[22], static_cast<uint32_t>(layout.height));
+    writeUInt16(&file[26], 1);
+    writeUInt16(&file[28], 24);
+    writeUInt32(&file[34], static_cast<uint32_t>(imageSize));
+    writeUInt32(&file[38], pixelsPerMeter);
+    writeUInt32(&file[42], pixelsPerMeter);
+
+    const uint16_t* const slice = source + layout.offset;
+    for (std::size_t row = 0; row < layout.height; row++) {
+        // bitmaps store the bottom row first
+        unsigned char* destination = file.data() + headerSize + (layout.height - 1 - row) * rowSize;
+        const uint16_t* const sourceRow = slice + row * layout.rowStride;
+        for (std::size_t column = 0; column < layout.width; column++) {
+            std::memcpy(destination, lut[sourceRow[column * layout.columnStride]].data(), 3);
+            destination += 3;
+        }
+    }
+
+    std::ofstream fileStream(filePath, std::ios::out | std::ios::binary);
+    if (!fileStream.write(reinterpret_cast<const char*>(file.data()), file.size())) {
+        // unable to write file
+        return false;
+    }
+    return true;
+}
+} // namespace VDTK
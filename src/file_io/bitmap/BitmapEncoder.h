@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+#include "../SliceLayout.h"
+#include "BitmapDecoder.h"
+
+namespace VDTK {
+// Encodes slices of a volume directly into 24 bit bitmap files without any allocation per pixel
+class BitmapEncoder {
+public:
+    BitmapEncoder();
+    ~BitmapEncoder();
+
+    using PixelMode = BitmapDecoder::PixelMode;
+
+    // writes the slice described by layout, pixel (column, row) with row 0 as top row is read
+    // from source[layout.offset + column * layout.columnStride + row * layout.rowStride]
+    static bool encode(const std::filesystem::path& filePath, const PixelMode pixelMode,
+                       const uint16_t* const source, const SliceLayout& layout);
+
+private:
+    // blue, green and red channel of a bitmap pixel for every 16 bit voxel value
+    typedef std::vector<std::array<uint8_t, 3>> PixelLUT;
+
+    // returns colorful pixel. No information loss (16 bit into 24 bit RBG pixel)
+    static const PixelLUT createRGBColorLUT();
+    // returns monochrom pixel. INFORMATION LOSS (16 bit voxel value into 8 bit RBG channel)
+    static const PixelLUT createRGBMonochromLUT();
+    static const PixelLUT& getLUT(const PixelMode pixelMode);
+};
+} // namespace VDTK
@@ -1,109 +1,143 @@
 
+#include <atomic>
 #include <string>
+#include <threadpool/ThreadPool.h>
 #include <vector>
 
-#include <bitmap/bitmap_image.hpp>
 #include "../include/VDTK/common/CommonIO.h"
 
 #include "BitmapExporter.h"
 
 namespace VDTK {
 bool BitmapExporter::writeColor(const std::filesystem::path& directoryPath,
-                                const VolumeData& volume) {
-    writeAxis(directoryPath, volume, VolumeAxis::YZAxis, PixelMode::RGBColor);
-    writeAxis(directoryPath, volume, VolumeAxis::XZAxis, PixelMode::RGBColor);
-    writeAxis(directoryPath, volume, VolumeAxis::XYAxis, PixelMode::RGBColor);
-
-    // TODO: better error handling
-    return true;
+                                const VolumeData& volume, const std::size_t numberOfThreads) {
+    return write(directoryPath, volume,
+                 {VolumeAxis::YZAxis, VolumeAxis::XZAxis, VolumeAxis::XYAxis}, 0, SIZE_MAX, 1,
+                 PixelMode::RGBColor, numberOfThreads);
 }
 
 bool BitmapExporter::writeMonochrom(const std::filesystem::path& directoryPath,
-                                    const VolumeData& volume) {
-    writeAxis(directoryPath, volume, VolumeAxis::YZAxis, PixelMode::RGBMonochrom);
-    writeAxis(directoryPath, volume, VolumeAxis::XZAxis, PixelMode::RGBMonochrom);
-    writeAxis(directoryPath, volume, VolumeAxis::XYAxis, PixelMode::RGBMonochrom);
+                                    const VolumeData& volume, const std::size_t numberOfThreads) {
+    return write(directoryPath, volume,
+                 {VolumeAxis::YZAxis, VolumeAxis::XZAxis, VolumeAxis::XYAxis}, 0, SIZE_MAX, 1,
+                 PixelMode::RGBMonochrom, numberOfThreads);
+}
 
-    // TODO: better error handling
-    return true;
+bool BitmapExporter::writeColor(const std::filesystem::path& directoryPath,
+                                const VolumeData& volume, const std::vector<VolumeAxis>& axes,
+                                const std::size_t firstSlice, const std::size_t lastSlice,
+                                const std::size_t stride, const std::size_t numberOfThreads) {
+    return write(directoryPath, volume, axes, firstSlice, lastSlice, stride, PixelMode::RGBColor,
+                 numberOfThreads);
 }
 
-inline const std::vector<char> BitmapExporter::convertToRGBColor(const uint16_t voxelValue) {
-    // convert 16 bit to 24 bit
-    const uint32_t tmpRawPixelData = (static_cast<uint32_t>(voxelValue) * 3) / 2;
-    const char* rawPixelData = reinterpret_cast<const char*>(&tmpRawPixelData);
+bool BitmapExporter::writeMonochrom(const std::filesystem::path& directoryPath,
+                                    const VolumeData& volume, const std::vector<VolumeAxis>& axes,
+                                    const std::size_t firstSlice, const std::size_t lastSlice,
+                                    const std::size_t stride, const std::size_t numberOfThreads) {
+    return write(directoryPath, volume, axes, firstSlice, lastSlice, stride,
+                 PixelMode::RGBMonochrom, numberOfThreads);
+}
 
-    // parse 24 bit ISO value into an RGB 555 pixel
-    std::vector<char> pixel(3);
-    pixel[0] = rawPixelData[0];
-    pixel[1] = rawPixelData[1];
-    pixel[2] = rawPixelData[2];
+bool BitmapExporter::write(const std::filesystem::path& directoryPath, const VolumeData& volume,
+                           const std::vector<VolumeAxis>& axes, const std::size_t firstSlice,
+                           const std::size_t lastSlice, const std::size_t stride,
+                           const PixelMode pixelMode, const std::size_t numberOfThreads) {
+    if (stride == 0) {
+        return false;
+    }
 
-    return pixel;
-}
+    // save images to selected directory
+    // create dictionary if not exists
+    try {
+        if (!std::filesystem::exists(directoryPath)) {
+            std::filesystem::create_directories(directoryPath);
+        }
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    if (!std::filesystem::is_directory(directoryPath)) {
+        // path is an existing file, every slice would be written into it at the same time
+        return false;
+    }
+
+    std::atomic<bool> success = true;
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // every slice gets encoded and written by its own task
+        for (const VolumeAxis axis : axes) {
+            const std::size_t numberOfSlices = getNumberOfSlices(volume.getSize(), axis);
+            if (numberOfSlices == 0) {
+                continue;
+            }
+
+            for (std::size_t sliceIndex = firstSlice;
+                 sliceIndex <= std::min(lastSlice, numberOfSlices - 1); sliceIndex += stride) {
+                const std::filesystem::path filePath =
+                    getFilePath(directoryPath, axis, numberOfSlices, sliceIndex);
+                threadPool.enqueue([&volume, &success, filePath, pixelMode, axis, sliceIndex]() {
+                    const SliceLayout layout =
+                        getSliceLayout(volume.getSize(), axis, sliceIndex);
+                    if (!BitmapEncoder::encode(filePath, pixelMode,
+                                               volume.getRawVolumeData().data(), layout)) {
+                        success = false;
+                    }
+                });
+
+                // prevent an overflow of sliceIndex
+                if (numberOfSlices - 1 - sliceIndex < stride) {
+                    break;
+                }
+            }
+        }
+    }
 
-inline const std::vector<char> BitmapExporter::convertToRGBMonochrom(const uint16_t voxelValue) {
-    // convert 16 bit to 8 bit
-    const uint8_t rawPixelData = static_cast<uint8_t>(voxelValue / UINT8_MAX);
+    return success;
+}
 
-    // each channel gets same value (monochrom)
-    std::vector<char> pixel(3);
-    pixel[0] = rawPixelData;
-    pixel[1] = rawPixelData;
-    pixel[2] = rawPixelData;
+bool BitmapExporter::writeSliceColor(const std::filesystem::path& filePath,
+                                     const VolumeSlice& slice) {
+    return writeSlice(filePath, slice, PixelMode::RGBColor);
+}
 
-    return pixel;
+bool BitmapExporter::writeSliceMonochrom(const std::filesystem::path& filePath,
+                                         const VolumeSlice& slice) {
+    return writeSlice(filePath, slice, PixelMode::RGBMonochrom);
 }
 
-void BitmapExporter::writeAxis(const std::filesystem::path& directoryPath, const VolumeData& volume,
-                               VolumeAxis axis, const PixelMode pixelMode) {
-    // Function pointer for the selected pixel mode
-    const std::vector<char> (*convertToPixel)(uint16_t) = nullptr;
-    switch (pixelMode) {
-    case PixelMode::RGBColor: {
-        convertToPixel = &BitmapExporter::convertToRGBColor;
-        break;
-    }
-    case PixelMode::RGBMonochrom: {
-        convertToPixel = &BitmapExporter::convertToRGBMonochrom;
-        break;
-    }
-    default: {
-        convertToPixel = &BitmapExporter::convertToRGBMonochrom;
-        break;
-    }
+bool BitmapExporter::writeSlice(const std::filesystem::path& filePath, const VolumeSlice& slice,
+                                const PixelMode pixelMode) {
+    if (slice.getWidth() == 0 || slice.getHeigth() == 0) {
+        return false;
     }
 
-    std::size_t numberOfSlices = 0;
-    switch (axis) {
-    case VolumeAxis::YZAxis: {
-        numberOfSlices = volume.getSize().getX();
-        break;
-    }
-    case VolumeAxis::XZAxis: {
-        numberOfSlices = volume.getSize().getY();
-        break;
-    }
-    case VolumeAxis::XYAxis: {
-        numberOfSlices = volume.getSize().getZ();
-        break;
-    }
-    default: { break; }
+    // the pixels of a slice are stored column by column
+    std::vector<uint16_t> pixels(slice.getWidth() * slice.getHeigth());
+    for (std::size_t column = 0; column < slice.getWidth(); column++) {
+        for (std::size_t row = 0; row < slice.getHeigth(); row++) {
+            pixels[row + slice.getHeigth() * column] = slice.getPixel(column, row);
+        }
     }
 
-    // proccess each slice of the current axis
-    for (std::size_t sliceIndex = 0; sliceIndex < numberOfSlices; sliceIndex++) {
-        writeAxisAtIndex(convertToPixel, directoryPath, volume, axis, sliceIndex);
-    }
+    SliceLayout layout;
+    layout.width = slice.getWidth();
+    layout.height = slice.getHeigth();
+    layout.columnStride = slice.getHeigth();
+    layout.rowStride = 1;
+    return BitmapEncoder::encode(filePath, pixelMode, pixels.data(), layout);
 }
 
-void BitmapExporter::writeAxisAtIndex(const std::vector<char> (*convertToPixel)(uint16_t),
-                                      const std::filesystem::path& directoryPath,
-                                      const VolumeData& volume, VolumeAxis axis,
-                                      const std::size_t sliceIndex) {
+const std::filesystem::path BitmapExporter::getFilePath(const std::filesystem::path& directoryPath,
+                                                        const VolumeAxis axis,
+                                                        const std::size_t numberOfSlices,
+                                                        const std::size_t sliceIndex) {
     std::string fileName = {};
-
-    // TODO: move to own function
     switch (axis) {
     case VolumeAxis::YZAxis: {
         fileName = "X_";
@@ -120,44 +154,16 @@ void BitmapExporter::writeAxisAtIndex(const std::vector<char> (*convertToPixel)(
     default: { break; }
     }
 
-    VolumeSlice slice = volume.getSlice(axis, sliceIndex);
-
-    bitmap_image image(static_cast<int>(slice.getWidth()), static_cast<int>(slice.getHeigth()));
-
-    // convert the slice into an bitmap with selected pixel representation
-    for (std::size_t x = 0; x < slice.getWidth(); x++) {
-        for (std::size_t y = 0; y < slice.getHeigth(); y++) {
-            // parse 24 bit ISO value into an RGB 555 pixel
-            const std::vector<char> rawPixelData = convertToPixel(slice.getPixel(x, y));
-            rgb_t pixel;
-            pixel.red = rawPixelData[0];
-            pixel.green = rawPixelData[1];
-            pixel.blue = rawPixelData[2];
-
-            image.set_pixel(static_cast<unsigned int>(x), static_cast<unsigned int>(y), pixel);
-        }
-    }
+    // generic file name with the slice index padded to the number of digits of the last index
+    const std::size_t numberOfNeededZeros =
+        VDTK::FileIOCommon::numberOfDigits(numberOfSlices - 1) -
+        VDTK::FileIOCommon::numberOfDigits(sliceIndex);
 
-    // save image to selected directory
-    // create dictionary if not exists
-    if (!std::filesystem::exists(directoryPath)) {
-        std::filesystem::create_directories(directoryPath);
-    }
-    // generate file name
-    std::filesystem::path imageFilePath = directoryPath;
-    // if path is a directory path, generic file name gets generated
-    if (std::filesystem::is_directory(imageFilePath)) {
-        const std::size_t numberOfNeededZeros =
-            VDTK::FileIOCommon::numberOfDigits(slice.getWidth()) -
-            VDTK::FileIOCommon::numberOfDigits(sliceIndex);
-
-        fileName.append(std::string(numberOfNeededZeros, '0'));
-        fileName.append(std::to_string(sliceIndex));
-
-        imageFilePath = imageFilePath / fileName;
-        imageFilePath.replace_extension("bmp");
-    }
+    fileName.append(std::string(numberOfNeededZeros, '0'));
+    fileName.append(std::to_string(sliceIndex));
 
-    image.save_image(imageFilePath.string());
+    std::filesystem::path imageFilePath = directoryPath / fileName;
+    imageFilePath.replace_extension("bmp");
+    return imageFilePath;
 }
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
@@ -1,27 +1,46 @@
 #pragma once
 #include "../include/VDTK/common/CommonDataTypes.h"
+#include "BitmapEncoder.h"
 
 namespace VDTK {
 class BitmapExporter {
 public:
-    static bool writeColor(const std::filesystem::path& directoryPath, const VolumeData& volume);
+    // all slices of all axes
+    static bool writeColor(const std::filesystem::path& directoryPath, const VolumeData& volume,
+                           const std::size_t numberOfThreads);
     static bool writeMonochrom(const std::filesystem::path& directoryPath,
-                               const VolumeData& volume);
+                               const VolumeData& volume, const std::size_t numberOfThreads);
+
+    // slices firstSlice, firstSlice + stride, ... up to lastSlice (inclusive) of each given axis.
+    // lastSlice gets clamped to the last slice of the axis
+    static bool writeColor(const std::filesystem::path& directoryPath, const VolumeData& volume,
+                           const std::vector<VolumeAxis>& axes, const std::size_t firstSlice,
+                           const std::size_t lastSlice, const std::size_t stride,
+                           const std::size_t numberOfThreads);
+    static bool writeMonochrom(const std::filesystem::path& directoryPath,
+                               const VolumeData& volume, const std::vector<VolumeAxis>& axes,
+                               const std::size_t firstSlice, const std::size_t lastSlice,
+                               const std::size_t stride, const std::size_t numberOfThreads);
+
+    // single slice, e.g. a projection
+    static bool writeSliceColor(const std::filesystem::path& filePath, const VolumeSlice& slice);
+    static bool writeSliceMonochrom(const std::filesystem::path& filePath,
+                                    const VolumeSlice& slice);
 
 private:
-    enum class PixelMode { RGBColor, RGBMonochrom };
+    using PixelMode = BitmapEncoder::PixelMode;
+
+    static bool write(const std::filesystem::path& directoryPath, const VolumeData& volume,
+                      const std::vector<VolumeAxis>& axes, const std::size_t firstSlice,
+                      const std::size_t lastSlice, const std::size_t stride,
+                      const PixelMode pixelMode, const std::size_t numberOfThreads);
 
-    // returns colorful pixel. No information loss (16 bit into 24 bit RBG pixel)
-    static inline const std::vector<char> convertToRGBColor(const uint16_t voxelValue);
-    // returns monochrom pixel. INFORMATION LOSS (16 bit voxel value into 8 bit
-    // RBG channel)
-    static inline const std::vector<char> convertToRGBMonochrom(const uint16_t voxelValue);
+    static bool writeSlice(const std::filesystem::path& filePath, const VolumeSlice& slice,
+                           const PixelMode pixelMode);
 
-    static void writeAxis(const std::filesystem::path& directoryPath, const VolumeData& volume,
-                          VolumeAxis axis, const PixelMode pixelMode);
-    static void writeAxisAtIndex(const std::vector<char> (*convertToPixel)(uint16_t),
-                                 const std::filesystem::path& directoryPath,
-                                 const VolumeData& volume, VolumeAxis axis,
-                                 const std::size_t sliceIndex);
+    static const std::filesystem::path getFilePath(const std::filesystem::path& directoryPath,
+                                                   const VolumeAxis axis,
+                                                   const std::size_t numberOfSlices,
+                                                   const std::size_t sliceIndex);
 };
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
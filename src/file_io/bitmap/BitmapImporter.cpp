@@ -1,16 +1,11 @@
 
 #include <algorithm>
-#include <cstring>
+#include <atomic>
+#include <threadpool/ThreadPool.h>
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include <libbmpread/bmpread.h>
-
-#ifdef __cplusplus
-}
-#endif
+#include "../include/VDTK/common/CommonIO.h"
+#include "../SliceLayout.h"
+#include "../UringFileReader.h"
 
 #include "BitmapImporter.h"
 
@@ -23,178 +18,154 @@ BitmapImporter::~BitmapImporter() {}
 
 bool BitmapImporter::importMonochrom(VolumeData* const volumeData,
                                      const std::filesystem::path& directoryPath,
-                                     const VolumeAxis axis, const VDTK::VolumeSpacing spacing) {
-    return import(volumeData, directoryPath, axis, spacing, PixelMode::RGBMonochrom);
+                                     const VolumeAxis axis, const VDTK::VolumeSpacing spacing,
+                                     const std::size_t numberOfThreads) {
+    return import(volumeData, directoryPath, axis, spacing, PixelMode::RGBMonochrom,
+                  numberOfThreads);
 }
 
 bool BitmapImporter::importColor(VolumeData* const volumeData,
                                  const std::filesystem::path& directoryPath, const VolumeAxis axis,
-                                 const VDTK::VolumeSpacing spacing) {
-    return import(volumeData, directoryPath, axis, spacing, PixelMode::RGBColor);
-}
-
-inline uint16_t BitmapImporter::pixelRGBColorToVoxel(const std::vector<char> pixel) {
-    // convert pixel to unsigned int (technically 32 bit, but interpreted as 24
-    // bit)
-    std::vector<char> rawPixel24Bit(4);
-    rawPixel24Bit[0] = pixel[0];
-    rawPixel24Bit[0] = pixel[1];
-    rawPixel24Bit[0] = pixel[2];
-    rawPixel24Bit[0] = 0;
-    uint32_t pixel24Bit = 0;
-    std::memcpy(rawPixel24Bit.data(), &pixel24Bit, rawPixel24Bit.size());
-
-    // convert 24 bit to 16 bit
-    pixel24Bit /= 3;
-    pixel24Bit *= 2;
-
-    return static_cast<uint16_t>(pixel24Bit);
-}
-
-inline uint16_t BitmapImporter::pixelRGBMonochromToVoxel(const std::vector<char> pixel) {
-    // calculate averange of 3 8-bit channels (RGB)
-    uint32_t rawPixel = 0;
-    rawPixel += static_cast<uint32_t>(pixel[0]);
-    rawPixel += static_cast<uint32_t>(pixel[1]);
-    rawPixel += static_cast<uint32_t>(pixel[2]);
-    rawPixel /= 3;
-
-    // upscale 8 bit values to 16 bit
-    rawPixel *= UINT8_MAX;
-
-    return static_cast<uint16_t>(rawPixel);
-}
-
-std::size_t BitmapImporter::getNumberOfBitmapsInDirectory(
-    const std::filesystem::path& directoryPath) {
-    std::size_t numberOfBitmaps = 0;
-    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath)) {
-        const bool isFile = std::filesystem::is_regular_file(directoryEntry);
-        const bool isBitmap =
-            std::find(m_validExtenions.begin(), m_validExtenions.end(),
-                      directoryEntry.path().extension()) != m_validExtenions.end();
-        if (isFile && isBitmap) {
-            numberOfBitmaps++;
-        }
-    }
-
-    return numberOfBitmaps;
+                                 const VDTK::VolumeSpacing spacing,
+                                 const std::size_t numberOfThreads) {
+    return import(volumeData, directoryPath, axis, spacing, PixelMode::RGBColor, numberOfThreads);
 }
 
-const VDTK::VolumeSize BitmapImporter::calculateVolumeSize(
-    const std::filesystem::path& directoryPath, const VolumeAxis axis) {
-    VDTK::VolumeSize size = VDTK::VolumeSize(0, 0, 0);
-
-    // get the path of the first found bitmap file in the directory
-    std::filesystem::path firstBitmapInDirectory;
-    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath)) {
-        const bool isFile = std::filesystem::is_regular_file(directoryEntry);
-        const bool isBitmap =
-            std::find(m_validExtenions.begin(), m_validExtenions.end(),
-                      directoryEntry.path().extension()) != m_validExtenions.end();
-        if (isFile && isBitmap) {
-            firstBitmapInDirectory = directoryEntry.path();
-            break;
-        }
-    }
-
-    // load bitmap from path of the first found bitmap file in directory
-    bmpread_t bitmap;
-    bmpread(firstBitmapInDirectory.string().c_str(), 0, &bitmap);
-
+const VDTK::VolumeSize BitmapImporter::calculateVolumeSize(const std::size_t numberOfBitmaps,
+                                                          const std::size_t bitmapWidth,
+                                                          const std::size_t bitmapHeight,
+                                                          const VolumeAxis axis) {
     // interpret bitmap width and hight depending on the axis
     switch (axis) {
     case VolumeAxis::YZAxis: {
-        size.setX(getNumberOfBitmapsInDirectory(directoryPath));
-        size.setY(bitmap.width);
-        size.setZ(bitmap.height);
-        break;
+        return VDTK::VolumeSize(numberOfBitmaps, bitmapWidth, bitmapHeight);
     }
     case VolumeAxis::XZAxis: {
-        size.setX(bitmap.width);
-        size.setY(getNumberOfBitmapsInDirectory(directoryPath));
-        size.setZ(bitmap.height);
-        break;
+        return VDTK::VolumeSize(bitmapWidth, numberOfBitmaps, bitmapHeight);
     }
     case VolumeAxis::XYAxis: {
-        size.setX(bitmap.height);
-        size.setY(bitmap.width);
-        size.setZ(getNumberOfBitmapsInDirectory(directoryPath));
-        break;
+        return VDTK::VolumeSize(bitmapWidth, bitmapHeight, numberOfBitmaps);
     }
-    default: { break; }
+    default: { return VDTK::VolumeSize(0, 0, 0); }
     }
-
-    // empty ram from bitmap
-    bmpread_free(&bitmap);
-
-    return size;
 }
 
-// TODO: needs some refactoring
 bool BitmapImporter::import(VolumeData* const volumeData,
                             const std::filesystem::path& directoryPath, const VolumeAxis axis,
-                            const VDTK::VolumeSpacing spacing, const PixelMode pixelMode) {
+                            const VDTK::VolumeSpacing spacing, const PixelMode pixelMode,
+                            const std::size_t numberOfThreads) {
     if (!std::filesystem::exists(directoryPath)) {
         // Directory does not exist
         return false;
     }
 
-    if (getNumberOfBitmapsInDirectory(directoryPath) == 0) {
+    // scan the directory only once, slice order is given by the index in the file names
+    const std::vector<std::filesystem::path> bitmapPaths =
+        FileIOCommon::getSortedFilesInDirectory(directoryPath, m_validExtenions);
+    if (bitmapPaths.empty()) {
         // No Bitmap files in directory
         return false;
     }
 
-    VolumeData volume(calculateVolumeSize(directoryPath, axis), spacing);
-
-    std::size_t sliceIndex = 0;
-    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath)) {
-        const bool isFile = std::filesystem::is_regular_file(directoryEntry);
-        const bool isBitmap =
-            std::find(m_validExtenions.begin(), m_validExtenions.end(),
-                      directoryEntry.path().extension()) != m_validExtenions.end();
-        if (isFile && isBitmap) {
-            bmpread_t bitmap;
-            bmpread(directoryEntry.path().string().c_str(), 0, &bitmap);
-            VolumeSlice slice(axis, bitmap.width, bitmap.height);
-
-            // fill slice with bitmap pixel
-            for (std::size_t width = 0; width < static_cast<std::size_t>(bitmap.width); width++) {
-                for (std::size_t height = 0; height < static_cast<std::size_t>(bitmap.height);
-                     height++) {
-                    // By default, each pixel spans three bytes: the red, green, and blue
-                    // color components in that order
-
-                    std::vector<char> rawPixelData(3);
-                    rawPixelData[0] = bitmap.data[3 * ((height + (bitmap.height * width)) + 0)];
-                    rawPixelData[1] = bitmap.data[3 * ((height + (bitmap.height * width)) + 1)];
-                    rawPixelData[2] = bitmap.data[3 * ((height + (bitmap.height * width)) + 2)];
-
-                    uint16_t voxelValue = 0;
-                    switch (pixelMode) {
-                    case PixelMode::RGBColor: {
-                        voxelValue = pixelRGBColorToVoxel(rawPixelData);
-                        break;
-                    }
-                    case PixelMode::RGBMonochrom:
-                    default: {
-                        voxelValue = pixelRGBMonochromToVoxel(rawPixelData);
-                        break;
-                    }
-                    }
-                    slice.setPixel(width, height, voxelValue);
+    // the first bitmap defines the slice size, all other bitmaps must have the same size
+    std::size_t bitmapWidth = 0;
+    std::size_t bitmapHeight = 0;
+    if (!BitmapDecoder::readSize(bitmapPaths.front(), &bitmapWidth, &bitmapHeight)) {
+        return false;
+    }
+    const VDTK::VolumeSize size =
+        calculateVolumeSize(bitmapPaths.size(), bitmapWidth, bitmapHeight, axis);
+
+    VolumeData volume(size, spacing);
+    std::atomic<bool> success = true;
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // every worker decodes a contiguous range of bitmaps into their slices of the volume
+        const std::size_t numberOfChunks = std::min(numberOfThreads, bitmapPaths.size());
+        for (std::size_t chunk = 0; chunk < numberOfChunks; chunk++) {
+            const std::size_t firstSlice = (chunk * bitmapPaths.size()) / numberOfChunks;
+            const std::size_t lastSlice = ((chunk + 1) * bitmapPaths.size()) / numberOfChunks;
+            threadPool.enqueue([&, firstSlice, lastSlice]() {
+                if (!importSlices(&volume, bitmapPaths, firstSlice, lastSlice, axis, pixelMode,
+                                  success)) {
+                    success = false;
                 }
-            }
-            // empty ram from bitmap
-            bmpread_free(&bitmap);
+            });
+        }
+    }
+
+    if (!success) {
+        return false;
+    }
 
-            volume.setSlice(slice, sliceIndex);
+    *volumeData = std::move(volume);
+    return true;
+}
 
-            sliceIndex++;
+bool BitmapImporter::importSlices(VolumeData* const volume,
+                                  const std::vector<std::filesystem::path>& bitmapPaths,
+                                  const std::size_t firstSlice, const std::size_t lastSlice,
+                                  const VolumeAxis axis, const PixelMode pixelMode,
+                                  const std::atomic<bool>& success) {
+    std::size_t fileSize = 0;
+    try {
+        fileSize = std::filesystem::file_size(bitmapPaths[firstSlice]);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    // bitmaps of a stack usually have the same file size. One more byte than that, so larger
+    // files get detected
+    UringFileReader reader(fileSize + 1);
+    if (reader.isValid()) {
+        const bool read = reader.readFiles(
+            bitmapPaths, firstSlice, lastSlice,
+            [&](const std::size_t sliceIndex, const char* const data, const std::size_t size) {
+                if (!success) {
+                    return false;
+                }
+                if (size > fileSize) {
+                    // file got truncated, decode it on its own
+                    return importSlice(volume, bitmapPaths[sliceIndex], axis, sliceIndex,
+                                       pixelMode);
+                }
+                const SliceLayout layout = getSliceLayout(volume->getSize(), axis, sliceIndex);
+                return BitmapDecoder::decode(reinterpret_cast<const unsigned char*>(data), size,
+                                             bitmapPaths[sliceIndex], pixelMode,
+                                             volume->getRawVolumeData().data() + layout.offset,
+                                             layout.columnStride, layout.rowStride, layout.width,
+                                             layout.height);
+            });
+        if (read || reader.isValid()) {
+            return read;
         }
+        // io_uring failed, the files are read again below
     }
 
-    *volumeData = volume;
+    // io_uring is not available or failed, every file is read with its own system calls
+    for (std::size_t sliceIndex = firstSlice; sliceIndex < lastSlice; sliceIndex++) {
+        if (!success ||
+            !importSlice(volume, bitmapPaths[sliceIndex], axis, sliceIndex, pixelMode)) {
+            return false;
+        }
+    }
     return true;
 }
-} // namespace VDTK
\ No newline at end of file
+
+bool BitmapImporter::importSlice(VolumeData* const volume, const std::filesystem::path& filePath,
+                                 const VolumeAxis axis, const std::size_t sliceIndex,
+                                 const PixelMode pixelMode) {
+    const SliceLayout layout = getSliceLayout(volume->getSize(), axis, sliceIndex);
+
+    // all bitmaps of a stack must have the same size, otherwise decoding fails
+    return BitmapDecoder::decode(filePath, pixelMode,
+                                 volume->getRawVolumeData().data() + layout.offset,
+                                 layout.columnStride, layout.rowStride, layout.width,
+                                 layout.height);
+}
+} // namespace VDTK
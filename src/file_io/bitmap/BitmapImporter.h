@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+
 #include "../include/VDTK/common/CommonDataTypes.h"
+#include "BitmapDecoder.h"
 
 namespace VDTK {
 class BitmapImporter {
@@ -9,26 +12,32 @@ public:
 
     static bool importMonochrom(VolumeData* const volumeData,
                                 const std::filesystem::path& directoryPath, const VolumeAxis axis,
-                                const VDTK::VolumeSpacing spacing);
+                                const VDTK::VolumeSpacing spacing,
+                                const std::size_t numberOfThreads);
     static bool importColor(VolumeData* const volumeData,
                             const std::filesystem::path& directoryPath, const VolumeAxis axis,
-                            const VDTK::VolumeSpacing spacing);
+                            const VDTK::VolumeSpacing spacing, const std::size_t numberOfThreads);
 
 private:
-    enum class PixelMode { RGBColor, RGBMonochrom };
-
-    // POSSIBLE INFORMATION LOSS (24 bit RGB pixel to 16 bit voxel value)
-    static inline uint16_t pixelRGBColorToVoxel(const std::vector<char> pixel);
-    // if bitmap is monochrom pixel only got 8 bit. Gets converted to 16 bit voxel
-    // value
-    static inline uint16_t pixelRGBMonochromToVoxel(const std::vector<char> pixel);
+    using PixelMode = BitmapDecoder::PixelMode;
 
-    static std::size_t getNumberOfBitmapsInDirectory(const std::filesystem::path& directoryPath);
-    static const VDTK::VolumeSize calculateVolumeSize(const std::filesystem::path& directoryPath,
+    static const VDTK::VolumeSize calculateVolumeSize(const std::size_t numberOfBitmaps,
+                                                      const std::size_t bitmapWidth,
+                                                      const std::size_t bitmapHeight,
                                                       const VolumeAxis axis);
     static bool import(VolumeData* const volumeData, const std::filesystem::path& directoryPath,
                        const VolumeAxis axis, const VDTK::VolumeSpacing spacing,
-                       const PixelMode pixelMode);
+                       const PixelMode pixelMode, const std::size_t numberOfThreads);
+    // decodes the bitmaps [firstSlice, lastSlice), batched with io_uring if available
+    static bool importSlices(VolumeData* const volume,
+                             const std::vector<std::filesystem::path>& bitmapPaths,
+                             const std::size_t firstSlice, const std::size_t lastSlice,
+                             const VolumeAxis axis, const PixelMode pixelMode,
+                             const std::atomic<bool>& success);
+    // decodes one bitmap and writes its pixels directly into the given slice of the volume
+    static bool importSlice(VolumeData* const volume, const std::filesystem::path& filePath,
+                            const VolumeAxis axis, const std::size_t sliceIndex,
+                            const PixelMode pixelMode);
 
     static const std::vector<std::string> m_validExtenions;
 };
@@ -0,0 +1,99 @@
+
+#include <cmath>
+#include <cstring>
+
+#include "MeshWriter.h"
+
+namespace VDTK {
+namespace {
+template <typename T>
+void appendLittleEndian(const T value, std::vector<char>* const destination) {
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        destination->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void appendFloat(const float value, std::vector<char>* const destination) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    appendLittleEndian<uint32_t>(bits, destination);
+}
+} // namespace
+
+MeshWriter::MeshWriter() {}
+
+MeshWriter::~MeshWriter() {}
+
+bool MeshWriter::writeStl(const std::filesystem::path& filePath, const SurfaceMesh& mesh) {
+    if (mesh.triangles.size() > UINT32_MAX) {
+        // triangle count does not fit into the header
+        return false;
+    }
+
+    std::vector<char> data(80, 0);
+    const char description[] = "VDTK isosurface";
+    std::memcpy(data.data(), description, sizeof(description) - 1);
+    data.reserve(84 + 50 * mesh.triangles.size());
+    appendLittleEndian<uint32_t>(static_cast<uint32_t>(mesh.triangles.size()), &data);
+
+    for (const std::array<uint32_t, 3>& triangle : mesh.triangles) {
+        const std::array<float, 3>& a = mesh.vertices[triangle[0]];
+        const std::array<float, 3>& b = mesh.vertices[triangle[1]];
+        const std::array<float, 3>& c = mesh.vertices[triangle[2]];
+
+        // normal of the counterclockwise triangle, zero for degenerated triangles
+        std::array<float, 3> normal = {
+            (b[1] - a[1]) * (c[2] - a[2]) - (b[2] - a[2]) * (c[1] - a[1]),
+            (b[2] - a[2]) * (c[0] - a[0]) - (b[0] - a[0]) * (c[2] - a[2]),
+            (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])};
+        const float length =
+            std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (float& component : normal) {
+            component = (length > 0.0f) ? component / length : 0.0f;
+        }
+
+        for (const std::array<float, 3>& vector : {normal, a, b, c}) {
+            for (const float component : vector) {
+                appendFloat(component, &data);
+            }
+        }
+        // attribute byte count
+        appendLittleEndian<uint16_t>(0, &data);
+    }
+    return writeFile(filePath, data);
+}
+
+bool MeshWriter::writePly(const std::filesystem::path& filePath, const SurfaceMesh& mesh) {
+    const std::string header = "ply\nformat binary_little_endian 1.0\ncomment VDTK isosurface\n"
+                               "element vertex " +
+                               std::to_string(mesh.vertices.size()) +
+                               "\nproperty float x\nproperty float y\nproperty float z\n"
+                               "element face " +
+                               std::to_string(mesh.triangles.size()) +
+                               "\nproperty list uchar uint vertex_indices\nend_header\n";
+
+    std::vector<char> data(header.begin(), header.end());
+    data.reserve(header.size() + 12 * mesh.vertices.size() + 13 * mesh.triangles.size());
+    for (const std::array<float, 3>& vertex : mesh.vertices) {
+        for (const float component : vertex) {
+            appendFloat(component, &data);
+        }
+    }
+    for (const std::array<uint32_t, 3>& triangle : mesh.triangles) {
+        data.push_back(3);
+        for (const uint32_t index : triangle) {
+            appendLittleEndian<uint32_t>(index, &data);
+        }
+    }
+    return writeFile(filePath, data);
+}
+
+bool MeshWriter::writeFile(const std::filesystem::path& filePath, const std::vector<char>& data) {
+    std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (file.fail() || !file.write(data.data(), data.size())) {
+        // unable to write file
+        return false;
+    }
+    return true;
+}
+} // namespace VDTK
@@ -0,0 +1,19 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Binary little endian mesh files. The file gets encoded into memory and written at once
+class MeshWriter {
+public:
+    MeshWriter();
+    ~MeshWriter();
+
+    // binary STL, every triangle stores its normal and its three vertices
+    static bool writeStl(const std::filesystem::path& filePath, const SurfaceMesh& mesh);
+    // binary PLY with a shared vertex list and triangles as vertex indices
+    static bool writePly(const std::filesystem::path& filePath, const SurfaceMesh& mesh);
+
+private:
+    static bool writeFile(const std::filesystem::path& filePath, const std::vector<char>& data);
+};
+} // namespace VDTK
@@ -0,0 +1,184 @@
+
+#include <cstring>
+#include <sstream>
+
+#include "../MappedFile.h"
+#include "MetaImageReader.h"
+
+namespace VDTK {
+namespace {
+std::string trim(const std::string& text) {
+    const std::size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+template <typename T>
+std::vector<T> parseList(const std::string& text) {
+    std::istringstream stream(text);
+    std::vector<T> values;
+    T value;
+    while (stream >> value) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+bool parseBool(const std::string& text) {
+    return text == "True" || text == "true" || text == "TRUE" || text == "1";
+}
+} // namespace
+
+MetaImageReader::MetaImageReader() {}
+
+MetaImageReader::~MetaImageReader() {}
+
+bool MetaImageReader::read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                           const std::size_t numberOfThreads) {
+    MappedFile headerFile;
+    if (!headerFile.open(filePath)) {
+        return false;
+    }
+
+    Header header;
+    std::size_t headerEnd = 0;
+    if (!parseHeader(headerFile.getData(), headerFile.getSize(), &header, &headerEnd)) {
+        return false;
+    }
+
+    if (header.size.size() != header.numberOfDimensions || header.size.size() < 2 ||
+        header.size.size() > 3 || !header.voxelTypeFound ||
+        header.compressed || header.numberOfChannels != 1 || header.dataFile.empty()) {
+        // unsupported volume
+        return false;
+    }
+
+    // 2D images are volumes with a single slice
+    header.size.resize(3, 1);
+    header.spacing.resize(3, 1.0f);
+    const VolumeSize size(header.size[0], header.size[1], header.size[2]);
+    const VolumeSpacing spacing(header.spacing[0], header.spacing[1], header.spacing[2]);
+    std::size_t dataSize = 0;
+    if (!RawReader::getDataSize(size, header.voxelType, &dataSize)) {
+        // volume does not fit into memory
+        return false;
+    }
+
+    if (header.dataFile == "LOCAL") {
+        if (headerFile.getSize() - headerEnd < dataSize) {
+            // Volume dimensions and data size do not fit together
+            return false;
+        }
+        return RawReader::readMemory(volumeData, headerFile.getData() + headerEnd,
+                                     headerFile.getSize() - headerEnd, header.voxelType, size,
+                                     spacing, header.endianness, numberOfThreads);
+    }
+
+    if (header.dataFile == "LIST" || header.dataFile.find('%') != std::string::npos) {
+        // data split into several files
+        return false;
+    }
+
+    MappedFile dataFile;
+    if (!dataFile.open(filePath.parent_path() / header.dataFile)) {
+        return false;
+    }
+
+    std::size_t offset = static_cast<std::size_t>(header.headerSize);
+    if (header.headerSize < 0) {
+        offset = (dataFile.getSize() >= dataSize) ? dataFile.getSize() - dataSize : 0;
+    }
+    if (offset > dataFile.getSize() || dataFile.getSize() - offset < dataSize) {
+        // Volume dimensions and data size do not fit together
+        return false;
+    }
+
+    return RawReader::readMemory(volumeData, dataFile.getData() + offset,
+                                 dataFile.getSize() - offset, header.voxelType, size, spacing,
+                                 header.endianness, numberOfThreads);
+}
+
+bool MetaImageReader::parseHeader(const char* const data, const std::size_t size,
+                                  Header* const header, std::size_t* const dataOffset) {
+    std::size_t position = 0;
+    while (position < size) {
+        const char* const lineEnd =
+            static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+        const std::size_t nextPosition =
+            (lineEnd != nullptr) ? static_cast<std::size_t>(lineEnd - data) + 1 : size;
+        const std::string line(data + position, nextPosition - position);
+        position = nextPosition;
+
+        const std::size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        const std::string key = trim(line.substr(0, separator));
+        const std::string value = trim(line.substr(separator + 1));
+
+        try {
+            if (!parseEntry(key, value, header)) {
+                continue;
+            }
+        } catch (const std::logic_error&) {
+            // invalid number
+            return false;
+        }
+
+        if (key == "ElementDataFile") {
+            // always the last entry of the header
+            *dataOffset = position;
+            return true;
+        }
+    }
+
+    // header without data
+    return false;
+}
+
+bool MetaImageReader::parseEntry(const std::string& key, const std::string& value,
+                                 Header* const header) {
+    if (key == "NDims") {
+        header->numberOfDimensions = std::stoul(value);
+    } else if (key == "DimSize") {
+        header->size = parseList<std::size_t>(value);
+    } else if (key == "ElementSpacing") {
+        header->spacing = parseList<float>(value);
+    } else if (key == "ElementSize" && header->spacing.empty()) {
+        header->spacing = parseList<float>(value);
+    } else if (key == "ElementType") {
+        header->voxelTypeFound = parseVoxelType(value, &header->voxelType);
+    } else if (key == "ElementByteOrderMSB" || key == "BinaryDataByteOrderMSB") {
+        header->endianness = parseBool(value) ? Endianness::Big : Endianness::Little;
+    } else if (key == "HeaderSize") {
+        header->headerSize = std::stoll(value);
+    } else if (key == "CompressedData") {
+        header->compressed = parseBool(value);
+    } else if (key == "ElementNumberOfChannels") {
+        header->numberOfChannels = std::stoul(value);
+    } else if (key == "ElementDataFile") {
+        header->dataFile = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool MetaImageReader::parseVoxelType(const std::string& elementType,
+                                     RawVoxelType* const voxelType) {
+    if (elementType == "MET_UCHAR") {
+        *voxelType = RawVoxelType::Unsigned8Bit;
+    } else if (elementType == "MET_USHORT") {
+        *voxelType = RawVoxelType::Unsigned16Bit;
+    } else if (elementType == "MET_SHORT") {
+        *voxelType = RawVoxelType::Signed16Bit;
+    } else if (elementType == "MET_FLOAT") {
+        *voxelType = RawVoxelType::Float32;
+    } else {
+        return false;
+    }
+    return true;
+}
+} // namespace VDTK
@@ -0,0 +1,42 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+#include "../raw/RawReader.h"
+
+namespace VDTK {
+// Reads MetaImage files, either a .mhd header with detached data or a .mha file with the data
+// following the header (ElementDataFile = LOCAL). The data gets mapped into memory instead of
+// being read into a buffer. Supported element types: MET_UCHAR, MET_USHORT, MET_SHORT,
+// MET_FLOAT, uncompressed and with a single channel
+class MetaImageReader {
+public:
+    MetaImageReader();
+    ~MetaImageReader();
+
+    static bool read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                     const std::size_t numberOfThreads);
+
+private:
+    struct Header {
+        std::size_t numberOfDimensions = 0;
+        std::vector<std::size_t> size;
+        std::vector<float> spacing;
+        RawVoxelType voxelType = RawVoxelType::Unsigned16Bit;
+        bool voxelTypeFound = false;
+        Endianness endianness = Endianness::Little;
+        // -1: data is at the end of the data file
+        long long headerSize = 0;
+        bool compressed = false;
+        std::size_t numberOfChannels = 1;
+        std::string dataFile;
+    };
+
+    // dataOffset is the position after the ElementDataFile line
+    static bool parseHeader(const char* const data, const std::size_t size, Header* const header,
+                            std::size_t* const dataOffset);
+    // returns false for unknown keys, throws std::logic_error for invalid numbers
+    static bool parseEntry(const std::string& key, const std::string& value,
+                           Header* const header);
+    static bool parseVoxelType(const std::string& elementType, RawVoxelType* const voxelType);
+};
+} // namespace VDTK
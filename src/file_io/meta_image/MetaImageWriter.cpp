@@ -0,0 +1,52 @@
+
+#include <limits>
+#include <sstream>
+
+#include "../raw/RawWriter.h"
+#include "MetaImageWriter.h"
+
+namespace VDTK {
+MetaImageWriter::MetaImageWriter() {}
+
+MetaImageWriter::~MetaImageWriter() {}
+
+bool MetaImageWriter::write(const std::filesystem::path& filePath, const VolumeData& volume,
+                            const std::size_t numberOfThreads) {
+    const bool attachedData = filePath.extension() == ".mha";
+    std::filesystem::path dataFilePath = filePath;
+    dataFilePath.replace_extension("raw");
+    if (!attachedData && dataFilePath == filePath) {
+        // header would be overwritten by the data
+        return false;
+    }
+
+    const VolumeSize size = volume.getSize();
+    const VolumeSpacing spacing = volume.getSpacing();
+    std::ostringstream header;
+    header.precision(std::numeric_limits<float>::max_digits10);
+    header << "ObjectType = Image\n"
+           << "NDims = 3\n"
+           << "BinaryData = True\n"
+           << "BinaryDataByteOrderMSB = False\n"
+           << "CompressedData = False\n"
+           << "DimSize = " << size.getX() << " " << size.getY() << " " << size.getZ() << "\n"
+           << "ElementSpacing = " << spacing.getX() << " " << spacing.getY() << " "
+           << spacing.getZ() << "\n"
+           << "ElementType = MET_USHORT\n"
+           << "ElementDataFile = "
+           << (attachedData ? std::string("LOCAL") : dataFilePath.filename().string()) << "\n";
+
+    if (attachedData) {
+        return RawWriter::writeWithHeader(filePath, header.str(), volume, numberOfThreads);
+    }
+
+    std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (file.fail() || !file.write(header.str().data(), header.str().size())) {
+        // unable to write file
+        return false;
+    }
+    file.close();
+
+    return RawWriter::write(dataFilePath, 16, volume, false, numberOfThreads);
+}
+} // namespace VDTK
@@ -0,0 +1,16 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Writes MetaImage files with 16 bit little endian voxels (MET_USHORT). .mha files contain the
+// data after the header, for every other extension the data gets written to a .raw file next to
+// the header
+class MetaImageWriter {
+public:
+    MetaImageWriter();
+    ~MetaImageWriter();
+
+    static bool write(const std::filesystem::path& filePath, const VolumeData& volume,
+                      const std::size_t numberOfThreads);
+};
+} // namespace VDTK
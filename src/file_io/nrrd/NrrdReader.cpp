@@ -0,0 +1,224 @@
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "../MappedFile.h"
+#include "NrrdReader.h"
+
+namespace VDTK {
+namespace {
+std::string trim(const std::string& text) {
+    const std::size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// returns the position after the next line break, size if there is none
+std::size_t findNextLine(const char* const data, const std::size_t size,
+                         const std::size_t position) {
+    const char* const lineEnd =
+        static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+    return (lineEnd != nullptr) ? static_cast<std::size_t>(lineEnd - data) + 1 : size;
+}
+} // namespace
+
+NrrdReader::NrrdReader() {}
+
+NrrdReader::~NrrdReader() {}
+
+bool NrrdReader::read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                      const std::size_t numberOfThreads) {
+    MappedFile headerFile;
+    if (!headerFile.open(filePath)) {
+        return false;
+    }
+
+    Header header;
+    std::size_t headerEnd = 0;
+    if (!parseHeader(headerFile.getData(), headerFile.getSize(), &header, &headerEnd)) {
+        return false;
+    }
+
+    if (header.size.size() != header.numberOfDimensions || header.size.size() < 2 ||
+        header.size.size() > 3 || !header.voxelTypeFound || header.encoding != "raw") {
+        // unsupported volume
+        return false;
+    }
+
+    // 2D images are volumes with a single slice
+    header.size.resize(3, 1);
+    header.spacing.resize(3, 1.0f);
+    const VolumeSize size(header.size[0], header.size[1], header.size[2]);
+    const VolumeSpacing spacing(header.spacing[0], header.spacing[1], header.spacing[2]);
+    std::size_t dataSize = 0;
+    if (!RawReader::getDataSize(size, header.voxelType, &dataSize)) {
+        // volume does not fit into memory
+        return false;
+    }
+
+    MappedFile dataFile;
+    const MappedFile* file = &headerFile;
+    std::size_t offset = headerEnd;
+    if (!header.dataFile.empty()) {
+        if (header.dataFile.find(' ') != std::string::npos ||
+            header.dataFile.find('%') != std::string::npos) {
+            // data split into several files
+            return false;
+        }
+
+        const std::filesystem::path dataFilePath = filePath.parent_path() / header.dataFile;
+        if (!dataFile.open(dataFilePath)) {
+            return false;
+        }
+        file = &dataFile;
+        offset = 0;
+    }
+
+    for (std::size_t line = 0; line < header.lineSkip; line++) {
+        offset = findNextLine(file->getData(), file->getSize(), offset);
+    }
+
+    if (header.byteSkip < 0) {
+        offset = (file->getSize() >= dataSize) ? file->getSize() - dataSize : 0;
+    } else {
+        offset += static_cast<std::size_t>(header.byteSkip);
+    }
+    if (offset > file->getSize() || file->getSize() - offset < dataSize) {
+        // Volume dimensions and data size do not fit together
+        return false;
+    }
+
+    return RawReader::readMemory(volumeData, file->getData() + offset, file->getSize() - offset,
+                                 header.voxelType, size, spacing, header.endianness,
+                                 numberOfThreads);
+}
+
+bool NrrdReader::parseHeader(const char* const data, const std::size_t size, Header* const header,
+                             std::size_t* const dataOffset) {
+    if (size < 8 || std::memcmp(data, "NRRD000", 7) != 0) {
+        // no nrrd file
+        return false;
+    }
+
+    std::size_t position = findNextLine(data, size, 0);
+    while (position < size) {
+        const std::size_t nextPosition = findNextLine(data, size, position);
+        const std::string line = trim(std::string(data + position, nextPosition - position));
+        position = nextPosition;
+
+        if (line.empty()) {
+            // end of the header, attached data follows
+            break;
+        }
+
+        // comments and key/value pairs (key:=value) are not needed
+        const std::size_t separator = line.find(": ");
+        if (line[0] == '#' || separator == std::string::npos ||
+            line.find(":=") != std::string::npos) {
+            continue;
+        }
+
+        try {
+            parseField(line.substr(0, separator), trim(line.substr(separator + 2)), header);
+        } catch (const std::logic_error&) {
+            // invalid number
+            return false;
+        }
+    }
+
+    *dataOffset = position;
+    return true;
+}
+
+void NrrdReader::parseField(const std::string& field, const std::string& value,
+                            Header* const header) {
+    if (field == "dimension") {
+        header->numberOfDimensions = std::stoul(value);
+    } else if (field == "type") {
+        header->voxelTypeFound = parseVoxelType(value, &header->voxelType);
+    } else if (field == "sizes") {
+        std::istringstream stream(value);
+        std::size_t size;
+        while (stream >> size) {
+            header->size.push_back(size);
+        }
+    } else if (field == "spacings") {
+        // non spatial axes have "nan" spacing
+        std::istringstream stream(value);
+        std::string spacing;
+        header->spacing.clear();
+        while (stream >> spacing) {
+            const float parsedSpacing = std::stof(spacing);
+            header->spacing.push_back(std::isfinite(parsedSpacing) ? parsedSpacing : 1.0f);
+        }
+    } else if (field == "space directions" && header->spacing.empty()) {
+        header->spacing = parseSpaceDirections(value);
+    } else if (field == "encoding") {
+        header->encoding = value;
+    } else if (field == "endian") {
+        header->endianness = (value == "big") ? Endianness::Big : Endianness::Little;
+    } else if (field == "data file" || field == "datafile") {
+        header->dataFile = value;
+    } else if (field == "line skip" || field == "lineskip") {
+        header->lineSkip = std::stoul(value);
+    } else if (field == "byte skip" || field == "byteskip") {
+        header->byteSkip = std::stoll(value);
+    }
+}
+
+bool NrrdReader::parseVoxelType(const std::string& type, RawVoxelType* const voxelType) {
+    if (type == "uchar" || type == "unsigned char" || type == "uint8" || type == "uint8_t") {
+        *voxelType = RawVoxelType::Unsigned8Bit;
+    } else if (type == "ushort" || type == "unsigned short" || type == "unsigned short int" ||
+               type == "uint16" || type == "uint16_t") {
+        *voxelType = RawVoxelType::Unsigned16Bit;
+    } else if (type == "short" || type == "short int" || type == "signed short" ||
+               type == "signed short int" || type == "int16" || type == "int16_t") {
+        *voxelType = RawVoxelType::Signed16Bit;
+    } else if (type == "float") {
+        *voxelType = RawVoxelType::Float32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::vector<float> NrrdReader::parseSpaceDirections(const std::string& value) {
+    // "(x,y,z) (x,y,z) (x,y,z)", non spatial axes are "none"
+    std::vector<float> spacing;
+    std::size_t position = 0;
+    while (position < value.size()) {
+        const std::size_t vectorStart = value.find_first_not_of(' ', position);
+        if (vectorStart == std::string::npos) {
+            break;
+        }
+
+        if (value[vectorStart] != '(') {
+            spacing.push_back(1.0f);
+            position = value.find(' ', vectorStart);
+            position = (position == std::string::npos) ? value.size() : position;
+            continue;
+        }
+
+        const std::size_t vectorEnd = value.find(')', vectorStart);
+        if (vectorEnd == std::string::npos) {
+            break;
+        }
+
+        std::string components = value.substr(vectorStart + 1, vectorEnd - vectorStart - 1);
+        std::replace(components.begin(), components.end(), ',', ' ');
+        std::istringstream stream(components);
+        double squaredLength = 0.0;
+        double component;
+        while (stream >> component) {
+            squaredLength += component * component;
+        }
+        spacing.push_back(static_cast<float>(std::sqrt(squaredLength)));
+        position = vectorEnd + 1;
+    }
+    return spacing;
+}
+} // namespace VDTK
@@ -0,0 +1,43 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+#include "../raw/RawReader.h"
+
+namespace VDTK {
+// Reads NRRD files, either .nrrd with the data after the header or .nhdr with detached data
+// ("data file"). The data gets mapped into memory instead of being read into a buffer.
+// Supported types: uint8, uint16, int16 and float with raw encoding. Spacing is taken from
+// "spacings" or from the length of the "space directions"
+class NrrdReader {
+public:
+    NrrdReader();
+    ~NrrdReader();
+
+    static bool read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                     const std::size_t numberOfThreads);
+
+private:
+    struct Header {
+        std::size_t numberOfDimensions = 0;
+        std::vector<std::size_t> size;
+        std::vector<float> spacing;
+        RawVoxelType voxelType = RawVoxelType::Unsigned16Bit;
+        bool voxelTypeFound = false;
+        Endianness endianness = Endianness::Little;
+        std::string encoding = "raw";
+        std::string dataFile;
+        std::size_t lineSkip = 0;
+        // -1: data is at the end of the file
+        long long byteSkip = 0;
+    };
+
+    // dataOffset is the position after the empty line that ends the header
+    static bool parseHeader(const char* const data, const std::size_t size, Header* const header,
+                            std::size_t* const dataOffset);
+    // throws std::logic_error for invalid numbers
+    static void parseField(const std::string& field, const std::string& value,
+                           Header* const header);
+    static bool parseVoxelType(const std::string& type, RawVoxelType* const voxelType);
+    static std::vector<float> parseSpaceDirections(const std::string& value);
+};
+} // namespace VDTK
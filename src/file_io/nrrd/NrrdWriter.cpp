@@ -0,0 +1,52 @@
+
+#include <limits>
+#include <sstream>
+
+#include "../raw/RawWriter.h"
+#include "NrrdWriter.h"
+
+namespace VDTK {
+NrrdWriter::NrrdWriter() {}
+
+NrrdWriter::~NrrdWriter() {}
+
+bool NrrdWriter::write(const std::filesystem::path& filePath, const VolumeData& volume,
+                       const std::size_t numberOfThreads) {
+    const bool detachedData = filePath.extension() == ".nhdr";
+    std::filesystem::path dataFilePath = filePath;
+    dataFilePath.replace_extension("raw");
+
+    const VolumeSize size = volume.getSize();
+    const VolumeSpacing spacing = volume.getSpacing();
+    std::ostringstream header;
+    header.precision(std::numeric_limits<float>::max_digits10);
+    header << "NRRD0004\n"
+           << "# Complete NRRD file format specification at:\n"
+           << "# http://teem.sourceforge.net/nrrd/format.html\n"
+           << "type: uint16\n"
+           << "dimension: 3\n"
+           << "sizes: " << size.getX() << " " << size.getY() << " " << size.getZ() << "\n"
+           << "spacings: " << spacing.getX() << " " << spacing.getY() << " " << spacing.getZ()
+           << "\n"
+           << "endian: little\n"
+           << "encoding: raw\n";
+    if (detachedData) {
+        header << "data file: " << dataFilePath.filename().string() << "\n";
+    }
+    // an empty line ends the header
+    header << "\n";
+
+    if (!detachedData) {
+        return RawWriter::writeWithHeader(filePath, header.str(), volume, numberOfThreads);
+    }
+
+    std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (file.fail() || !file.write(header.str().data(), header.str().size())) {
+        // unable to write file
+        return false;
+    }
+    file.close();
+
+    return RawWriter::write(dataFilePath, 16, volume, false, numberOfThreads);
+}
+} // namespace VDTK
@@ -0,0 +1,15 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Writes NRRD files with 16 bit little endian voxels and raw encoding. .nhdr headers get the data
+// in a .raw file next to them, every other extension contains the data after the header
+class NrrdWriter {
+public:
+    NrrdWriter();
+    ~NrrdWriter();
+
+    static bool write(const std::filesystem::path& filePath, const VolumeData& volume,
+                      const std::size_t numberOfThreads);
+};
+} // namespace VDTK
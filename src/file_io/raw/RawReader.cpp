@@ -1,5 +1,16 @@
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <threadpool/ThreadPool.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../VoxelConverter.h"
 #include "RawReader.h"
 
 namespace VDTK {
@@ -9,71 +20,565 @@ RawReader::~RawReader() {}
 
 bool RawReader::read(VolumeData* const volumeData, const std::filesystem::path& filePath,
                      const uint8_t bitsPerVoxel, const VDTK::VolumeSize volumeSize,
-                     const VDTK::VolumeSpacing volumeSpacing) {
-    if (!std::filesystem::exists(filePath)) {
-        // Input Raw file does not exist
+                     const VDTK::VolumeSpacing volumeSpacing, const Endianness endianness,
+                     const std::size_t numberOfThreads) {
+    if (bitsPerVoxel != 8 && bitsPerVoxel != 12 && bitsPerVoxel != 16) {
+        // unsupported voxel format
         return false;
     }
 
-    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
-    std::size_t fileSize = 0;
+    VolumeData volume(volumeSize, volumeSpacing);
 
-    try {
-        fileSize = std::filesystem::file_size(filePath);
-    } catch (std::filesystem::filesystem_error& e) {
-        std::cout << e.what() << std::endl;
+    // fileSize is given in bytes, but voxel data can be 12 bit for example
+    const std::size_t fileSize = VoxelConverter::getByteCount(volume.getVoxelCount(), bitsPerVoxel);
+    std::ifstream file;
+    if (!openFile(&file, filePath, fileSize)) {
         return false;
     }
 
-    if (!file.is_open()) {
-        // unable to open file
+    uint16_t* const destination = volume.getRawVolumeData().data();
+    bool success = false;
+    if (bitsPerVoxel == 16) {
+        // 16 bit voxels are read in place, the byte swap follows while the chunk is cached
+        const bool nativeEndianness = VoxelConverter::isNativeEndianness(endianness);
+        success = readChunks(&file, reinterpret_cast<char*>(destination), volume.getVoxelCount(),
+                             bitsPerVoxel, numberOfThreads,
+                             [&](const char* const, const std::size_t firstVoxel,
+                                 const std::size_t voxelCount) {
+                                 if (!nativeEndianness) {
+                                     VoxelConverter::swapBytes(destination + firstVoxel,
+                                                               voxelCount);
+                                 }
+                             });
+    } else {
+        success = readChunks(&file, nullptr, volume.getVoxelCount(), bitsPerVoxel,
+                             numberOfThreads,
+                             [&](const char* const source, const std::size_t firstVoxel,
+                                 const std::size_t voxelCount) {
+                                 VoxelConverter::convertTo16Bit(source, bitsPerVoxel, endianness,
+                                                                destination + firstVoxel,
+                                                                voxelCount);
+                             });
+    }
+
+    if (!success) {
+        // Unable to read file
         return false;
     }
 
+    *volumeData = std::move(volume);
+    return true;
+}
+
+bool RawReader::readSigned16Bit(VolumeData* const volumeData,
+                                const std::filesystem::path& filePath,
+                                const VDTK::VolumeSize volumeSize,
+                                const VDTK::VolumeSpacing volumeSpacing, const float slope,
+                                const float intercept, const Endianness endianness,
+                                const std::size_t numberOfThreads) {
     VolumeData volume(volumeSize, volumeSpacing);
 
-    // fileSize is given in bytes, but voxel data can be 12 bit for example.
-    // Therefore we have to calculate the total bits of the file before and then
-    // convert then to bytes by dividing with 8
-    if (fileSize != (volume.getVoxelCount() * bitsPerVoxel) / 8) {
-        // Volume dimensions and filesize do not fit together
+    std::ifstream file;
+    if (!openFile(&file, filePath, volume.getVoxelCount() * sizeof(int16_t))) {
+        return false;
+    }
+
+    // signed and unsigned voxels have the same size, so they get converted in place
+    uint16_t* const destination = volume.getRawVolumeData().data();
+    if (!readChunks(&file, reinterpret_cast<char*>(destination), volume.getVoxelCount(), 16,
+                    numberOfThreads,
+                    [&](const char* const source, const std::size_t firstVoxel,
+                        const std::size_t voxelCount) {
+                        VoxelConverter::convertSigned16BitTo16Bit(source, endianness, slope,
+                                                                  intercept,
+                                                                  destination + firstVoxel,
+                                                                  voxelCount);
+                    })) {
+        // Unable to read file
+        return false;
+    }
+
+    *volumeData = std::move(volume);
+    return true;
+}
+
+bool RawReader::readFloat32(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                            const VDTK::VolumeSize volumeSize,
+                            const VDTK::VolumeSpacing volumeSpacing, const float minimum,
+                            const float maximum, const Endianness endianness,
+                            const std::size_t numberOfThreads) {
+    VolumeData volume(volumeSize, volumeSpacing);
+
+    const std::size_t fileSize = volume.getVoxelCount() * sizeof(float);
+    std::ifstream file;
+    if (!openFile(&file, filePath, fileSize)) {
+        return false;
+    }
+
+    uint16_t* const destination = volume.getRawVolumeData().data();
+    const ChunkTask convert = [&](const char* const source, const std::size_t firstVoxel,
+                                  const std::size_t voxelCount) {
+        VoxelConverter::convertFloat32To16Bit(source, endianness, minimum, maximum,
+                                              destination + firstVoxel, voxelCount);
+    };
+
+    if (minimum < maximum) {
+        if (!readChunks(&file, nullptr, volume.getVoxelCount(), 32, numberOfThreads, convert)) {
+            // Unable to read file
+            return false;
+        }
+        *volumeData = std::move(volume);
+        return true;
+    }
+
+    // the range gets determined while reading, the conversion reads the file a second time
+    const std::size_t numberOfChunks =
+        (volume.getVoxelCount() + m_chunkVoxelCount - 1) / m_chunkVoxelCount;
+    std::vector<float> chunkMinimums(numberOfChunks, std::numeric_limits<float>::max());
+    std::vector<float> chunkMaximums(numberOfChunks, std::numeric_limits<float>::lowest());
+    if (!readChunks(&file, nullptr, volume.getVoxelCount(), 32, numberOfThreads,
+                    [&](const char* const source, const std::size_t firstVoxel,
+                        const std::size_t voxelCount) {
+                        const std::size_t chunk = firstVoxel / m_chunkVoxelCount;
+                        VoxelConverter::findFloat32Range(source, endianness, voxelCount,
+                                                         &chunkMinimums[chunk],
+                                                         &chunkMaximums[chunk]);
+                    })) {
+        // Unable to read file
         return false;
     }
 
+    const float fileMinimum = *std::min_element(chunkMinimums.begin(), chunkMinimums.end());
+    const float fileMaximum = *std::max_element(chunkMaximums.begin(), chunkMaximums.end());
+    file.clear();
     file.seekg(0, std::ios::beg);
-    std::vector<char> buffer(fileSize);
-    if (!file.read(buffer.data(), fileSize)) {
+    if (!readChunks(&file, nullptr, volume.getVoxelCount(), 32, numberOfThreads,
+                    [&](const char* const source, const std::size_t firstVoxel,
+                        const std::size_t voxelCount) {
+                        VoxelConverter::convertFloat32To16Bit(source, endianness, fileMinimum,
+                                                              fileMaximum,
+                                                              destination + firstVoxel,
+                                                              voxelCount);
+                    })) {
         // Unable to read file
         return false;
     }
 
-    volume.setRawVolumeData(convertTo16Bit(buffer, bitsPerVoxel, volume.getVoxelCount()));
-    *volumeData = volume;
+    *volumeData = std::move(volume);
     return true;
 }
 
-const std::vector<uint16_t> RawReader::convertTo16Bit(std::vector<char>& data,
-                                                      const uint8_t bitsPerVoxel,
-                                                      const uint64_t voxelCount) {
-    std::vector<uint16_t> convertedData(voxelCount);
+bool RawReader::readMemory(VolumeData* const volumeData, const char* const data,
+                           const std::size_t dataSize, const RawVoxelType voxelType,
+                           const VDTK::VolumeSize volumeSize,
+                           const VDTK::VolumeSpacing volumeSpacing, const Endianness endianness,
+                           const std::size_t numberOfThreads) {
+    // checked before the volume gets allocated, the size can come from a crafted header
+    std::size_t expectedDataSize = 0;
+    if (!getDataSize(volumeSize, voxelType, &expectedDataSize) || dataSize < expectedDataSize) {
+        // Volume dimensions and data size do not fit together
+        return false;
+    }
 
-    switch (bitsPerVoxel) {
-    case 8: {
-        std::transform(data.begin(), data.end(), convertedData.begin(),
-                       [](char in) -> uint16_t { return static_cast<uint16_t>(in) * UINT8_MAX; });
+    VolumeData volume(volumeSize, volumeSpacing);
+    const uint8_t bitsPerVoxel = getBitsPerVoxel(voxelType);
+
+    uint16_t* const destination = volume.getRawVolumeData().data();
+    switch (voxelType) {
+    case RawVoxelType::Unsigned8Bit:
+    case RawVoxelType::Unsigned16Bit: {
+        processChunks(data, volume.getVoxelCount(), bitsPerVoxel, numberOfThreads,
+                      [&](const char* const source, const std::size_t firstVoxel,
+                          const std::size_t voxelCount) {
+                          VoxelConverter::convertTo16Bit(source, bitsPerVoxel, endianness,
+                                                         destination + firstVoxel, voxelCount);
+                      });
         break;
     }
-    case 16: {
-        std::copy(reinterpret_cast<const uint16_t* const>(&data[0]),
-                  reinterpret_cast<const uint16_t* const>(&data[0]) + voxelCount,
-                  convertedData.begin());
+    case RawVoxelType::Signed16Bit: {
+        processChunks(data, volume.getVoxelCount(), bitsPerVoxel, numberOfThreads,
+                      [&](const char* const source, const std::size_t firstVoxel,
+                          const std::size_t voxelCount) {
+                          VoxelConverter::convertSigned16BitTo16Bit(source, endianness, 1.0f, 0.0f,
+                                                                    destination + firstVoxel,
+                                                                    voxelCount);
+                      });
         break;
     }
-    default:
+    case RawVoxelType::Float32: {
+        const std::size_t numberOfChunks =
+            (volume.getVoxelCount() + m_chunkVoxelCount - 1) / m_chunkVoxelCount;
+        std::vector<float> chunkMinimums(numberOfChunks, std::numeric_limits<float>::max());
+        std::vector<float> chunkMaximums(numberOfChunks, std::numeric_limits<float>::lowest());
+        processChunks(data, volume.getVoxelCount(), bitsPerVoxel, numberOfThreads,
+                      [&](const char* const source, const std::size_t firstVoxel,
+                          const std::size_t voxelCount) {
+                          const std::size_t chunk = firstVoxel / m_chunkVoxelCount;
+                          VoxelConverter::findFloat32Range(source, endianness, voxelCount,
+                                                           &chunkMinimums[chunk],
+                                                           &chunkMaximums[chunk]);
+                      });
+
+        const float minimum = *std::min_element(chunkMinimums.begin(), chunkMinimums.end());
+        const float maximum = *std::max_element(chunkMaximums.begin(), chunkMaximums.end());
+        processChunks(data, volume.getVoxelCount(), bitsPerVoxel, numberOfThreads,
+                      [&](const char* const source, const std::size_t firstVoxel,
+                          const std::size_t voxelCount) {
+                          VoxelConverter::convertFloat32To16Bit(source, endianness, minimum,
+                                                                maximum, destination + firstVoxel,
+                                                                voxelCount);
+                      });
         break;
     }
+    default: { return false; }
+    }
 
-    return convertedData;
+    *volumeData = std::move(volume);
+    return true;
 }
 
-} // namespace VDTK
\ No newline at end of file
+uint8_t RawReader::getBitsPerVoxel(const RawVoxelType voxelType) {
+    switch (voxelType) {
+    case RawVoxelType::Unsigned8Bit: {
+        return 8;
+    }
+    case RawVoxelType::Float32: {
+        return 32;
+    }
+    default: { return 16; }
+    }
+}
+
+bool RawReader::getDataSize(const VDTK::VolumeSize& volumeSize, const RawVoxelType voxelType,
+                            std::size_t* const dataSize) {
+    // every factor is checked before multiplying, so the product can not overflow
+    std::size_t product = getBitsPerVoxel(voxelType) / 8;
+    for (const std::size_t factor : {volumeSize.getX(), volumeSize.getY(), volumeSize.getZ()}) {
+        if (factor != 0 && product > SIZE_MAX / factor) {
+            return false;
+        }
+        product *= factor;
+    }
+    *dataSize = product;
+    return true;
+}
+
+bool RawReader::readRegion(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                           const uint8_t bitsPerVoxel, const VDTK::VolumeSize fileVolumeSize,
+                           const VDTK::VolumeSpacing volumeSpacing,
+                           const VDTK::VolumeSize regionOffset, const VDTK::VolumeSize regionSize,
+                           const VDTK::VolumeSize stride, const Endianness endianness,
+                           const std::size_t numberOfThreads) {
+    if (bitsPerVoxel != 8 && bitsPerVoxel != 12 && bitsPerVoxel != 16) {
+        // unsupported voxel format
+        return false;
+    }
+
+    if (stride.getX() == 0 || stride.getY() == 0 || stride.getZ() == 0 ||
+        regionSize.getX() == 0 || regionSize.getY() == 0 || regionSize.getZ() == 0 ||
+        regionOffset.getX() + regionSize.getX() > fileVolumeSize.getX() ||
+        regionOffset.getY() + regionSize.getY() > fileVolumeSize.getY() ||
+        regionOffset.getZ() + regionSize.getZ() > fileVolumeSize.getZ()) {
+        // region is not inside of the volume
+        return false;
+    }
+
+    std::size_t fileSize = 0;
+    try {
+        fileSize = std::filesystem::file_size(filePath);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    const std::size_t fileVoxelCount =
+        fileVolumeSize.getX() * fileVolumeSize.getY() * fileVolumeSize.getZ();
+    if (fileSize != VoxelConverter::getByteCount(fileVoxelCount, bitsPerVoxel)) {
+        // Volume dimensions and filesize do not fit together
+        return false;
+    }
+
+    const VolumeSize size((regionSize.getX() + stride.getX() - 1) / stride.getX(),
+                          (regionSize.getY() + stride.getY() - 1) / stride.getY(),
+                          (regionSize.getZ() + stride.getZ() - 1) / stride.getZ());
+    const VolumeSpacing spacing(volumeSpacing.getX() * stride.getX(),
+                                volumeSpacing.getY() * stride.getY(),
+                                volumeSpacing.getZ() * stride.getZ());
+    VolumeData volume(size, spacing);
+    std::atomic<bool> success = true;
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t z = 0; z < size.getZ(); z++) {
+            threadPool.enqueue([&, z]() {
+                if (success && !readRegionSlice(&volume, filePath, bitsPerVoxel, fileVolumeSize,
+                                                regionOffset, stride, endianness, z)) {
+                    success = false;
+                }
+            });
+        }
+    }
+
+    if (!success) {
+        // Unable to read file
+        return false;
+    }
+
+    *volumeData = std::move(volume);
+    return true;
+}
+
+bool RawReader::readRegionSlice(VolumeData* const volume, const std::filesystem::path& filePath,
+                                const uint8_t bitsPerVoxel, const VDTK::VolumeSize fileVolumeSize,
+                                const VDTK::VolumeSize regionOffset,
+                                const VDTK::VolumeSize stride, const Endianness endianness,
+                                const std::size_t sliceIndex) {
+    const VolumeSize size = volume->getSize();
+    const std::size_t fileZ = regionOffset.getZ() + sliceIndex * stride.getZ();
+    // a run covers all voxels of one row between the first and the last needed voxel
+    const std::size_t runLength = (size.getX() - 1) * stride.getX() + 1;
+    const auto getRunStart = [&](const std::size_t y) {
+        const std::size_t fileY = regionOffset.getY() + y * stride.getY();
+        return regionOffset.getX() +
+               fileVolumeSize.getX() * (fileY + fileVolumeSize.getY() * fileZ);
+    };
+
+    // runs are read as a whole if the skipped voxels in between are small enough, otherwise
+    // every voxel is read on its own (merged with its neighbours if they are close)
+    const bool readWholeRuns =
+        VoxelConverter::getByteCount(stride.getX(), bitsPerVoxel) <= m_coalescingGap;
+
+    std::vector<ByteRange> ranges;
+    for (std::size_t y = 0; y < size.getY(); y++) {
+        const std::size_t runStart = getRunStart(y);
+        if (readWholeRuns) {
+            addByteRange(&ranges, runStart, runStart + runLength, bitsPerVoxel);
+        } else {
+            for (std::size_t x = 0; x < size.getX(); x++) {
+                addByteRange(&ranges, runStart + x * stride.getX(),
+                             runStart + x * stride.getX() + 1, bitsPerVoxel);
+            }
+        }
+    }
+
+    // every worker thread keeps its read buffer, so reading a region does not allocate after the
+    // first slice
+    thread_local std::vector<char> buffer;
+    buffer.resize(ranges.back().bufferOffset + ranges.back().last - ranges.back().first);
+    if (!readByteRanges(filePath, ranges, buffer.data())) {
+        return false;
+    }
+
+    // voxels are visited in file order, so the range of a voxel is the current one or a later one
+    const bool swap = !VoxelConverter::isNativeEndianness(endianness);
+    std::vector<ByteRange>::const_iterator range = ranges.cbegin();
+    uint16_t* destination =
+        volume->getRawVolumeData().data() + sliceIndex * size.getX() * size.getY();
+    for (std::size_t y = 0; y < size.getY(); y++) {
+        const std::size_t runStart = getRunStart(y);
+        const std::size_t runFirstByte = (runStart * bitsPerVoxel) / 8;
+        while (runFirstByte >= range->last) {
+            range++;
+        }
+        const char* const run = buffer.data() + range->bufferOffset + runFirstByte - range->first;
+
+        if (stride.getX() == 1 && (bitsPerVoxel != 12 || runStart % 2 == 0)) {
+            VoxelConverter::convertTo16Bit(run, bitsPerVoxel, endianness, destination,
+                                           size.getX());
+            destination += size.getX();
+            continue;
+        }
+
+        for (std::size_t x = 0; x < size.getX(); x++) {
+            const std::size_t voxel = runStart + x * stride.getX();
+            const std::size_t voxelFirstByte = (voxel * bitsPerVoxel) / 8;
+            while (voxelFirstByte >= range->last) {
+                range++;
+            }
+            const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(
+                buffer.data() + range->bufferOffset + voxelFirstByte - range->first);
+
+            switch (bitsPerVoxel) {
+            case 8: {
+                *destination = static_cast<uint16_t>(bytes[0]) * UINT8_MAX;
+                break;
+            }
+            case 12: {
+                // packed voxels, even voxels start at a whole byte
+                const uint16_t value = (voxel % 2 == 0) ? (bytes[0] | ((bytes[1] & 0xF) << 8))
+                                                        : ((bytes[0] >> 4) | (bytes[1] << 4));
+                *destination = static_cast<uint16_t>((value << 4) | (value >> 8));
+                break;
+            }
+            default: {
+                uint16_t value;
+                std::memcpy(&value, bytes, sizeof(uint16_t));
+                *destination = swap ? static_cast<uint16_t>((value << 8) | (value >> 8)) : value;
+                break;
+            }
+            }
+            destination++;
+        }
+    }
+    return true;
+}
+
+void RawReader::addByteRange(std::vector<ByteRange>* const ranges, const std::size_t firstVoxel,
+                             const std::size_t lastVoxel, const uint8_t bitsPerVoxel) {
+    const std::size_t first = (firstVoxel * bitsPerVoxel) / 8;
+    const std::size_t last = VoxelConverter::getByteCount(lastVoxel, bitsPerVoxel);
+
+    if (!ranges->empty() && first <= ranges->back().last + m_coalescingGap) {
+        ranges->back().last = std::max(ranges->back().last, last);
+        return;
+    }
+
+    ByteRange range;
+    range.first = first;
+    range.last = last;
+    if (!ranges->empty()) {
+        range.bufferOffset =
+            ranges->back().bufferOffset + ranges->back().last - ranges->back().first;
+    }
+    ranges->push_back(range);
+}
+
+bool RawReader::readByteRanges(const std::filesystem::path& filePath,
+                               const std::vector<ByteRange>& ranges, char* const buffer) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        // unable to open file
+        return false;
+    }
+
+    bool success = true;
+    for (const ByteRange& range : ranges) {
+        std::size_t bytesRead = 0;
+        while (success && bytesRead < range.last - range.first) {
+            const ssize_t result =
+                pread(fileDescriptor, buffer + range.bufferOffset + bytesRead,
+                      range.last - range.first - bytesRead,
+                      static_cast<off_t>(range.first + bytesRead));
+            success = result > 0;
+            bytesRead += success ? static_cast<std::size_t>(result) : 0;
+        }
+    }
+
+    close(fileDescriptor);
+    return success;
+#else
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        // unable to open file
+        return false;
+    }
+
+    for (const ByteRange& range : ranges) {
+        file.seekg(range.first, std::ios::beg);
+        if (!file.read(buffer + range.bufferOffset, range.last - range.first)) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+bool RawReader::openFile(std::ifstream* const file, const std::filesystem::path& filePath,
+                         const std::size_t expectedFileSize) {
+    if (!std::filesystem::exists(filePath)) {
+        // Input Raw file does not exist
+        return false;
+    }
+
+    std::size_t fileSize = 0;
+    try {
+        fileSize = std::filesystem::file_size(filePath);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    if (fileSize != expectedFileSize) {
+        // Volume dimensions and filesize do not fit together
+        return false;
+    }
+
+    file->open(filePath, std::ios::binary);
+    if (!file->is_open()) {
+        // unable to open file
+        return false;
+    }
+    return true;
+}
+
+bool RawReader::readChunks(std::ifstream* const file, char* const buffer,
+                           const std::size_t voxelCount, const uint8_t bitsPerVoxel,
+                           const std::size_t numberOfThreads, const ChunkTask& task) {
+    // without a buffer of the whole file a few chunk sized buffers get reused, a buffer is read
+    // again as soon as the task of its previous chunk has finished
+    const std::size_t slotCount =
+        (buffer == nullptr) ? 2 * std::max<std::size_t>(numberOfThreads, 1) : 0;
+    std::vector<std::vector<char>> slots(slotCount);
+    std::vector<std::future<void>> slotTasks(slotCount);
+
+    bool success = true;
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t firstVoxel = 0; firstVoxel < voxelCount; firstVoxel += m_chunkVoxelCount) {
+            const std::size_t chunkVoxelCount =
+                std::min(m_chunkVoxelCount, voxelCount - firstVoxel);
+            const std::size_t firstByte = VoxelConverter::getByteCount(firstVoxel, bitsPerVoxel);
+            const std::size_t chunkSize =
+                VoxelConverter::getByteCount(firstVoxel + chunkVoxelCount, bitsPerVoxel) -
+                firstByte;
+
+            char* chunk = buffer + firstByte;
+            std::future<void>* slotTask = nullptr;
+            if (buffer == nullptr) {
+                const std::size_t slot = (firstVoxel / m_chunkVoxelCount) % slotCount;
+                slotTask = &slotTasks[slot];
+                if (slotTask->valid()) {
+                    slotTask->wait();
+                }
+                slots[slot].resize(chunkSize);
+                chunk = slots[slot].data();
+            }
+
+            if (!file->read(chunk, chunkSize)) {
+                success = false;
+                break;
+            }
+            std::future<void> result = threadPool.enqueue(
+                [&task, chunk, firstVoxel, chunkVoxelCount]() {
+                    task(chunk, firstVoxel, chunkVoxelCount);
+                });
+            if (slotTask != nullptr) {
+                *slotTask = std::move(result);
+            }
+        }
+    }
+    return success;
+}
+
+void RawReader::processChunks(const char* const buffer, const std::size_t voxelCount,
+                              const uint8_t bitsPerVoxel, const std::size_t numberOfThreads,
+                              const ChunkTask& task) {
+    // destructor of the thread pool waits for all tasks to finish
+    ThreadPool threadPool(numberOfThreads);
+
+    for (std::size_t firstVoxel = 0; firstVoxel < voxelCount; firstVoxel += m_chunkVoxelCount) {
+        const std::size_t chunkVoxelCount = std::min(m_chunkVoxelCount, voxelCount - firstVoxel);
+        const std::size_t firstByte = VoxelConverter::getByteCount(firstVoxel, bitsPerVoxel);
+        threadPool.enqueue([&task, buffer, firstByte, firstVoxel, chunkVoxelCount]() {
+            task(buffer + firstByte, firstVoxel, chunkVoxelCount);
+        });
+    }
+}
+} // namespace VDTK
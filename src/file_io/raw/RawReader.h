@@ -1,20 +1,98 @@
 #pragma once
+#include <functional>
 
 #include "../include/VDTK/common/CommonDataTypes.h"
 
 namespace VDTK {
+// voxel types of formats with a header that describes the data (MetaImage, NRRD)
+enum class RawVoxelType { Unsigned8Bit, Unsigned16Bit, Signed16Bit, Float32 };
+
 class RawReader {
 public:
     RawReader();
     ~RawReader();
 
+    // 8, 12 (packed) or 16 bit unsigned voxels
     static bool read(VolumeData* const volumeData, const std::filesystem::path& filePath,
                      const uint8_t bitsPerVoxel, const VDTK::VolumeSize volumeSize,
-                     const VDTK::VolumeSpacing volumeSpacing);
+                     const VDTK::VolumeSpacing volumeSpacing, const Endianness endianness,
+                     const std::size_t numberOfThreads);
+    // signed 16 bit voxels, rescaled with slope and intercept and stored with an offset of 32768
+    static bool readSigned16Bit(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                                const VDTK::VolumeSize volumeSize,
+                                const VDTK::VolumeSpacing volumeSpacing, const float slope,
+                                const float intercept, const Endianness endianness,
+                                const std::size_t numberOfThreads);
+    // 32 bit float voxels, [minimum, maximum] gets mapped to the whole 16 bit range. If minimum
+    // is not smaller than maximum, the range of the file gets used
+    static bool readFloat32(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                            const VDTK::VolumeSize volumeSize,
+                            const VDTK::VolumeSpacing volumeSpacing, const float minimum,
+                            const float maximum, const Endianness endianness,
+                            const std::size_t numberOfThreads);
+
+    // reads only every stride-th voxel of the box [offset, offset + regionSize) of a volume with
+    // fileVolumeSize, the rest of the file is never touched. 8, 12 (packed) or 16 bit voxels
+    static bool readRegion(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                           const uint8_t bitsPerVoxel, const VDTK::VolumeSize fileVolumeSize,
+                           const VDTK::VolumeSpacing volumeSpacing,
+                           const VDTK::VolumeSize regionOffset,
+                           const VDTK::VolumeSize regionSize, const VDTK::VolumeSize stride,
+                           const Endianness endianness, const std::size_t numberOfThreads);
+
+    // converts voxels that are already in memory (e.g. a mapped file). Signed voxels get an offset
+    // of 32768, the range of float voxels gets mapped to the whole 16 bit range
+    static bool readMemory(VolumeData* const volumeData, const char* const data,
+                           const std::size_t dataSize, const RawVoxelType voxelType,
+                           const VDTK::VolumeSize volumeSize,
+                           const VDTK::VolumeSpacing volumeSpacing, const Endianness endianness,
+                           const std::size_t numberOfThreads);
+    static uint8_t getBitsPerVoxel(const RawVoxelType voxelType);
+    // number of bytes of a volume with voxelType, false if it does not fit into size_t
+    static bool getDataSize(const VDTK::VolumeSize& volumeSize, const RawVoxelType voxelType,
+                            std::size_t* const dataSize);
 
 private:
-    static const std::vector<uint16_t> convertTo16Bit(std::vector<char>& data,
-                                                      const uint8_t bitsPerVoxel,
-                                                      const uint64_t voxelCount);
+    // byte range [first, last) of the file, stored in the read buffer at bufferOffset
+    struct ByteRange {
+        std::size_t first = 0;
+        std::size_t last = 0;
+        std::size_t bufferOffset = 0;
+    };
+
+    // converts the voxels [firstVoxel, firstVoxel + voxelCount) stored at source
+    typedef std::function<void(const char* const source, const std::size_t firstVoxel,
+                               const std::size_t voxelCount)>
+        ChunkTask;
+
+    static bool openFile(std::ifstream* const file, const std::filesystem::path& filePath,
+                         const std::size_t expectedFileSize);
+    // reads the file chunk by chunk into buffer (the whole file) or into a few reused chunk
+    // buffers if buffer is nullptr, every chunk gets processed by the thread pool while the next
+    // one is read
+    static bool readChunks(std::ifstream* const file, char* const buffer,
+                           const std::size_t voxelCount, const uint8_t bitsPerVoxel,
+                           const std::size_t numberOfThreads, const ChunkTask& task);
+    // processes the chunks of an already read buffer in parallel
+    static void processChunks(const char* const buffer, const std::size_t voxelCount,
+                              const uint8_t bitsPerVoxel, const std::size_t numberOfThreads,
+                              const ChunkTask& task);
+
+    // reads one z slice of a region
+    static bool readRegionSlice(VolumeData* const volume, const std::filesystem::path& filePath,
+                                const uint8_t bitsPerVoxel, const VDTK::VolumeSize fileVolumeSize,
+                                const VDTK::VolumeSize regionOffset, const VDTK::VolumeSize stride,
+                                const Endianness endianness, const std::size_t sliceIndex);
+    // appends the bytes of voxels [firstVoxel, lastVoxel) of the file, ranges closer than
+    // m_coalescingGap get merged so they are read with one system call
+    static void addByteRange(std::vector<ByteRange>* const ranges, const std::size_t firstVoxel,
+                             const std::size_t lastVoxel, const uint8_t bitsPerVoxel);
+    static bool readByteRanges(const std::filesystem::path& filePath,
+                               const std::vector<ByteRange>& ranges, char* const buffer);
+
+    // reading a gap of this size is cheaper than another system call
+    static constexpr std::size_t m_coalescingGap = 32 * 1024;
+    // number of voxels of each chunk, even so packed 12 bit chunks start at a whole byte
+    static constexpr std::size_t m_chunkVoxelCount = 256 * 1024;
 };
 } // namespace VDTK
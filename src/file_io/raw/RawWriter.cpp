@@ -1,4 +1,10 @@
 
+#include <cstring>
+#include <future>
+#include <threadpool/ThreadPool.h>
+
+#include "../AsyncFileWriter.h"
+#include "../VoxelConverter.h"
 #include "RawWriter.h"
 
 namespace VDTK {
@@ -6,46 +12,128 @@ RawWriter::RawWriter() {}
 
 RawWriter::~RawWriter() {}
 
-const std::vector<uint8_t> RawWriter::convertTo8Bit(const std::vector<uint16_t>& data,
-                                                    const uint64_t voxelCount) {
-    std::vector<uint8_t> convertedData(voxelCount);
+bool RawWriter::write(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+                      const VolumeData& volume, const bool directIO,
+                      const std::size_t numberOfThreads) {
+    if (bitsPerVoxel != 8 && bitsPerVoxel != 12 && bitsPerVoxel != 16) {
+        // unsupported voxel format
+        return false;
+    }
 
     // volume data in VDTK is always stored as 16 bit
-    const uint16_t* ptr = data.data();
-    for (uint64_t index = 0; index < voxelCount; index++) {
-        convertedData[index] = static_cast<uint8_t>(ptr[index] / UINT8_MAX);
+    const uint16_t* const source = volume.getRawVolumeData().data();
+    if (bitsPerVoxel == 16 && !directIO &&
+        VoxelConverter::isNativeEndianness(Endianness::Little)) {
+        // nothing to convert
+        std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+        if (file.fail() || !file.write(reinterpret_cast<const char*>(source),
+                                       volume.getVoxelCount() * sizeof(uint16_t))) {
+            // unable to write file
+            return false;
+        }
+        return true;
     }
 
-    return convertedData;
+    return writeChunks(filePath, volume.getVoxelCount(), bitsPerVoxel, directIO, numberOfThreads,
+                       [&](char* const destination, const std::size_t firstVoxel,
+                           const std::size_t voxelCount) {
+                           VoxelConverter::convertFrom16Bit(source + firstVoxel, bitsPerVoxel,
+                                                            Endianness::Little, destination,
+                                                            voxelCount);
+                       });
 }
 
-bool RawWriter::write(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
-                      const VolumeData& volume) {
-    std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+bool RawWriter::writeSigned16Bit(const std::filesystem::path& filePath, const VolumeData& volume,
+                                 const float slope, const float intercept, const bool directIO,
+                                 const std::size_t numberOfThreads) {
+    if (slope == 0.0f) {
+        // rescaling can not be inverted
+        return false;
+    }
 
-    if (file.fail()) {
-        // unable to create file
+    const uint16_t* const source = volume.getRawVolumeData().data();
+    return writeChunks(filePath, volume.getVoxelCount(), 16, directIO, numberOfThreads,
+                       [&](char* const destination, const std::size_t firstVoxel,
+                           const std::size_t voxelCount) {
+                           VoxelConverter::convert16BitToSigned16Bit(
+                               source + firstVoxel, Endianness::Little, slope, intercept,
+                               destination, voxelCount);
+                       });
+}
+
+bool RawWriter::writeFloat32(const std::filesystem::path& filePath, const VolumeData& volume,
+                             const float minimum, const float maximum, const bool directIO,
+                             const std::size_t numberOfThreads) {
+    const uint16_t* const source = volume.getRawVolumeData().data();
+    return writeChunks(filePath, volume.getVoxelCount(), 32, directIO, numberOfThreads,
+                       [&](char* const destination, const std::size_t firstVoxel,
+                           const std::size_t voxelCount) {
+                           VoxelConverter::convert16BitToFloat32(source + firstVoxel,
+                                                                 Endianness::Little, minimum,
+                                                                 maximum, destination,
+                                                                 voxelCount);
+                       });
+}
+
+bool RawWriter::writeWithHeader(const std::filesystem::path& filePath, const std::string& header,
+                                const VolumeData& volume, const std::size_t numberOfThreads) {
+    const uint16_t* const source = volume.getRawVolumeData().data();
+    return writeChunks(filePath, volume.getVoxelCount(), 16, false, numberOfThreads,
+                       [&](char* const destination, const std::size_t firstVoxel,
+                           const std::size_t voxelCount) {
+                           VoxelConverter::convertFrom16Bit(source + firstVoxel, 16,
+                                                            Endianness::Little, destination,
+                                                            voxelCount);
+                       },
+                       header);
+}
+
+bool RawWriter::writeChunks(const std::filesystem::path& filePath, const std::size_t voxelCount,
+                            const uint8_t bitsPerVoxel, const bool directIO,
+                            const std::size_t numberOfThreads, const ChunkTask& task,
+                            const std::string& header) {
+    const std::size_t bufferSize = VoxelConverter::getByteCount(m_chunkVoxelCount, bitsPerVoxel);
+    if ((directIO && !header.empty()) || header.size() > bufferSize) {
         return false;
     }
 
-    switch (bitsPerVoxel) {
-    case 8: {
-        const std::vector<uint8_t> volume8Bit =
-            convertTo8Bit(volume.getRawVolumeData(), volume.getVoxelCount());
-        const char* rawVolumeData = reinterpret_cast<const char*>(volume8Bit.data());
-        file.write(rawVolumeData, volume.getVoxelCount() * sizeof(uint8_t));
-        break;
+    AsyncFileWriter file(bufferSize, directIO);
+    if (!file.open(filePath)) {
+        // unable to create file
+        return false;
     }
-    case 16: {
-        const char* rawVolumeData = reinterpret_cast<const char*>(volume.getRawVolumeData().data());
-        file.write(rawVolumeData, volume.getVoxelCount() * sizeof(uint16_t));
-        break;
+
+    if (!header.empty()) {
+        std::memcpy(file.acquireBuffer(), header.data(), header.size());
+        file.submitBuffer(header.size());
     }
-    default:
-        break;
+
+    ThreadPool threadPool(numberOfThreads);
+    std::vector<std::future<void>> results;
+
+    for (std::size_t firstVoxel = 0; firstVoxel < voxelCount; firstVoxel += m_chunkVoxelCount) {
+        const std::size_t chunkVoxelCount = std::min(m_chunkVoxelCount, voxelCount - firstVoxel);
+        char* const buffer = file.acquireBuffer();
+
+        // split the chunk into even parts for all threads, so packed 12 bit parts start at a
+        // whole byte
+        const std::size_t partVoxelCount =
+            ((chunkVoxelCount + numberOfThreads - 1) / numberOfThreads + 1) & ~std::size_t(1);
+        results.clear();
+        for (std::size_t part = 0; part < chunkVoxelCount; part += partVoxelCount) {
+            const std::size_t count = std::min(partVoxelCount, chunkVoxelCount - part);
+            char* const destination = buffer + VoxelConverter::getByteCount(part, bitsPerVoxel);
+            results.push_back(threadPool.enqueue([&task, destination, firstVoxel, part, count]() {
+                task(destination, firstVoxel + part, count);
+            }));
+        }
+        for (std::future<void>& result : results) {
+            result.wait();
+        }
+
+        file.submitBuffer(VoxelConverter::getByteCount(chunkVoxelCount, bitsPerVoxel));
     }
 
-    file.close();
-    return true;
+    return file.close();
 }
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
@@ -1,17 +1,49 @@
 #pragma once
+#include <functional>
+
 #include "../include/VDTK/common/CommonDataTypes.h"
 
 namespace VDTK {
+// Volumes are converted chunk by chunk into a double buffer that gets written on a background
+// thread, so only two chunks of extra memory are needed. Direct I/O bypasses the page cache on
+// Linux if the file system supports it
 class RawWriter {
 public:
     RawWriter();
     ~RawWriter();
 
+    // 8, 12 (packed) or 16 bit unsigned voxels
     static bool write(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
-                      const VolumeData& volume);
+                      const VolumeData& volume, const bool directIO,
+                      const std::size_t numberOfThreads);
+    // inverse of RawReader::readSigned16Bit
+    static bool writeSigned16Bit(const std::filesystem::path& filePath, const VolumeData& volume,
+                                 const float slope, const float intercept, const bool directIO,
+                                 const std::size_t numberOfThreads);
+    // inverse of RawReader::readFloat32, the whole 16 bit range gets mapped to [minimum, maximum]
+    static bool writeFloat32(const std::filesystem::path& filePath, const VolumeData& volume,
+                             const float minimum, const float maximum, const bool directIO,
+                             const std::size_t numberOfThreads);
+
+    // text header followed by 16 bit little endian voxels, for formats with attached data
+    static bool writeWithHeader(const std::filesystem::path& filePath, const std::string& header,
+                                const VolumeData& volume, const std::size_t numberOfThreads);
 
 private:
-    static const std::vector<uint8_t> convertTo8Bit(const std::vector<uint16_t>& data,
-                                                    const uint64_t voxelCount);
+    // converts the voxels [firstVoxel, firstVoxel + voxelCount) of the volume to destination
+    typedef std::function<void(char* const destination, const std::size_t firstVoxel,
+                               const std::size_t voxelCount)>
+        ChunkTask;
+
+    // every chunk gets converted by all threads while the previous chunk is written. A header
+    // gets written in front of the voxels (not with direct I/O)
+    static bool writeChunks(const std::filesystem::path& filePath, const std::size_t voxelCount,
+                            const uint8_t bitsPerVoxel, const bool directIO,
+                            const std::size_t numberOfThreads, const ChunkTask& task,
+                            const std::string& header = std::string());
+
+    // number of voxels of each chunk. Chunks of all formats are a multiple of the direct I/O
+    // alignment and packed 12 bit chunks start at a whole byte
+    static constexpr std::size_t m_chunkVoxelCount = 2 * 1024 * 1024;
 };
 } // namespace VDTK
@@ -0,0 +1,157 @@
+
+#include <cstring>
+
+#include "../VoxelConverter.h"
+#include "BrickCodec.h"
+
+namespace VDTK {
+BrickCodec::BrickCodec() {}
+
+BrickCodec::~BrickCodec() {}
+
+BrickEncoding BrickCodec::encode(const uint16_t* const voxels, const std::size_t voxelCount,
+                                 const Endianness endianness, std::vector<char>* const encoded) {
+    // every worker thread keeps its planes, so encoding does not allocate after the first brick
+    thread_local std::vector<uint8_t> lowPlane;
+    thread_local std::vector<uint8_t> highPlane;
+    lowPlane.resize(voxelCount);
+    highPlane.resize(voxelCount);
+
+    uint16_t previous = 0;
+    for (std::size_t i = 0; i < voxelCount; i++) {
+        const uint16_t delta = static_cast<uint16_t>(voxels[i] - previous);
+        lowPlane[i] = static_cast<uint8_t>(delta & 0xFF);
+        highPlane[i] = static_cast<uint8_t>(delta >> 8);
+        previous = voxels[i];
+    }
+
+    const std::size_t rawSize = voxelCount * sizeof(uint16_t);
+    encoded->clear();
+    encoded->reserve(rawSize);
+    encoded->resize(sizeof(uint32_t));
+    encodePlane(lowPlane.data(), voxelCount, encoded);
+
+    const uint32_t lowPlaneSize = static_cast<uint32_t>(encoded->size() - sizeof(uint32_t));
+    for (std::size_t i = 0; i < sizeof(uint32_t); i++) {
+        (*encoded)[i] = static_cast<char>((lowPlaneSize >> (8 * i)) & 0xFF);
+    }
+
+    if (encoded->size() < rawSize) {
+        encodePlane(highPlane.data(), voxelCount, encoded);
+    }
+
+    if (encoded->size() < rawSize) {
+        return BrickEncoding::DeltaBytePlaneRLE;
+    }
+
+    // not compressible (e.g. noise)
+    encoded->resize(rawSize);
+    VoxelConverter::convertFrom16Bit(voxels, 16, endianness, encoded->data(), voxelCount);
+    return BrickEncoding::Raw;
+}
+
+bool BrickCodec::decode(const char* const encoded, const std::size_t encodedSize,
+                        const BrickEncoding encoding, const Endianness endianness,
+                        uint16_t* const voxels, const std::size_t voxelCount) {
+    if (encoding == BrickEncoding::Raw) {
+        if (encodedSize != voxelCount * sizeof(uint16_t)) {
+            return false;
+        }
+        VoxelConverter::convertTo16Bit(encoded, 16, endianness, voxels, voxelCount);
+        return true;
+    }
+
+    if (encoding != BrickEncoding::DeltaBytePlaneRLE || encodedSize < sizeof(uint32_t)) {
+        return false;
+    }
+
+    std::size_t lowPlaneSize = 0;
+    for (std::size_t i = 0; i < sizeof(uint32_t); i++) {
+        lowPlaneSize |= static_cast<std::size_t>(static_cast<unsigned char>(encoded[i])) << (8 * i);
+    }
+    if (lowPlaneSize > encodedSize - sizeof(uint32_t)) {
+        return false;
+    }
+
+    thread_local std::vector<uint8_t> lowPlane;
+    thread_local std::vector<uint8_t> highPlane;
+    lowPlane.resize(voxelCount);
+    highPlane.resize(voxelCount);
+
+    const char* const lowPlaneSource = encoded + sizeof(uint32_t);
+    if (!decodePlane(lowPlaneSource, lowPlaneSize, lowPlane.data(), voxelCount) ||
+        !decodePlane(lowPlaneSource + lowPlaneSize, encodedSize - sizeof(uint32_t) - lowPlaneSize,
+                     highPlane.data(), voxelCount)) {
+        return false;
+    }
+
+    uint16_t previous = 0;
+    for (std::size_t i = 0; i < voxelCount; i++) {
+        previous = static_cast<uint16_t>(previous + (lowPlane[i] | (highPlane[i] << 8)));
+        voxels[i] = previous;
+    }
+    return true;
+}
+
+void BrickCodec::encodePlane(const uint8_t* const plane, const std::size_t size,
+                             std::vector<char>* const encoded) {
+    std::size_t literalStart = 0;
+    std::size_t i = 0;
+
+    const auto flushLiterals = [&](const std::size_t literalEnd) {
+        while (literalStart < literalEnd) {
+            const std::size_t length = std::min(literalEnd - literalStart, m_maximumLiteralLength);
+            encoded->push_back(static_cast<char>(length - 1));
+            encoded->insert(encoded->end(), plane + literalStart, plane + literalStart + length);
+            literalStart += length;
+        }
+    };
+
+    while (i < size) {
+        std::size_t runLength = 1;
+        while (i + runLength < size && runLength < m_maximumRepeatLength &&
+               plane[i + runLength] == plane[i]) {
+            runLength++;
+        }
+
+        if (runLength < m_minimumRepeatLength) {
+            i += runLength;
+            continue;
+        }
+
+        flushLiterals(i);
+        encoded->push_back(static_cast<char>(runLength + m_repeatBias));
+        encoded->push_back(static_cast<char>(plane[i]));
+        i += runLength;
+        literalStart = i;
+    }
+    flushLiterals(size);
+}
+
+bool BrickCodec::decodePlane(const char* const encoded, const std::size_t encodedSize,
+                             uint8_t* const plane, const std::size_t size) {
+    std::size_t position = 0;
+    std::size_t decoded = 0;
+
+    while (position < encodedSize) {
+        const std::size_t header = static_cast<unsigned char>(encoded[position++]);
+        if (header < m_maximumLiteralLength) {
+            const std::size_t length = header + 1;
+            if (length > encodedSize - position || length > size - decoded) {
+                return false;
+            }
+            std::memcpy(plane + decoded, encoded + position, length);
+            position += length;
+            decoded += length;
+        } else {
+            const std::size_t length = header - m_repeatBias;
+            if (position >= encodedSize || length > size - decoded) {
+                return false;
+            }
+            std::memset(plane + decoded, static_cast<unsigned char>(encoded[position++]), length);
+            decoded += length;
+        }
+    }
+    return decoded == size;
+}
+} // namespace VDTK
@@ -0,0 +1,41 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+#include "VdtkFormat.h"
+
+namespace VDTK {
+// Lossless compression of single bricks, every brick can be decoded on its own.
+// Voxels get replaced by the difference to the previous voxel, so smooth regions become small
+// values. Low and high bytes of the differences are split into two planes and each plane gets
+// run length encoded (PackBits), which mostly compresses the high plane and constant regions.
+// If that does not make the brick smaller, it gets stored raw
+//
+// DeltaBytePlaneRLE layout: uint32 (little endian) size of the encoded low plane, encoded low
+// plane, encoded high plane
+class BrickCodec {
+public:
+    BrickCodec();
+    ~BrickCodec();
+
+    // raw bricks are stored with the given byte order
+    static BrickEncoding encode(const uint16_t* const voxels, const std::size_t voxelCount,
+                                const Endianness endianness, std::vector<char>* const encoded);
+    // fails if the encoded data does not decode to exactly voxelCount voxels
+    static bool decode(const char* const encoded, const std::size_t encodedSize,
+                       const BrickEncoding encoding, const Endianness endianness,
+                       uint16_t* const voxels, const std::size_t voxelCount);
+
+private:
+    static void encodePlane(const uint8_t* const plane, const std::size_t size,
+                            std::vector<char>* const encoded);
+    static bool decodePlane(const char* const encoded, const std::size_t encodedSize,
+                            uint8_t* const plane, const std::size_t size);
+
+    // PackBits: header h < 128 copies h + 1 literal bytes, otherwise the next byte gets repeated
+    // h - m_repeatBias times
+    static constexpr std::size_t m_maximumLiteralLength = 128;
+    static constexpr std::size_t m_minimumRepeatLength = 3;
+    static constexpr std::size_t m_repeatBias = 125;
+    static constexpr std::size_t m_maximumRepeatLength = 255 - m_repeatBias;
+};
+} // namespace VDTK
@@ -0,0 +1,138 @@
+
+#include <cstring>
+
+#include "VdtkFormat.h"
+
+namespace VDTK {
+namespace {
+template <typename T>
+void storeLittleEndian(const T value, char* const destination) {
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        destination[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+T loadLittleEndian(const char* const source) {
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<unsigned char>(source[i])) << (8 * i);
+    }
+    return value;
+}
+
+void storeFloat(const float value, char* const destination) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    storeLittleEndian<uint32_t>(bits, destination);
+}
+
+float loadFloat(const char* const source) {
+    const uint32_t bits = loadLittleEndian<uint32_t>(source);
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+std::size_t divideRoundingUp(const std::size_t dividend, const std::size_t divisor) {
+    return (dividend + divisor - 1) / divisor;
+}
+
+// checks every factor before multiplying, so values of a crafted header can not overflow
+bool isVoxelCountAtMost(const VolumeSize& size, const std::size_t maximum) {
+    if (size.getX() == 0 || size.getY() == 0 || size.getZ() == 0) {
+        return true;
+    }
+    return size.getX() <= maximum && size.getY() <= maximum / size.getX() &&
+           size.getZ() <= maximum / (size.getX() * size.getY());
+}
+} // namespace
+
+VdtkFormat::VdtkFormat() {}
+
+VdtkFormat::~VdtkFormat() {}
+
+void VdtkFormat::writeHeader(const VdtkHeader& header, char* const destination) {
+    std::memset(destination, 0, m_headerSize);
+    std::memcpy(destination, "VDTK", 4);
+    storeLittleEndian<uint16_t>(m_version, destination + 4);
+    destination[6] = 16;
+    destination[7] = (header.endianness == Endianness::Little) ? 0 : 1;
+
+    storeLittleEndian<uint64_t>(header.size.getX(), destination + 8);
+    storeLittleEndian<uint64_t>(header.size.getY(), destination + 16);
+    storeLittleEndian<uint64_t>(header.size.getZ(), destination + 24);
+
+    storeFloat(header.spacing.getX(), destination + 32);
+    storeFloat(header.spacing.getY(), destination + 36);
+    storeFloat(header.spacing.getZ(), destination + 40);
+
+    storeLittleEndian<uint32_t>(static_cast<uint32_t>(header.brickSize.getX()), destination + 44);
+    storeLittleEndian<uint32_t>(static_cast<uint32_t>(header.brickSize.getY()), destination + 48);
+    storeLittleEndian<uint32_t>(static_cast<uint32_t>(header.brickSize.getZ()), destination + 52);
+}
+
+bool VdtkFormat::readHeader(const char* const source, VdtkHeader* const header) {
+    if (std::memcmp(source, "VDTK", 4) != 0 ||
+        loadLittleEndian<uint16_t>(source + 4) != m_version || source[6] != 16 ||
+        (source[7] != 0 && source[7] != 1)) {
+        // no vdtk file or unsupported version
+        return false;
+    }
+
+    header->endianness = (source[7] == 0) ? Endianness::Little : Endianness::Big;
+    header->size = VolumeSize(loadLittleEndian<uint64_t>(source + 8),
+                              loadLittleEndian<uint64_t>(source + 16),
+                              loadLittleEndian<uint64_t>(source + 24));
+    header->spacing =
+        VolumeSpacing(loadFloat(source + 32), loadFloat(source + 36), loadFloat(source + 40));
+    header->brickSize = VolumeSize(loadLittleEndian<uint32_t>(source + 44),
+                                   loadLittleEndian<uint32_t>(source + 48),
+                                   loadLittleEndian<uint32_t>(source + 52));
+
+    // a brick has to fit into the 32 bit stored size, the volume into memory
+    return header->brickSize.getX() > 0 && header->brickSize.getY() > 0 &&
+           header->brickSize.getZ() > 0 &&
+           isVoxelCountAtMost(header->brickSize, UINT32_MAX / sizeof(uint16_t)) &&
+           isVoxelCountAtMost(header->size, SIZE_MAX / sizeof(uint16_t));
+}
+
+void VdtkFormat::writeIndexEntry(const BrickIndexEntry& entry, char* const destination) {
+    std::memset(destination, 0, m_indexEntrySize);
+    storeLittleEndian<uint64_t>(entry.offset, destination);
+    storeLittleEndian<uint32_t>(entry.storedSize, destination + 8);
+    destination[12] = static_cast<char>(entry.encoding);
+}
+
+bool VdtkFormat::readIndexEntry(const char* const source, BrickIndexEntry* const entry) {
+    entry->offset = loadLittleEndian<uint64_t>(source);
+    entry->storedSize = loadLittleEndian<uint32_t>(source + 8);
+    entry->encoding = static_cast<BrickEncoding>(source[12]);
+    return entry->encoding == BrickEncoding::Raw ||
+           entry->encoding == BrickEncoding::DeltaBytePlaneRLE;
+}
+
+VolumeSize VdtkFormat::getBrickGridSize(const VdtkHeader& header) {
+    return VolumeSize(divideRoundingUp(header.size.getX(), header.brickSize.getX()),
+                      divideRoundingUp(header.size.getY(), header.brickSize.getY()),
+                      divideRoundingUp(header.size.getZ(), header.brickSize.getZ()));
+}
+
+std::size_t VdtkFormat::getBrickCount(const VdtkHeader& header) {
+    const VolumeSize gridSize = getBrickGridSize(header);
+    return gridSize.getX() * gridSize.getY() * gridSize.getZ();
+}
+
+void VdtkFormat::getBrickBox(const VdtkHeader& header, const std::size_t brickIndex,
+                             VolumeSize* const offset, VolumeSize* const size) {
+    const VolumeSize gridSize = getBrickGridSize(header);
+    *offset = VolumeSize((brickIndex % gridSize.getX()) * header.brickSize.getX(),
+                         ((brickIndex / gridSize.getX()) % gridSize.getY()) *
+                             header.brickSize.getY(),
+                         (brickIndex / (gridSize.getX() * gridSize.getY())) *
+                             header.brickSize.getZ());
+    *size = VolumeSize(std::min(header.brickSize.getX(), header.size.getX() - offset->getX()),
+                       std::min(header.brickSize.getY(), header.size.getY() - offset->getY()),
+                       std::min(header.brickSize.getZ(), header.size.getZ() - offset->getZ()));
+}
+} // namespace VDTK
@@ -0,0 +1,60 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Layout of .vdtk files. All numbers of the header and the index are little endian
+//
+//  header (64 byte):
+//   0  magic "VDTK"
+//   4  uint16 version
+//   6  uint8  bits per voxel (always 16)
+//   7  uint8  byte order of raw bricks (0 little, 1 big)
+//   8  uint64 size x, y, z
+//   32 float  spacing x, y, z
+//   44 uint32 brick size x, y, z
+//   56 reserved
+//  index (16 byte per brick, x fastest, then y, then z):
+//   0  uint64 file offset of the brick
+//   8  uint32 stored size of the brick
+//   12 uint8  encoding of the brick
+//  bricks:
+//   voxels of each brick in zyx order, bricks at the upper borders are cut to the volume
+enum class BrickEncoding : uint8_t { Raw = 0, DeltaBytePlaneRLE = 1 };
+
+struct VdtkHeader {
+    VolumeSize size = VolumeSize(0);
+    VolumeSpacing spacing = VolumeSpacing(0.0f);
+    VolumeSize brickSize = VolumeSize(0);
+    Endianness endianness = Endianness::Little;
+};
+
+struct BrickIndexEntry {
+    uint64_t offset = 0;
+    uint32_t storedSize = 0;
+    BrickEncoding encoding = BrickEncoding::Raw;
+};
+
+class VdtkFormat {
+public:
+    VdtkFormat();
+    ~VdtkFormat();
+
+    static void writeHeader(const VdtkHeader& header, char* const destination);
+    // fails if the header is no valid version 1 header
+    static bool readHeader(const char* const source, VdtkHeader* const header);
+
+    static void writeIndexEntry(const BrickIndexEntry& entry, char* const destination);
+    static bool readIndexEntry(const char* const source, BrickIndexEntry* const entry);
+
+    // number of bricks along each axis
+    static VolumeSize getBrickGridSize(const VdtkHeader& header);
+    static std::size_t getBrickCount(const VdtkHeader& header);
+    // first voxel and size of a brick, cut to the volume
+    static void getBrickBox(const VdtkHeader& header, const std::size_t brickIndex,
+                            VolumeSize* const offset, VolumeSize* const size);
+
+    static constexpr std::size_t m_headerSize = 64;
+    static constexpr std::size_t m_indexEntrySize = 16;
+    static constexpr uint16_t m_version = 1;
+};
+} // namespace VDTK
@@ -0,0 +1,213 @@
+
+#include <atomic>
+#include <cstring>
+#include <threadpool/ThreadPool.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "BrickCodec.h"
+#include "VdtkReader.h"
+
+namespace VDTK {
+VdtkReader::VdtkReader() {}
+
+VdtkReader::~VdtkReader() {}
+
+bool VdtkReader::read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                      const std::size_t numberOfThreads) {
+    VdtkHeader header;
+    std::vector<BrickIndexEntry> index;
+    if (!readIndex(filePath, &header, &index)) {
+        return false;
+    }
+    return readBricks(volumeData, filePath, header, index, VolumeSize(0), header.size,
+                      numberOfThreads);
+}
+
+bool VdtkReader::readRegion(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                            const VolumeSize& regionOffset, const VolumeSize& regionSize,
+                            const std::size_t numberOfThreads) {
+    VdtkHeader header;
+    std::vector<BrickIndexEntry> index;
+    if (!readIndex(filePath, &header, &index)) {
+        return false;
+    }
+
+    if (regionSize.getX() == 0 || regionSize.getY() == 0 || regionSize.getZ() == 0 ||
+        regionOffset.getX() + regionSize.getX() > header.size.getX() ||
+        regionOffset.getY() + regionSize.getY() > header.size.getY() ||
+        regionOffset.getZ() + regionSize.getZ() > header.size.getZ()) {
+        // region is not inside of the volume
+        return false;
+    }
+
+    return readBricks(volumeData, filePath, header, index, regionOffset, regionSize,
+                      numberOfThreads);
+}
+
+bool VdtkReader::readBricks(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                            const VdtkHeader& header, const std::vector<BrickIndexEntry>& index,
+                            const VolumeSize& regionOffset, const VolumeSize& regionSize,
+                            const std::size_t numberOfThreads) {
+    VolumeData volume(regionSize, header.spacing);
+    uint16_t* const destination = volume.getRawVolumeData().data();
+    std::atomic<bool> success = true;
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t brickIndex = 0; brickIndex < index.size(); brickIndex++) {
+            VolumeSize brickOffset(0);
+            VolumeSize brickSize(0);
+            VdtkFormat::getBrickBox(header, brickIndex, &brickOffset, &brickSize);
+
+            // intersection of brick and region in volume coordinates
+            const VolumeSize first(std::max(brickOffset.getX(), regionOffset.getX()),
+                                   std::max(brickOffset.getY(), regionOffset.getY()),
+                                   std::max(brickOffset.getZ(), regionOffset.getZ()));
+            const VolumeSize last(
+                std::min(brickOffset.getX() + brickSize.getX(),
+                         regionOffset.getX() + regionSize.getX()),
+                std::min(brickOffset.getY() + brickSize.getY(),
+                         regionOffset.getY() + regionSize.getY()),
+                std::min(brickOffset.getZ() + brickSize.getZ(),
+                         regionOffset.getZ() + regionSize.getZ()));
+            if (first.getX() >= last.getX() || first.getY() >= last.getY() ||
+                first.getZ() >= last.getZ()) {
+                // brick is not needed
+                continue;
+            }
+
+            threadPool.enqueue([&, brickIndex, brickOffset, brickSize, first, last]() {
+                thread_local std::vector<uint16_t> voxels;
+                if (!success ||
+                    !readBrick(filePath, header, index[brickIndex], brickIndex, &voxels)) {
+                    success = false;
+                    return;
+                }
+
+                const std::size_t rowLength = last.getX() - first.getX();
+                for (std::size_t z = first.getZ(); z < last.getZ(); z++) {
+                    for (std::size_t y = first.getY(); y < last.getY(); y++) {
+                        const uint16_t* const source =
+                            voxels.data() + (first.getX() - brickOffset.getX()) +
+                            brickSize.getX() * ((y - brickOffset.getY()) +
+                                                brickSize.getY() * (z - brickOffset.getZ()));
+                        uint16_t* const row =
+                            destination + (first.getX() - regionOffset.getX()) +
+                            regionSize.getX() * ((y - regionOffset.getY()) +
+                                                 regionSize.getY() * (z - regionOffset.getZ()));
+                        std::memcpy(row, source, rowLength * sizeof(uint16_t));
+                    }
+                }
+            });
+        }
+    }
+
+    if (!success) {
+        // Unable to read file
+        return false;
+    }
+
+    *volumeData = std::move(volume);
+    return true;
+}
+
+bool VdtkReader::readIndex(const std::filesystem::path& filePath, VdtkHeader* const header,
+                           std::vector<BrickIndexEntry>* const index) {
+    std::size_t fileSize = 0;
+    try {
+        fileSize = std::filesystem::file_size(filePath);
+    } catch (std::filesystem::filesystem_error& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+
+    char headerData[VdtkFormat::m_headerSize];
+    if (fileSize < VdtkFormat::m_headerSize ||
+        !readBytes(filePath, 0, VdtkFormat::m_headerSize, headerData) ||
+        !VdtkFormat::readHeader(headerData, header)) {
+        // no vdtk file
+        return false;
+    }
+
+    const std::size_t brickCount = VdtkFormat::getBrickCount(*header);
+    if (brickCount == 0 ||
+        brickCount > (fileSize - VdtkFormat::m_headerSize) / VdtkFormat::m_indexEntrySize) {
+        // index does not fit into the file
+        return false;
+    }
+
+    std::vector<char> indexData(brickCount * VdtkFormat::m_indexEntrySize);
+    if (!readBytes(filePath, VdtkFormat::m_headerSize, indexData.size(), indexData.data())) {
+        return false;
+    }
+
+    index->resize(brickCount);
+    for (std::size_t brickIndex = 0; brickIndex < brickCount; brickIndex++) {
+        BrickIndexEntry& entry = (*index)[brickIndex];
+        if (!VdtkFormat::readIndexEntry(indexData.data() +
+                                            brickIndex * VdtkFormat::m_indexEntrySize,
+                                        &entry) ||
+            entry.offset > fileSize || entry.storedSize > fileSize - entry.offset) {
+            // corrupt index
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VdtkReader::readBrick(const std::filesystem::path& filePath, const VdtkHeader& header,
+                           const BrickIndexEntry& entry, const std::size_t brickIndex,
+                           std::vector<uint16_t>* const voxels) {
+    VolumeSize offset(0);
+    VolumeSize size(0);
+    VdtkFormat::getBrickBox(header, brickIndex, &offset, &size);
+    voxels->resize(size.getX() * size.getY() * size.getZ());
+
+    // every worker thread keeps its read buffer, so reading does not allocate after the first
+    // brick
+    thread_local std::vector<char> encoded;
+    encoded.resize(entry.storedSize);
+    return readBytes(filePath, entry.offset, encoded.size(), encoded.data()) &&
+           BrickCodec::decode(encoded.data(), encoded.size(), entry.encoding, header.endianness,
+                              voxels->data(), voxels->size());
+}
+
+bool VdtkReader::readBytes(const std::filesystem::path& filePath, const uint64_t offset,
+                           const std::size_t size, char* const destination) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        // unable to open file
+        return false;
+    }
+
+    std::size_t bytesRead = 0;
+    bool success = true;
+    while (success && bytesRead < size) {
+        const ssize_t result = pread(fileDescriptor, destination + bytesRead, size - bytesRead,
+                                     static_cast<off_t>(offset + bytesRead));
+        success = result > 0;
+        bytesRead += success ? static_cast<std::size_t>(result) : 0;
+    }
+
+    close(fileDescriptor);
+    return success;
+#else
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        // unable to open file
+        return false;
+    }
+
+    file.seekg(offset, std::ios::beg);
+    return static_cast<bool>(file.read(destination, size));
+#endif
+}
+} // namespace VDTK
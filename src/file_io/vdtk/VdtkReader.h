@@ -0,0 +1,38 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+#include "VdtkFormat.h"
+
+namespace VDTK {
+// Reads .vdtk files (see VdtkFormat.h). Every brick is read with its own positioned read and
+// decoded in parallel, so regions only read the bricks they overlap
+class VdtkReader {
+public:
+    VdtkReader();
+    ~VdtkReader();
+
+    static bool read(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                     const std::size_t numberOfThreads);
+    // reads the box [regionOffset, regionOffset + regionSize) of the volume
+    static bool readRegion(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                           const VolumeSize& regionOffset, const VolumeSize& regionSize,
+                           const std::size_t numberOfThreads);
+
+    // header and brick index, checked against the file size
+    static bool readIndex(const std::filesystem::path& filePath, VdtkHeader* const header,
+                          std::vector<BrickIndexEntry>* const index);
+    // random access to a single brick (voxels in zyx order, size from VdtkFormat::getBrickBox)
+    static bool readBrick(const std::filesystem::path& filePath, const VdtkHeader& header,
+                          const BrickIndexEntry& entry, const std::size_t brickIndex,
+                          std::vector<uint16_t>* const voxels);
+
+private:
+    // reads and decodes all bricks overlapping the region in parallel
+    static bool readBricks(VolumeData* const volumeData, const std::filesystem::path& filePath,
+                           const VdtkHeader& header, const std::vector<BrickIndexEntry>& index,
+                           const VolumeSize& regionOffset, const VolumeSize& regionSize,
+                           const std::size_t numberOfThreads);
+    static bool readBytes(const std::filesystem::path& filePath, const uint64_t offset,
+                          const std::size_t size, char* const destination);
+};
+} // namespace VDTK
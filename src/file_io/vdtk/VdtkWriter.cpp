@@ -0,0 +1,132 @@
+
+#include <cstring>
+#include <deque>
+#include <future>
+#include <threadpool/ThreadPool.h>
+
+#include "BrickCodec.h"
+#include "VdtkFormat.h"
+#include "VdtkWriter.h"
+
+namespace VDTK {
+VdtkWriter::VdtkWriter() {}
+
+VdtkWriter::~VdtkWriter() {}
+
+bool VdtkWriter::write(const std::filesystem::path& filePath, const VolumeData& volume,
+                       const VolumeSize& brickSize, const std::size_t numberOfThreads) {
+    VdtkHeader header;
+    header.size = volume.getSize();
+    header.spacing = volume.getSpacing();
+    header.brickSize = VolumeSize(std::min(brickSize.getX(), header.size.getX()),
+                                  std::min(brickSize.getY(), header.size.getY()),
+                                  std::min(brickSize.getZ(), header.size.getZ()));
+    header.endianness = Endianness::Little;
+
+    const std::size_t brickVoxelCount =
+        header.brickSize.getX() * header.brickSize.getY() * header.brickSize.getZ();
+    if (volume.getVoxelCount() == 0 || brickVoxelCount == 0 ||
+        brickVoxelCount > UINT32_MAX / sizeof(uint16_t)) {
+        // empty volume or a brick does not fit into the index
+        return false;
+    }
+
+    std::ofstream file = std::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (file.fail()) {
+        // unable to create file
+        return false;
+    }
+
+    const std::size_t brickCount = VdtkFormat::getBrickCount(header);
+    std::vector<char> headerAndIndex(VdtkFormat::m_headerSize +
+                                     brickCount * VdtkFormat::m_indexEntrySize);
+    VdtkFormat::writeHeader(header, headerAndIndex.data());
+
+    // the index gets written after all bricks are compressed, reserve its space
+    if (!file.write(headerAndIndex.data(), headerAndIndex.size())) {
+        return false;
+    }
+
+    struct EncodedBrick {
+        std::vector<char> data;
+        BrickEncoding encoding = BrickEncoding::Raw;
+    };
+
+    uint64_t offset = headerAndIndex.size();
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        const auto encodeBrick = [&volume, &header](const std::size_t brickIndex) {
+            VolumeSize brickOffset(0);
+            VolumeSize size(0);
+            VdtkFormat::getBrickBox(header, brickIndex, &brickOffset, &size);
+
+            thread_local std::vector<uint16_t> voxels;
+            voxels.resize(size.getX() * size.getY() * size.getZ());
+            copyBrick(volume, brickOffset, size, voxels.data());
+
+            EncodedBrick brick;
+            brick.encoding = BrickCodec::encode(voxels.data(), voxels.size(), header.endianness,
+                                                &brick.data);
+            return brick;
+        };
+
+        // bricks in flight, written in order as soon as the oldest one is compressed
+        const std::size_t maximumPendingBricks = 4 * std::max<std::size_t>(numberOfThreads, 1);
+        std::deque<std::future<EncodedBrick>> pendingBricks;
+        std::size_t nextBrick = 0;
+
+        for (std::size_t brickIndex = 0; brickIndex < brickCount; brickIndex++) {
+            while (nextBrick < brickCount && pendingBricks.size() < maximumPendingBricks) {
+                pendingBricks.push_back(threadPool.enqueue(encodeBrick, nextBrick));
+                nextBrick++;
+            }
+
+            const EncodedBrick brick = pendingBricks.front().get();
+            pendingBricks.pop_front();
+
+            BrickIndexEntry entry;
+            entry.offset = offset;
+            entry.storedSize = static_cast<uint32_t>(brick.data.size());
+            entry.encoding = brick.encoding;
+            VdtkFormat::writeIndexEntry(entry, headerAndIndex.data() + VdtkFormat::m_headerSize +
+                                                   brickIndex * VdtkFormat::m_indexEntrySize);
+
+            if (!file.write(brick.data.data(), brick.data.size())) {
+                // unable to write file, wait for the remaining bricks
+                for (std::future<EncodedBrick>& pendingBrick : pendingBricks) {
+                    pendingBrick.wait();
+                }
+                return false;
+            }
+            offset += brick.data.size();
+        }
+    }
+
+    file.seekp(VdtkFormat::m_headerSize, std::ios::beg);
+    if (!file.write(headerAndIndex.data() + VdtkFormat::m_headerSize,
+                    headerAndIndex.size() - VdtkFormat::m_headerSize)) {
+        return false;
+    }
+    return true;
+}
+
+void VdtkWriter::copyBrick(const VolumeData& volume, const VolumeSize& offset,
+                           const VolumeSize& size, uint16_t* const destination) {
+    const VolumeSize volumeSize = volume.getSize();
+    const uint16_t* const source = volume.getRawVolumeData().data();
+
+    uint16_t* row = destination;
+    for (std::size_t z = 0; z < size.getZ(); z++) {
+        for (std::size_t y = 0; y < size.getY(); y++) {
+            const std::size_t first =
+                offset.getX() +
+                volumeSize.getX() * (offset.getY() + y + volumeSize.getY() * (offset.getZ() + z));
+            std::memcpy(row, source + first, size.getX() * sizeof(uint16_t));
+            row += size.getX();
+        }
+    }
+}
+} // namespace VDTK
@@ -0,0 +1,21 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Writes .vdtk files (see VdtkFormat.h). Bricks get compressed in parallel and written in order
+// while the following bricks are still compressed, only a limited number of compressed bricks
+// is kept in memory
+class VdtkWriter {
+public:
+    VdtkWriter();
+    ~VdtkWriter();
+
+    static bool write(const std::filesystem::path& filePath, const VolumeData& volume,
+                      const VolumeSize& brickSize, const std::size_t numberOfThreads);
+
+private:
+    // copies the voxels of a brick into a contiguous buffer
+    static void copyBrick(const VolumeData& volume, const VolumeSize& offset,
+                          const VolumeSize& size, uint16_t* const destination);
+};
+} // namespace VDTK
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cmath>
+#include <threadpool/ThreadPool.h>
+
+#include "AffineTransformer.h"
+#include "VolumeResizer.h"
+
+namespace VDTK {
+AffineTransformer::AffineTransformer() {}
+
+AffineTransformer::~AffineTransformer() {}
+
+bool AffineTransformer::resample(VolumeData* const volume, const AffineMatrix& transformation,
+                                 const ScaleMode scaleMode, const VolumeSize& size,
+                                 const VolumeSpacing& spacing, const Vector3D<float>& origin,
+                                 const std::size_t numberOfThreads) {
+    // the output grid is sampled, so we need the mapping from output to source positions
+    AffineMatrix inverseTransformation;
+    if (!invert(transformation, &inverseTransformation)) {
+        return false;
+    }
+
+    // output voxel index -> physical position in output space
+    // a spacing of zero is treated as unit spacing (output and source)
+    const double spacingX = (spacing.getX() > 0.0f) ? spacing.getX() : 1.0;
+    const double spacingY = (spacing.getY() > 0.0f) ? spacing.getY() : 1.0;
+    const double spacingZ = (spacing.getZ() > 0.0f) ? spacing.getZ() : 1.0;
+    const AffineMatrix outputIndexToPhysical = {{{spacingX, 0.0, 0.0, origin.getX()},
+                                                 {0.0, spacingY, 0.0, origin.getY()},
+                                                 {0.0, 0.0, spacingZ, origin.getZ()},
+                                                 {0.0, 0.0, 0.0, 1.0}}};
+
+    // physical position in source space -> source voxel index
+    const VolumeSpacing sourceSpacing = volume->getSpacing();
+    const double sourceSpacingX = (sourceSpacing.getX() > 0.0f) ? sourceSpacing.getX() : 1.0;
+    const double sourceSpacingY = (sourceSpacing.getY() > 0.0f) ? sourceSpacing.getY() : 1.0;
+    const double sourceSpacingZ = (sourceSpacing.getZ() > 0.0f) ? sourceSpacing.getZ() : 1.0;
+    const AffineMatrix sourcePhysicalToIndex = {{{1.0 / sourceSpacingX, 0.0, 0.0, 0.0},
+                                                 {0.0, 1.0 / sourceSpacingY, 0.0, 0.0},
+                                                 {0.0, 0.0, 1.0 / sourceSpacingZ, 0.0},
+                                                 {0.0, 0.0, 0.0, 1.0}}};
+
+    const AffineMatrix outputToSource = multiply(
+        sourcePhysicalToIndex, multiply(inverseTransformation, outputIndexToPhysical));
+
+    VolumeData volumeResampled(size, spacing);
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // resample each z slice using seperate threads, rows along x are contiguous in memory
+        for (std::size_t z = 0; z < size.getZ(); z++) {
+            threadPool.enqueue(&AffineTransformer::resampleSliceZ, volume, &volumeResampled,
+                               outputToSource, scaleMode, z);
+        }
+    }
+
+    *volume = std::move(volumeResampled);
+    return true;
+}
+
+bool AffineTransformer::invert(const AffineMatrix& matrix, AffineMatrix* const inverse) {
+    // Gauss-Jordan elimination with partial pivoting
+    AffineMatrix left = matrix;
+    AffineMatrix right = {{{1.0, 0.0, 0.0, 0.0},
+                           {0.0, 1.0, 0.0, 0.0},
+                           {0.0, 0.0, 1.0, 0.0},
+                           {0.0, 0.0, 0.0, 1.0}}};
+
+    for (std::size_t column = 0; column < 4; column++) {
+        std::size_t pivot = column;
+        for (std::size_t row = column + 1; row < 4; row++) {
+            if (std::abs(left[row][column]) > std::abs(left[pivot][column])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(left[pivot][column]) < 1e-12) {
+            // matrix is singular
+            return false;
+        }
+        std::swap(left[pivot], left[column]);
+        std::swap(right[pivot], right[column]);
+
+        const double divisor = left[column][column];
+        for (std::size_t i = 0; i < 4; i++) {
+            left[column][i] /= divisor;
+            right[column][i] /= divisor;
+        }
+
+        for (std::size_t row = 0; row < 4; row++) {
+            if (row != column) {
+                const double factor = left[row][column];
+                for (std::size_t i = 0; i < 4; i++) {
+                    left[row][i] -= factor * left[column][i];
+                    right[row][i] -= factor * right[column][i];
+                }
+            }
+        }
+    }
+
+    *inverse = right;
+    return true;
+}
+
+const AffineMatrix AffineTransformer::multiply(const AffineMatrix& lhs, const AffineMatrix& rhs) {
+    AffineMatrix result = {};
+    for (std::size_t row = 0; row < 4; row++) {
+        for (std::size_t column = 0; column < 4; column++) {
+            for (std::size_t i = 0; i < 4; i++) {
+                result[row][column] += lhs[row][i] * rhs[i][column];
+            }
+        }
+    }
+    return result;
+}
+
+bool AffineTransformer::clipRow(const std::array<double, 3>& start,
+                                const std::array<double, 3>& step,
+                                const std::array<double, 3>& lowerBorder,
+                                const std::array<double, 3>& upperBorder,
+                                const std::size_t rowLength, std::size_t* const first,
+                                std::size_t* const last) {
+    if (rowLength == 0) {
+        return false;
+    }
+
+    // position along the row is start + t * step, find the t interval inside of all borders
+    double tMin = 0.0;
+    double tMax = static_cast<double>(rowLength - 1);
+
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (std::abs(step[axis]) < 1e-12) {
+            // row is parallel to this axis
+            if (start[axis] < lowerBorder[axis] || start[axis] > upperBorder[axis]) {
+                return false;
+            }
+        } else {
+            double t0 = (lowerBorder[axis] - start[axis]) / step[axis];
+            double t1 = (upperBorder[axis] - start[axis]) / step[axis];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+        }
+    }
+
+    // small tolerance against rounding errors, positions get clamped while sampling
+    tMin = std::ceil(tMin - 1e-6);
+    tMax = std::floor(tMax + 1e-6);
+    if (tMin > tMax) {
+        return false;
+    }
+
+    *first = static_cast<std::size_t>(tMin);
+    *last = std::min(static_cast<std::size_t>(tMax), rowLength - 1);
+    return *first <= *last;
+}
+
+void AffineTransformer::resampleSliceZ(const VolumeData* const volume,
+                                       VolumeData* const volumeResampled,
+                                       const AffineMatrix& outputToSource,
+                                       const ScaleMode scaleMode, const std::size_t positionZ) {
+    const VolumeSize sourceSize = volume->getSize();
+    const VolumeSize outputSize = volumeResampled->getSize();
+
+    if (sourceSize.getX() == 0 || sourceSize.getY() == 0 || sourceSize.getZ() == 0) {
+        return;
+    }
+
+    const Vector3D<float> originalSize(static_cast<float>(sourceSize.getX()),
+                                       static_cast<float>(sourceSize.getY()),
+                                       static_cast<float>(sourceSize.getZ()));
+    const std::array<double, 3> maxPosition = {static_cast<double>(sourceSize.getX() - 1),
+                                               static_cast<double>(sourceSize.getY() - 1),
+                                               static_cast<double>(sourceSize.getZ() - 1)};
+
+    // nearest neighbor may sample half a voxel outside of the voxel centers
+    const double margin = (scaleMode == ScaleMode::NearestNeighbor) ? 0.499 : 0.0;
+    const std::array<double, 3> lowerBorder = {-margin, -margin, -margin};
+    const std::array<double, 3> upperBorder = {maxPosition[0] + margin, maxPosition[1] + margin,
+                                               maxPosition[2] + margin};
+
+    // moving one voxel along the output row moves the source position by the first column
+    const std::array<double, 3> step = {outputToSource[0][0], outputToSource[1][0],
+                                        outputToSource[2][0]};
+
+    const double z = static_cast<double>(positionZ);
+    for (std::size_t positionY = 0; positionY < outputSize.getY(); positionY++) {
+        const double y = static_cast<double>(positionY);
+        const std::array<double, 3> start = {
+            outputToSource[0][1] * y + outputToSource[0][2] * z + outputToSource[0][3],
+            outputToSource[1][1] * y + outputToSource[1][2] * z + outputToSource[1][3],
+            outputToSource[2][1] * y + outputToSource[2][2] * z + outputToSource[2][3]};
+
+        std::size_t first = 0;
+        std::size_t last = 0;
+        // skip rows which do not intersect the source volume at all, they stay zero
+        if (!clipRow(start, step, lowerBorder, upperBorder, outputSize.getX(), &first, &last)) {
+            continue;
+        }
+
+        std::array<double, 3> position = {start[0] + step[0] * static_cast<double>(first),
+                                          start[1] + step[1] * static_cast<double>(first),
+                                          start[2] + step[2] * static_cast<double>(first)};
+
+        for (std::size_t positionX = first; positionX <= last; positionX++) {
+            const Vector3D<float> originalPosition(
+                static_cast<float>(std::clamp(position[0], 0.0, maxPosition[0])),
+                static_cast<float>(std::clamp(position[1], 0.0, maxPosition[1])),
+                static_cast<float>(std::clamp(position[2], 0.0, maxPosition[2])));
+
+            float valueInterpolated = 0.0f;
+            switch (scaleMode) {
+            case ScaleMode::NearestNeighbor: {
+                valueInterpolated =
+                    VolumeResizer::getNearestNeigborValue(volume, originalPosition);
+                break;
+            }
+            case ScaleMode::Linear: {
+                valueInterpolated = VolumeResizer::getTrilinearInterpolatedValue(
+                    volume, originalSize, originalPosition);
+                break;
+            }
+            case ScaleMode::Cubic: {
+                valueInterpolated = VolumeResizer::getTricubicInterpolatedValue(
+                    volume, originalSize, originalPosition);
+                break;
+            }
+            default: { break; }
+            }
+
+            // tricubic interpolation can overshoot the range of the voxels
+            valueInterpolated =
+                std::clamp(valueInterpolated, 0.0f, static_cast<float>(UINT16_MAX));
+            volumeResampled->setVoxelValue(positionX, positionY, positionZ,
+                                           static_cast<uint16_t>(valueInterpolated));
+
+            position[0] += step[0];
+            position[1] += step[1];
+            position[2] += step[2];
+        }
+    }
+}
+} // namespace VDTK
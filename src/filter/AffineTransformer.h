@@ -0,0 +1,33 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+class AffineTransformer {
+public:
+    AffineTransformer();
+    ~AffineTransformer();
+
+    // transformation maps physical positions (voxel index * spacing) of the volume into the
+    // physical space of the output grid. origin is the physical position of the first output voxel
+    // returns false if the transformation can not be inverted
+    static bool resample(VolumeData* const volume, const AffineMatrix& transformation,
+                         const ScaleMode scaleMode, const VolumeSize& size,
+                         const VolumeSpacing& spacing, const Vector3D<float>& origin,
+                         const std::size_t numberOfThreads);
+
+private:
+    static bool invert(const AffineMatrix& matrix, AffineMatrix* const inverse);
+    static const AffineMatrix multiply(const AffineMatrix& lhs, const AffineMatrix& rhs);
+
+    // calculates the range of output positions [first, last] of one row that map into the source
+    // volume. returns false if the whole row lies outside of the source volume
+    static bool clipRow(const std::array<double, 3>& start, const std::array<double, 3>& step,
+                        const std::array<double, 3>& lowerBorder,
+                        const std::array<double, 3>& upperBorder, const std::size_t rowLength,
+                        std::size_t* const first, std::size_t* const last);
+
+    static void resampleSliceZ(const VolumeData* const volume, VolumeData* const volumeResampled,
+                               const AffineMatrix& outputToSource, const ScaleMode scaleMode,
+                               const std::size_t positionZ);
+};
+} // namespace VDTK
@@ -0,0 +1,152 @@
+
+#include <threadpool/ThreadPool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "PointOperationChain.h"
+#include "WindowFilter.h"
+
+namespace VDTK {
+PointOperationChain::PointOperationChain() {}
+
+PointOperationChain::~PointOperationChain() {}
+
+void PointOperationChain::appendWindow(const WindowingFunction func, const int32_t windowCenter,
+                                       const int32_t windowWidth, const int32_t windowOffset) {
+    auto window = &WindowFilter::getValueWithWindowingFunctionLinear;
+    switch (func) {
+    case WindowingFunction::LinearExact: {
+        window = &WindowFilter::getValueWithWindowingFunctionLinearExact;
+        break;
+    }
+    case WindowingFunction::Sigmoid: {
+        window = &WindowFilter::getValueWithWindowingFunctionSigmoid;
+        break;
+    }
+    default: { break; }
+    }
+
+    if (m_lookupTable.empty()) {
+        // the flags recorded so far become the first stage of the table
+        m_lookupTable.resize(UINT16_MAX + 1);
+        for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+            m_lookupTable[value] = applyFlags(static_cast<uint16_t>(value));
+        }
+        m_swapBytes = false;
+        m_invertMask = 0;
+    }
+
+    for (uint16_t& value : m_lookupTable) {
+        value = window(value, windowCenter, windowWidth, windowOffset);
+    }
+}
+
+void PointOperationChain::appendInvert() {
+    if (m_lookupTable.empty()) {
+        m_invertMask ^= UINT16_MAX;
+        return;
+    }
+    for (uint16_t& value : m_lookupTable) {
+        value ^= UINT16_MAX;
+    }
+}
+
+void PointOperationChain::appendByteSwap() {
+    if (m_lookupTable.empty()) {
+        // swapping bytes and inverting all bits commute
+        m_swapBytes = !m_swapBytes;
+        return;
+    }
+    for (uint16_t& value : m_lookupTable) {
+        value = static_cast<uint16_t>((value << 8) | (value >> 8));
+    }
+}
+
+bool PointOperationChain::isEmpty() const {
+    return m_lookupTable.empty() && !m_swapBytes && m_invertMask == 0;
+}
+
+void PointOperationChain::clear() {
+    m_swapBytes = false;
+    m_invertMask = 0;
+    m_lookupTable.clear();
+}
+
+uint16_t PointOperationChain::apply(const uint16_t value) const {
+    return m_lookupTable.empty() ? applyFlags(value) : m_lookupTable[value];
+}
+
+void PointOperationChain::apply(VolumeData* const volume,
+                                const std::size_t numberOfThreads) const {
+    if (isEmpty()) {
+        return;
+    }
+
+    uint16_t* const data = volume->getRawVolumeData().data();
+    const std::size_t voxelCount = volume->getVoxelCount();
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t firstVoxel = 0; firstVoxel < voxelCount;
+             firstVoxel += m_chunkVoxelCount) {
+            const std::size_t chunkVoxelCount =
+                std::min(m_chunkVoxelCount, voxelCount - firstVoxel);
+            threadPool.enqueue([this, data, firstVoxel, chunkVoxelCount]() {
+                if (m_lookupTable.empty()) {
+                    applyFlags(data + firstVoxel, chunkVoxelCount);
+                } else {
+                    applyLookupTable(data + firstVoxel, chunkVoxelCount);
+                }
+            });
+        }
+    }
+}
+
+uint16_t PointOperationChain::applyFlags(const uint16_t value) const {
+    const uint16_t swapped =
+        m_swapBytes ? static_cast<uint16_t>((value << 8) | (value >> 8)) : value;
+    return swapped ^ m_invertMask;
+}
+
+void PointOperationChain::applyFlags(uint16_t* const data, const std::size_t voxelCount) const {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i invertMask = _mm_set1_epi16(static_cast<short>(m_invertMask));
+    for (; i + 8 <= voxelCount; i += 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (m_swapBytes) {
+            values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(values, invertMask));
+    }
+#endif
+    for (; i < voxelCount; i++) {
+        data[i] = applyFlags(data[i]);
+    }
+}
+
+void PointOperationChain::applyLookupTable(uint16_t* const data,
+                                           const std::size_t voxelCount) const {
+    // there is no 16 bit gather, unrolling lets the loads of independent voxels overlap
+    const uint16_t* const lookupTable = m_lookupTable.data();
+    std::size_t i = 0;
+    for (; i + 4 <= voxelCount; i += 4) {
+        const uint16_t value0 = lookupTable[data[i]];
+        const uint16_t value1 = lookupTable[data[i + 1]];
+        const uint16_t value2 = lookupTable[data[i + 2]];
+        const uint16_t value3 = lookupTable[data[i + 3]];
+        data[i] = value0;
+        data[i + 1] = value1;
+        data[i + 2] = value2;
+        data[i + 3] = value3;
+    }
+    for (; i < voxelCount; i++) {
+        data[i] = lookupTable[data[i]];
+    }
+}
+} // namespace VDTK
@@ -0,0 +1,37 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Records point operations (window, invert, byte swap) and applies all of them in one pass over
+// the volume. Invert and byte swap commute and are kept as flags, so chains of them run as a
+// vectorized xor and swap. Windows are composed into a lookup table with one entry per 16 bit
+// value
+class PointOperationChain {
+public:
+    PointOperationChain();
+    ~PointOperationChain();
+
+    void appendWindow(const WindowingFunction func, const int32_t windowCenter,
+                      const int32_t windowWidth, const int32_t windowOffset);
+    void appendInvert();
+    void appendByteSwap();
+
+    bool isEmpty() const;
+    void clear();
+
+    uint16_t apply(const uint16_t value) const;
+    void apply(VolumeData* const volume, const std::size_t numberOfThreads) const;
+
+private:
+    uint16_t applyFlags(const uint16_t value) const;
+    void applyFlags(uint16_t* const data, const std::size_t voxelCount) const;
+    void applyLookupTable(uint16_t* const data, const std::size_t voxelCount) const;
+
+    bool m_swapBytes = false;
+    uint16_t m_invertMask = 0;
+    // empty until the first window gets appended
+    std::vector<uint16_t> m_lookupTable;
+
+    static constexpr std::size_t m_chunkVoxelCount = 256 * 1024;
+};
+} // namespace VDTK
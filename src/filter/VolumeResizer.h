@@ -16,6 +16,17 @@ public:
     static void scaleTricubic(VolumeData* const volume, const VDTK::Vector3D<float>& scale,
                               const std::size_t numberOfThreads);
 
+    // interpolation functions are also used by other resampling filters (see AffineTransformer)
+    // Nearest neighbor interpolation
+    static float getNearestNeigborValue(const VolumeData* const volume,
+                                        const VDTK::Vector3D<float>& originalPosition);
+    static float getTrilinearInterpolatedValue(const VolumeData* const volume,
+                                               const VDTK::Vector3D<float>& originalSize,
+                                               const VDTK::Vector3D<float>& originalPosition);
+    static float getTricubicInterpolatedValue(const VolumeData* const volume,
+                                              const VDTK::Vector3D<float>& originalSize,
+                                              const VDTK::Vector3D<float>& originalPosition);
+
 private:
     enum class InterpolationMode { Nearest, Trilinear, Tricubic };
 
@@ -27,10 +38,6 @@ private:
                             const InterpolationMode interpolationMode,
                             const std::size_t numberOfThreads);
 
-    // Nearest neighbor interpolation
-    static float getNearestNeigborValue(const VolumeData* const volume,
-                                        const VDTK::Vector3D<float>& originalPosition);
-
     // Linear interpolation
     static inline float interpolateLinear(const std::array<float, 2>& values, const float x);
     static inline float interpolateBilinear(const std::array<std::array<float, 2>, 2>& valuePlane,
@@ -38,9 +45,6 @@ private:
     static inline float interpolateTrilinear(
         const std::array<std::array<std::array<float, 2>, 2>, 2>& valueGrid, const float x,
         const float y, const float z);
-    static float getTrilinearInterpolatedValue(const VolumeData* const volume,
-                                               const VDTK::Vector3D<float>& originalSize,
-                                               const VDTK::Vector3D<float>& originalPosition);
 
     // Cubic interpolation
     static inline float interpolateCubic(const std::array<float, 4>& values, const float x);
@@ -49,9 +53,6 @@ private:
     static inline float interpolateTricubic(
         const std::array<std::array<std::array<float, 4>, 4>, 4>& valueGrid, const float x,
         const float y, const float z);
-    static float getTricubicInterpolatedValue(const VolumeData* const volume,
-                                              const VDTK::Vector3D<float>& originalSize,
-                                              const VDTK::Vector3D<float>& originalPosition);
 };
 
 } // namespace VDTK
\ No newline at end of file
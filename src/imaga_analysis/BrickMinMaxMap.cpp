@@ -0,0 +1,181 @@
+#include <threadpool/ThreadPool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "BrickMinMaxMap.h"
+
+namespace VDTK {
+BrickMinMaxMap::BrickMinMaxMap() {}
+
+BrickMinMaxMap::~BrickMinMaxMap() {}
+
+void BrickMinMaxMap::build(const VolumeData& volume, const std::size_t brickSize,
+                           const std::size_t numberOfThreads) {
+    clear();
+    const VolumeSize volumeSize = volume.getSize();
+    if (brickSize == 0 || volume.getVoxelCount() == 0) {
+        return;
+    }
+
+    m_brickSize = brickSize;
+    m_volumeSize = volumeSize;
+    m_gridSize = VolumeSize((volumeSize.getX() + brickSize - 1) / brickSize,
+                            (volumeSize.getY() + brickSize - 1) / brickSize,
+                            (volumeSize.getZ() + brickSize - 1) / brickSize);
+    m_minima.resize(getBrickCount());
+    m_maxima.resize(getBrickCount());
+
+    const uint16_t* const data = volume.getRawVolumeData().data();
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // every task handles one row of bricks along x, so its voxel rows are read once
+        for (std::size_t brickZ = 0; brickZ < m_gridSize.getZ(); brickZ++) {
+            for (std::size_t brickY = 0; brickY < m_gridSize.getY(); brickY++) {
+                threadPool.enqueue([&, brickY, brickZ]() {
+                    const std::size_t firstBrick = getBrickIndex(0, brickY, brickZ);
+                    for (std::size_t brickX = 0; brickX < m_gridSize.getX(); brickX++) {
+                        m_minima[firstBrick + brickX] = UINT16_MAX;
+                        m_maxima[firstBrick + brickX] = 0;
+                    }
+
+                    // brick box plus apron, clamped to the volume
+                    const std::size_t firstY = (brickY > 0) ? brickY * brickSize - 1 : 0;
+                    const std::size_t lastY =
+                        std::min((brickY + 1) * brickSize + 1, volumeSize.getY());
+                    const std::size_t firstZ = (brickZ > 0) ? brickZ * brickSize - 1 : 0;
+                    const std::size_t lastZ =
+                        std::min((brickZ + 1) * brickSize + 1, volumeSize.getZ());
+
+                    for (std::size_t positionZ = firstZ; positionZ < lastZ; positionZ++) {
+                        for (std::size_t positionY = firstY; positionY < lastY; positionY++) {
+                            const uint16_t* const row =
+                                data +
+                                volumeSize.getX() * (positionY + volumeSize.getY() * positionZ);
+                            for (std::size_t brickX = 0; brickX < m_gridSize.getX(); brickX++) {
+                                const std::size_t firstX =
+                                    (brickX > 0) ? brickX * brickSize - 1 : 0;
+                                const std::size_t lastX =
+                                    std::min((brickX + 1) * brickSize + 1, volumeSize.getX());
+                                findRowMinMax(row + firstX, lastX - firstX,
+                                              &m_minima[firstBrick + brickX],
+                                              &m_maxima[firstBrick + brickX]);
+                            }
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    m_valid = true;
+}
+
+void BrickMinMaxMap::clear() {
+    m_valid = false;
+    m_brickSize = 0;
+    m_volumeSize = VolumeSize(0);
+    m_gridSize = VolumeSize(0);
+    m_minima.clear();
+    m_maxima.clear();
+}
+
+bool BrickMinMaxMap::isValid() const {
+    return m_valid;
+}
+
+std::size_t BrickMinMaxMap::getBrickSize() const {
+    return m_brickSize;
+}
+
+const VolumeSize& BrickMinMaxMap::getVolumeSize() const {
+    return m_volumeSize;
+}
+
+const VolumeSize& BrickMinMaxMap::getGridSize() const {
+    return m_gridSize;
+}
+
+std::size_t BrickMinMaxMap::getBrickCount() const {
+    return m_gridSize.getX() * m_gridSize.getY() * m_gridSize.getZ();
+}
+
+std::size_t BrickMinMaxMap::getBrickIndex(const std::size_t positionX,
+                                          const std::size_t positionY,
+                                          const std::size_t positionZ) const {
+    return positionX + m_gridSize.getX() * (positionY + m_gridSize.getY() * positionZ);
+}
+
+void BrickMinMaxMap::getBrickBox(const std::size_t brickIndex, VolumeSize* const offset,
+                                 VolumeSize* const size) const {
+    *offset = VolumeSize((brickIndex % m_gridSize.getX()) * m_brickSize,
+                         ((brickIndex / m_gridSize.getX()) % m_gridSize.getY()) * m_brickSize,
+                         (brickIndex / (m_gridSize.getX() * m_gridSize.getY())) * m_brickSize);
+    *size = VolumeSize(std::min(m_brickSize, m_volumeSize.getX() - offset->getX()),
+                       std::min(m_brickSize, m_volumeSize.getY() - offset->getY()),
+                       std::min(m_brickSize, m_volumeSize.getZ() - offset->getZ()));
+}
+
+uint16_t BrickMinMaxMap::getMinimum(const std::size_t brickIndex) const {
+    return m_minima[brickIndex];
+}
+
+uint16_t BrickMinMaxMap::getMaximum(const std::size_t brickIndex) const {
+    return m_maxima[brickIndex];
+}
+
+bool BrickMinMaxMap::containsRange(const std::size_t brickIndex, const uint16_t lowerValue,
+                                   const uint16_t upperValue) const {
+    return m_minima[brickIndex] <= upperValue && m_maxima[brickIndex] >= lowerValue;
+}
+
+std::vector<std::size_t> BrickMinMaxMap::findBricks(const uint16_t lowerValue,
+                                                    const uint16_t upperValue) const {
+    std::vector<std::size_t> bricks;
+    for (std::size_t brickIndex = 0; brickIndex < m_minima.size(); brickIndex++) {
+        if (containsRange(brickIndex, lowerValue, upperValue)) {
+            bricks.push_back(brickIndex);
+        }
+    }
+    return bricks;
+}
+
+void BrickMinMaxMap::findRowMinMax(const uint16_t* const row, const std::size_t length,
+                                   uint16_t* const minimum, uint16_t* const maximum) {
+    uint16_t rowMinimum = *minimum;
+    uint16_t rowMaximum = *maximum;
+    std::size_t position = 0;
+#if defined(__SSE2__)
+    if (length >= 8) {
+        // SSE2 only compares signed 16 bit values, flipping the sign bit keeps the order
+        const __m128i signBit = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i minima = _mm_set1_epi16(static_cast<short>(rowMinimum ^ 0x8000));
+        __m128i maxima = _mm_set1_epi16(static_cast<short>(rowMaximum ^ 0x8000));
+        for (; position + 8 <= length; position += 8) {
+            const __m128i values = _mm_xor_si128(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + position)), signBit);
+            minima = _mm_min_epi16(minima, values);
+            maxima = _mm_max_epi16(maxima, values);
+        }
+
+        alignas(16) uint16_t lanes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(minima, signBit));
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 8), _mm_xor_si128(maxima, signBit));
+        for (std::size_t lane = 0; lane < 8; lane++) {
+            rowMinimum = std::min(rowMinimum, lanes[lane]);
+            rowMaximum = std::max(rowMaximum, lanes[lane + 8]);
+        }
+    }
+#endif
+    for (; position < length; position++) {
+        rowMinimum = std::min(rowMinimum, row[position]);
+        rowMaximum = std::max(rowMaximum, row[position]);
+    }
+    *minimum = rowMinimum;
+    *maximum = rowMaximum;
+}
+} // namespace VDTK
@@ -0,0 +1,53 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Minimum and maximum voxel value of every brick of the volume, so algorithms can skip bricks
+// that can not contain a value range (empty space skipping). The range of a brick includes one
+// voxel around it (apron), so cells and interpolations between neighbouring bricks are covered
+class BrickMinMaxMap {
+public:
+    BrickMinMaxMap();
+    ~BrickMinMaxMap();
+
+    // computes the map in one parallel pass, brick size is the edge length in voxels
+    void build(const VolumeData& volume, const std::size_t brickSize,
+               const std::size_t numberOfThreads);
+    void clear();
+    // false until built or after clear
+    bool isValid() const;
+
+    std::size_t getBrickSize() const;
+    // size of the volume the map was built for
+    const VolumeSize& getVolumeSize() const;
+    // number of bricks along x, y and z
+    const VolumeSize& getGridSize() const;
+    std::size_t getBrickCount() const;
+    // brick index = x + gridX * (y + gridY * z), like the voxels of a volume
+    std::size_t getBrickIndex(const std::size_t positionX, const std::size_t positionY,
+                              const std::size_t positionZ) const;
+    // box of the brick without apron
+    void getBrickBox(const std::size_t brickIndex, VolumeSize* const offset,
+                     VolumeSize* const size) const;
+
+    uint16_t getMinimum(const std::size_t brickIndex) const;
+    uint16_t getMaximum(const std::size_t brickIndex) const;
+    // true if the brick (with apron) may contain values in [lowerValue, upperValue]
+    bool containsRange(const std::size_t brickIndex, const uint16_t lowerValue,
+                       const uint16_t upperValue) const;
+    // indices of all bricks that may contain values in [lowerValue, upperValue]
+    std::vector<std::size_t> findBricks(const uint16_t lowerValue,
+                                        const uint16_t upperValue) const;
+
+private:
+    static void findRowMinMax(const uint16_t* const row, const std::size_t length,
+                              uint16_t* const minimum, uint16_t* const maximum);
+
+    bool m_valid = false;
+    std::size_t m_brickSize = 0;
+    VolumeSize m_volumeSize = VolumeSize(0);
+    VolumeSize m_gridSize = VolumeSize(0);
+    std::vector<uint16_t> m_minima;
+    std::vector<uint16_t> m_maxima;
+};
+} // namespace VDTK
@@ -0,0 +1,384 @@
+
+#include <future>
+#include <threadpool/ThreadPool.h>
+#include <unordered_map>
+
+#include "ConnectedComponentLabeler.h"
+
+namespace VDTK {
+namespace {
+// labels are read and written by several threads while the slab borders get merged and the trees
+// get flattened
+uint32_t loadLabel(const uint32_t* const label) {
+    return __atomic_load_n(label, __ATOMIC_RELAXED);
+}
+
+void storeLabel(uint32_t* const label, const uint32_t value) {
+    __atomic_store_n(label, value, __ATOMIC_RELAXED);
+}
+} // namespace
+
+ConnectedComponentLabeler::ConnectedComponentLabeler() {}
+
+ConnectedComponentLabeler::~ConnectedComponentLabeler() {}
+
+bool ConnectedComponentLabeler::label(const VolumeData& volume, const uint16_t lowerThreshold,
+                                      const uint16_t upperThreshold,
+                                      const Connectivity connectivity,
+                                      ComponentLabels* const result,
+                                      const std::size_t numberOfThreads) {
+    const VolumeSize& size = volume.getSize();
+    const std::size_t voxelCount = volume.getVoxelCount();
+    if (voxelCount >= UINT32_MAX) {
+        // the parent index of a voxel does not fit into a label
+        return false;
+    }
+
+    ComponentLabels components;
+    components.size = size;
+    components.labels.resize(voxelCount, 0);
+    if (voxelCount == 0) {
+        *result = std::move(components);
+        return true;
+    }
+
+    uint32_t* const labels = components.labels.data();
+    const std::vector<NeighbourOffset> neighbours = getPreviousNeighbours(connectivity);
+    const std::size_t sliceSize = size.getX() * size.getY();
+
+    // several slabs per thread, so threads with fewer foreground voxels take over more slabs
+    const std::size_t slabThickness =
+        std::max<std::size_t>(1, size.getZ() / (4 * std::max<std::size_t>(numberOfThreads, 1)));
+    const std::size_t slabCount = (size.getZ() + slabThickness - 1) / slabThickness;
+    const auto getFirstVoxel = [&](const std::size_t slab) {
+        return slab * slabThickness * sliceSize;
+    };
+    const auto getLastVoxel = [&](const std::size_t slab) {
+        return std::min((slab + 1) * slabThickness, size.getZ()) * sliceSize;
+    };
+
+    // every step runs on all slabs and has to be finished before the next one starts
+    ThreadPool threadPool(numberOfThreads);
+    std::vector<std::future<void>> results;
+    const auto runOnSlabs = [&](const auto& task) {
+        results.clear();
+        for (std::size_t slab = 0; slab < slabCount; slab++) {
+            results.push_back(threadPool.enqueue([&task, slab]() { task(slab); }));
+        }
+        for (std::future<void>& result : results) {
+            result.wait();
+        }
+    };
+
+    runOnSlabs([&](const std::size_t slab) {
+        labelSlab(volume, lowerThreshold, upperThreshold, neighbours, slab * slabThickness,
+                  std::min((slab + 1) * slabThickness, size.getZ()), labels);
+    });
+    runOnSlabs([&](const std::size_t slab) {
+        if (slab > 0) {
+            mergeSlabBorder(size, neighbours, slab * slabThickness, labels);
+        }
+    });
+
+    // every voxel points to its root afterwards, roots are marked per slab
+    std::vector<std::vector<uint64_t>> rootMasks(slabCount);
+    std::vector<std::size_t> firstLabels(slabCount + 1, 1);
+    runOnSlabs([&](const std::size_t slab) {
+        const std::size_t firstVoxel = getFirstVoxel(slab);
+        const std::size_t lastVoxel = getLastVoxel(slab);
+        std::vector<uint64_t>& rootMask = rootMasks[slab];
+        rootMask.assign((lastVoxel - firstVoxel + 63) / 64, 0);
+
+        std::size_t rootCount = 0;
+        for (std::size_t index = firstVoxel; index < lastVoxel; index++) {
+            if (loadLabel(labels + index) == 0) {
+                continue;
+            }
+            // the whole path gets compressed, every label stays an ancestor of the voxel, so
+            // other threads can still follow it
+            const std::size_t root = findRootConcurrent(index, labels);
+            for (std::size_t current = index; current != root;) {
+                const std::size_t parent = loadLabel(labels + current) - 1;
+                storeLabel(labels + current, static_cast<uint32_t>(root + 1));
+                current = parent;
+            }
+            if (root == index) {
+                rootMask[(index - firstVoxel) / 64] |= uint64_t(1) << ((index - firstVoxel) % 64);
+                rootCount++;
+            }
+        }
+        firstLabels[slab + 1] = rootCount;
+    });
+    for (std::size_t slab = 0; slab < slabCount; slab++) {
+        firstLabels[slab + 1] += firstLabels[slab];
+    }
+
+    // roots get consecutive labels in voxel order
+    runOnSlabs([&](const std::size_t slab) {
+        const std::size_t firstVoxel = getFirstVoxel(slab);
+        uint32_t nextLabel = static_cast<uint32_t>(firstLabels[slab]);
+        for (std::size_t word = 0; word < rootMasks[slab].size(); word++) {
+            for (uint64_t bits = rootMasks[slab][word]; bits != 0; bits &= bits - 1) {
+                labels[firstVoxel + 64 * word + __builtin_ctzll(bits)] = nextLabel;
+                nextLabel++;
+            }
+        }
+    });
+
+    // the other voxels take the label of their root, runs of equal labels along x are counted
+    // into the components of the slab (dense for own roots, hashed for roots of earlier slabs)
+    std::vector<std::vector<ComponentBox>> slabBoxes(slabCount);
+    std::vector<std::unordered_map<uint32_t, ComponentBox>> previousSlabBoxes(slabCount);
+    runOnSlabs([&](const std::size_t slab) {
+        const std::size_t firstVoxel = getFirstVoxel(slab);
+        const std::size_t lastVoxel = getLastVoxel(slab);
+        const std::vector<uint64_t>& rootMask = rootMasks[slab];
+        std::vector<ComponentBox>& boxes = slabBoxes[slab];
+        boxes.resize(firstLabels[slab + 1] - firstLabels[slab]);
+
+        // large components cross many slabs, the last hashed one is kept
+        uint32_t previousLabel = 0;
+        ComponentBox* previousBox = nullptr;
+        const auto addRun = [&](const uint32_t label, const std::size_t firstX,
+                                const std::size_t lastX, const std::size_t y,
+                                const std::size_t z) {
+            if (label >= firstLabels[slab]) {
+                boxes[label - firstLabels[slab]].addRun(firstX, lastX, y, z);
+                return;
+            }
+            if (label != previousLabel) {
+                previousLabel = label;
+                previousBox = &previousSlabBoxes[slab][label];
+            }
+            previousBox->addRun(firstX, lastX, y, z);
+        };
+
+        for (std::size_t rowStart = firstVoxel; rowStart < lastVoxel; rowStart += size.getX()) {
+            const std::size_t y = (rowStart / size.getX()) % size.getY();
+            const std::size_t z = rowStart / sliceSize;
+            uint32_t runLabel = 0;
+            std::size_t runStart = 0;
+            for (std::size_t x = 0; x < size.getX(); x++) {
+                const std::size_t index = rowStart + x;
+                const std::size_t localIndex = index - firstVoxel;
+                uint32_t label = labels[index];
+                if (label != 0 && ((rootMask[localIndex / 64] >> (localIndex % 64)) & 1) == 0) {
+                    label = labels[label - 1];
+                    labels[index] = label;
+                }
+                if (label != runLabel) {
+                    if (runLabel != 0) {
+                        addRun(runLabel, runStart, x - 1, y, z);
+                    }
+                    runLabel = label;
+                    runStart = x;
+                }
+            }
+            if (runLabel != 0) {
+                addRun(runLabel, runStart, size.getX() - 1, y, z);
+            }
+        }
+    });
+
+    std::vector<ComponentBox> boxes(firstLabels[slabCount] - 1);
+    for (std::size_t slab = 0; slab < slabCount; slab++) {
+        for (std::size_t i = 0; i < slabBoxes[slab].size(); i++) {
+            boxes[firstLabels[slab] - 1 + i].add(slabBoxes[slab][i]);
+        }
+        for (const std::pair<const uint32_t, ComponentBox>& box : previousSlabBoxes[slab]) {
+            boxes[box.first - 1].add(box.second);
+        }
+    }
+
+    components.components.resize(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+        ConnectedComponent& component = components.components[i];
+        component.voxelCount = boxes[i].voxelCount;
+        component.offset = VolumeSize(boxes[i].first[0], boxes[i].first[1], boxes[i].first[2]);
+        component.size = VolumeSize(boxes[i].last[0] - boxes[i].first[0] + 1,
+                                    boxes[i].last[1] - boxes[i].first[1] + 1,
+                                    boxes[i].last[2] - boxes[i].first[2] + 1);
+    }
+
+    *result = std::move(components);
+    return true;
+}
+
+void ConnectedComponentLabeler::ComponentBox::addRun(const std::size_t firstX,
+                                                     const std::size_t lastX, const std::size_t y,
+                                                     const std::size_t z) {
+    voxelCount += lastX - firstX + 1;
+    first[0] = std::min(first[0], firstX);
+    first[1] = std::min(first[1], y);
+    first[2] = std::min(first[2], z);
+    last[0] = std::max(last[0], lastX);
+    last[1] = std::max(last[1], y);
+    last[2] = std::max(last[2], z);
+}
+
+void ConnectedComponentLabeler::ComponentBox::add(const ComponentBox& other) {
+    voxelCount += other.voxelCount;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        first[axis] = std::min(first[axis], other.first[axis]);
+        last[axis] = std::max(last[axis], other.last[axis]);
+    }
+}
+
+std::vector<ConnectedComponentLabeler::NeighbourOffset>
+ConnectedComponentLabeler::getPreviousNeighbours(const Connectivity connectivity) {
+    // number of axes a neighbour may differ in
+    const int maximumDistance =
+        (connectivity == Connectivity::Face) ? 1 : (connectivity == Connectivity::Edge) ? 2 : 3;
+
+    std::vector<NeighbourOffset> neighbours;
+    for (std::ptrdiff_t z = -1; z <= 0; z++) {
+        for (std::ptrdiff_t y = -1; y <= 1; y++) {
+            for (std::ptrdiff_t x = -1; x <= 1; x++) {
+                const bool previous = z < 0 || (z == 0 && (y < 0 || (y == 0 && x < 0)));
+                const int distance = (x != 0) + (y != 0) + (z != 0);
+                if (previous && distance <= maximumDistance) {
+                    neighbours.push_back({x, y, z});
+                }
+            }
+        }
+    }
+    return neighbours;
+}
+
+void ConnectedComponentLabeler::labelSlab(const VolumeData& volume, const uint16_t lowerThreshold,
+                                          const uint16_t upperThreshold,
+                                          const std::vector<NeighbourOffset>& neighbours,
+                                          const std::size_t firstSlice,
+                                          const std::size_t lastSlice, uint32_t* const labels) {
+    const VolumeSize& size = volume.getSize();
+    const uint16_t* const voxels = volume.getRawVolumeData().data();
+    const std::ptrdiff_t sizeX = static_cast<std::ptrdiff_t>(size.getX());
+    const std::ptrdiff_t sizeY = static_cast<std::ptrdiff_t>(size.getY());
+
+    std::vector<std::ptrdiff_t> indexOffsets;
+    for (const NeighbourOffset& offset : neighbours) {
+        indexOffsets.push_back(offset.x + sizeX * (offset.y + sizeY * offset.z));
+    }
+
+    for (std::ptrdiff_t z = firstSlice; z < static_cast<std::ptrdiff_t>(lastSlice); z++) {
+        for (std::ptrdiff_t y = 0; y < sizeY; y++) {
+            for (std::ptrdiff_t x = 0; x < sizeX; x++) {
+                const std::size_t index = x + sizeX * (y + sizeY * z);
+                if (voxels[index] < lowerThreshold || voxels[index] > upperThreshold) {
+                    continue;
+                }
+
+                // the voxel joins the tree of its first foreground neighbour, further trees get
+                // linked to the root with the lower index, so every root is the first voxel of
+                // its tree
+                const bool inner = x > 0 && x + 1 < sizeX && y > 0 && y + 1 < sizeY &&
+                                   z > static_cast<std::ptrdiff_t>(firstSlice);
+                std::size_t root = index;
+                labels[index] = static_cast<uint32_t>(index + 1);
+                for (std::size_t i = 0; i < neighbours.size(); i++) {
+                    if (!inner) {
+                        const std::ptrdiff_t neighbourX = x + neighbours[i].x;
+                        const std::ptrdiff_t neighbourY = y + neighbours[i].y;
+                        const std::ptrdiff_t neighbourZ = z + neighbours[i].z;
+                        if (neighbourX < 0 || neighbourX >= sizeX || neighbourY < 0 ||
+                            neighbourY >= sizeY ||
+                            neighbourZ < static_cast<std::ptrdiff_t>(firstSlice)) {
+                            // outside of the slab
+                            continue;
+                        }
+                    }
+
+                    const std::size_t neighbour = index + indexOffsets[i];
+                    if (labels[neighbour] == 0 || labels[neighbour] - 1 == root) {
+                        continue;
+                    }
+                    const std::size_t neighbourRoot = findRoot(neighbour, labels);
+                    if (neighbourRoot < root) {
+                        labels[root] = static_cast<uint32_t>(neighbourRoot + 1);
+                        root = neighbourRoot;
+                    } else if (root < neighbourRoot) {
+                        labels[neighbourRoot] = static_cast<uint32_t>(root + 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ConnectedComponentLabeler::mergeSlabBorder(const VolumeSize& size,
+                                                const std::vector<NeighbourOffset>& neighbours,
+                                                const std::size_t firstSlice,
+                                                uint32_t* const labels) {
+    const std::ptrdiff_t sizeX = static_cast<std::ptrdiff_t>(size.getX());
+    const std::ptrdiff_t sizeY = static_cast<std::ptrdiff_t>(size.getY());
+    const std::ptrdiff_t z = static_cast<std::ptrdiff_t>(firstSlice);
+
+    for (std::ptrdiff_t y = 0; y < sizeY; y++) {
+        for (std::ptrdiff_t x = 0; x < sizeX; x++) {
+            const std::size_t index = x + sizeX * (y + sizeY * z);
+            if (loadLabel(labels + index) == 0) {
+                continue;
+            }
+
+            for (const NeighbourOffset& offset : neighbours) {
+                const std::ptrdiff_t neighbourX = x + offset.x;
+                const std::ptrdiff_t neighbourY = y + offset.y;
+                if (offset.z == 0 || neighbourX < 0 || neighbourX >= sizeX || neighbourY < 0 ||
+                    neighbourY >= sizeY) {
+                    // only neighbours in the previous slab
+                    continue;
+                }
+                const std::size_t neighbour = neighbourX + sizeX * (neighbourY + sizeY * (z - 1));
+                if (loadLabel(labels + neighbour) != 0) {
+                    uniteConcurrent(index, neighbour, labels);
+                }
+            }
+        }
+    }
+}
+
+std::size_t ConnectedComponentLabeler::findRoot(const std::size_t index, uint32_t* const labels) {
+    // path halving, every visited voxel points to its grandparent afterwards
+    std::size_t current = index;
+    while (labels[current] - 1 != current) {
+        labels[current] = labels[labels[current] - 1];
+        current = labels[current] - 1;
+    }
+    return current;
+}
+
+std::size_t ConnectedComponentLabeler::findRootConcurrent(const std::size_t index,
+                                                          const uint32_t* const labels) {
+    std::size_t current = index;
+    std::size_t parent = loadLabel(labels + current) - 1;
+    while (parent != current) {
+        current = parent;
+        parent = loadLabel(labels + current) - 1;
+    }
+    return current;
+}
+
+void ConnectedComponentLabeler::uniteConcurrent(const std::size_t indexA,
+                                                const std::size_t indexB,
+                                                uint32_t* const labels) {
+    // a root only gets linked to a root with a lower index, if another thread changed the root
+    // in between the compare and swap fails and the roots are searched again
+    while (true) {
+        std::size_t rootA = findRootConcurrent(indexA, labels);
+        std::size_t rootB = findRootConcurrent(indexB, labels);
+        if (rootA == rootB) {
+            return;
+        }
+        if (rootA < rootB) {
+            std::swap(rootA, rootB);
+        }
+
+        uint32_t expected = static_cast<uint32_t>(rootA + 1);
+        if (__atomic_compare_exchange_n(labels + rootA, &expected,
+                                        static_cast<uint32_t>(rootB + 1), false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+} // namespace VDTK
@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Connected components of the voxels inside of a value interval. The label volume itself is a
+// union find forest (label = index of the parent voxel + 1). Slabs of slices are labeled in
+// parallel, the slab borders get merged afterwards with lock free unions (compare and swap on the
+// roots) and at last all trees are flattened to consecutive labels
+class ConnectedComponentLabeler {
+public:
+    ConnectedComponentLabeler();
+    ~ConnectedComponentLabeler();
+
+    // foreground are all voxels in [lowerThreshold, upperThreshold]
+    // returns false if the volume has UINT32_MAX or more voxels
+    static bool label(const VolumeData& volume, const uint16_t lowerThreshold,
+                      const uint16_t upperThreshold, const Connectivity connectivity,
+                      ComponentLabels* const result, const std::size_t numberOfThreads);
+
+private:
+    // offset of a neighbour that comes before the voxel in zyx order
+    struct NeighbourOffset {
+        std::ptrdiff_t x;
+        std::ptrdiff_t y;
+        std::ptrdiff_t z;
+    };
+
+    // voxel count and bounding box [first, last] while the components get collected
+    struct ComponentBox {
+        uint64_t voxelCount = 0;
+        std::array<std::size_t, 3> first = {SIZE_MAX, SIZE_MAX, SIZE_MAX};
+        std::array<std::size_t, 3> last = {0, 0, 0};
+
+        // adds the voxels [firstX, lastX] of a row
+        void addRun(const std::size_t firstX, const std::size_t lastX, const std::size_t y,
+                    const std::size_t z);
+        void add(const ComponentBox& other);
+    };
+
+    static std::vector<NeighbourOffset> getPreviousNeighbours(const Connectivity connectivity);
+
+    // labels the slices [firstSlice, lastSlice) without looking at other slices
+    static void labelSlab(const VolumeData& volume, const uint16_t lowerThreshold,
+                          const uint16_t upperThreshold,
+                          const std::vector<NeighbourOffset>& neighbours,
+                          const std::size_t firstSlice, const std::size_t lastSlice,
+                          uint32_t* const labels);
+    // joins the components of firstSlice with the ones of the slice before, other threads may
+    // merge at the same time
+    static void mergeSlabBorder(const VolumeSize& size,
+                                const std::vector<NeighbourOffset>& neighbours,
+                                const std::size_t firstSlice, uint32_t* const labels);
+
+    // root voxel of the tree of the voxel, compresses the path (only for a single thread)
+    static std::size_t findRoot(const std::size_t index, uint32_t* const labels);
+    // thread safe versions without path compression
+    static std::size_t findRootConcurrent(const std::size_t index, const uint32_t* const labels);
+    static void uniteConcurrent(const std::size_t indexA, const std::size_t indexB,
+                                uint32_t* const labels);
+};
+} // namespace VDTK
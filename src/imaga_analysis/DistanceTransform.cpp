@@ -0,0 +1,173 @@
+
+#include <cmath>
+#include <limits>
+#include <threadpool/ThreadPool.h>
+
+#include "DistanceTransform.h"
+
+namespace VDTK {
+DistanceTransform::DistanceTransform() {}
+
+DistanceTransform::~DistanceTransform() {}
+
+DistanceMap DistanceTransform::compute(const VolumeData& volume, const uint16_t lowerThreshold,
+                                       const uint16_t upperThreshold, const bool signedDistance,
+                                       const std::size_t numberOfThreads) {
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    const uint16_t* const voxels = volume.getRawVolumeData().data();
+    const std::size_t voxelCount = volume.getVoxelCount();
+    const std::size_t sliceSize = volume.getSize().getX() * volume.getSize().getY();
+    const auto isInside = [&](const std::size_t index) {
+        return voxels[index] >= lowerThreshold && voxels[index] <= upperThreshold;
+    };
+    // runs a task on the voxels [first, last) of every slice in parallel
+    const auto forEachSlice = [&](const auto& task) {
+        ThreadPool threadPool(numberOfThreads);
+        for (std::size_t first = 0; first < voxelCount; first += sliceSize) {
+            threadPool.enqueue([&task, first, sliceSize]() { task(first, first + sliceSize); });
+        }
+    };
+
+    DistanceMap map;
+    map.size = volume.getSize();
+    map.distances.resize(voxelCount);
+    forEachSlice([&](const std::size_t first, const std::size_t last) {
+        for (std::size_t index = first; index < last; index++) {
+            map.distances[index] = isInside(index) ? 0.0f : infinity;
+        }
+    });
+    transform(map.size, volume.getSpacing(), &map.distances, numberOfThreads);
+
+    if (!signedDistance) {
+        forEachSlice([&](const std::size_t first, const std::size_t last) {
+            for (std::size_t index = first; index < last; index++) {
+                map.distances[index] = std::sqrt(map.distances[index]);
+            }
+        });
+        return map;
+    }
+
+    // distances inside of the mask to the voxels outside of it
+    std::vector<float> insideDistances(voxelCount);
+    forEachSlice([&](const std::size_t first, const std::size_t last) {
+        for (std::size_t index = first; index < last; index++) {
+            insideDistances[index] = isInside(index) ? infinity : 0.0f;
+        }
+    });
+    transform(map.size, volume.getSpacing(), &insideDistances, numberOfThreads);
+
+    forEachSlice([&](const std::size_t first, const std::size_t last) {
+        for (std::size_t index = first; index < last; index++) {
+            map.distances[index] = isInside(index) ? -std::sqrt(insideDistances[index])
+                                                   : std::sqrt(map.distances[index]);
+        }
+    });
+    return map;
+}
+
+void DistanceTransform::transform(const VolumeSize& size, const VolumeSpacing& spacing,
+                                  std::vector<float>* const squaredDistances,
+                                  const std::size_t numberOfThreads) {
+    const std::size_t sizeX = size.getX();
+    const std::size_t sizeY = size.getY();
+    const std::size_t sizeZ = size.getZ();
+    float* const data = squaredDistances->data();
+
+    // every pass has to be finished before the next axis starts
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // rows along x and columns along y of one slice
+        for (std::size_t z = 0; z < sizeZ; z++) {
+            threadPool.enqueue([&, z]() {
+                float* const slice = data + sizeX * sizeY * z;
+                for (std::size_t y = 0; y < sizeY; y++) {
+                    transformLine(slice + sizeX * y, 1, sizeX, spacing.getX());
+                }
+                for (std::size_t x = 0; x < sizeX; x++) {
+                    transformLine(slice + x, sizeX, sizeY, spacing.getY());
+                }
+            });
+        }
+    }
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        // neighbouring lines along z share their cache lines
+        for (std::size_t y = 0; y < sizeY; y++) {
+            threadPool.enqueue([&, y]() {
+                for (std::size_t x = 0; x < sizeX; x++) {
+                    transformLine(data + x + sizeX * y, sizeX * sizeY, sizeZ, spacing.getZ());
+                }
+            });
+        }
+    }
+}
+
+void DistanceTransform::transformLine(float* const line, const std::size_t stride,
+                                      const std::size_t length, const float voxelDistance) {
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+
+    // every worker thread keeps its buffers
+    thread_local std::vector<float> values;
+    // voxels of the parabolas of the lower envelope and the positions where they begin
+    thread_local std::vector<std::size_t> parabolas;
+    thread_local std::vector<double> boundaries;
+    values.resize(length);
+    parabolas.resize(length);
+    boundaries.resize(length + 1);
+
+    for (std::size_t i = 0; i < length; i++) {
+        values[i] = line[i * stride];
+    }
+
+    // intersection of the parabolas of two voxels, in double because the squared positions
+    // exceed the precision of float
+    const auto intersect = [&](const std::size_t a, const std::size_t b) {
+        const double positionA = static_cast<double>(a) * voxelDistance;
+        const double positionB = static_cast<double>(b) * voxelDistance;
+        return ((values[b] + positionB * positionB) - (values[a] + positionA * positionA)) /
+               (2.0 * (positionB - positionA));
+    };
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        if (values[i] == infinity) {
+            continue;
+        }
+        // parabolas that are hidden below the new one get removed
+        double boundary = -std::numeric_limits<double>::infinity();
+        while (count > 0) {
+            boundary = intersect(parabolas[count - 1], i);
+            if (boundary > boundaries[count - 1]) {
+                break;
+            }
+            count--;
+            boundary = -std::numeric_limits<double>::infinity();
+        }
+        parabolas[count] = i;
+        boundaries[count] = boundary;
+        count++;
+    }
+    if (count == 0) {
+        // nothing to measure to, the line stays infinity
+        return;
+    }
+
+    boundaries[count] = std::numeric_limits<double>::infinity();
+    std::size_t parabola = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        const double position = static_cast<double>(i) * voxelDistance;
+        while (boundaries[parabola + 1] < position) {
+            parabola++;
+        }
+        const float offset = static_cast<float>(
+            position - static_cast<double>(parabolas[parabola]) * voxelDistance);
+        line[i * stride] = offset * offset + values[parabolas[parabola]];
+    }
+}
+} // namespace VDTK
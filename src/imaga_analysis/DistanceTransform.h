@@ -0,0 +1,30 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Exact euclidean distance transform of the voxels inside of a value interval (mask) after
+// Felzenszwalb and Huttenlocher. Squared distances are separable, so one pass per axis computes
+// the lower envelope of parabolas along every line in linear time. The lines of a pass are
+// processed in parallel
+class DistanceTransform {
+public:
+    DistanceTransform();
+    ~DistanceTransform();
+
+    // distance of every voxel to the nearest mask voxel (0 inside of the mask). Signed distances
+    // are negative inside of the mask: the distance to the nearest voxel outside of the mask.
+    // Without any voxel to measure to the distance is infinity
+    static DistanceMap compute(const VolumeData& volume, const uint16_t lowerThreshold,
+                               const uint16_t upperThreshold, const bool signedDistance,
+                               const std::size_t numberOfThreads);
+
+private:
+    // squared distances to the voxels that are 0 in the map (the others have to be infinity)
+    static void transform(const VolumeSize& size, const VolumeSpacing& spacing,
+                          std::vector<float>* const squaredDistances,
+                          const std::size_t numberOfThreads);
+    // one dimensional transform of a line with the distance between two voxels
+    static void transformLine(float* const line, const std::size_t stride,
+                              const std::size_t length, const float voxelDistance);
+};
+} // namespace VDTK
@@ -0,0 +1,117 @@
+
+#include <threadpool/ThreadPool.h>
+
+#include "RegionGrower.h"
+
+namespace VDTK {
+RegionGrower::RegionGrower() {}
+
+RegionGrower::~RegionGrower() {}
+
+VolumeMask RegionGrower::grow(const VolumeData& volume, const std::vector<VolumeSize>& seeds,
+                              const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                              const std::size_t numberOfThreads) {
+    const VolumeSize& size = volume.getSize();
+    VolumeMask mask(size);
+    uint64_t* const words = mask.getWords().data();
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (const VolumeSize& seed : seeds) {
+            if (seed.getX() >= size.getX() || seed.getY() >= size.getY() ||
+                seed.getZ() >= size.getZ()) {
+                // seed is not inside of the volume
+                continue;
+            }
+            const std::size_t seedIndex =
+                seed.getX() + size.getX() * (seed.getY() + size.getY() * seed.getZ());
+            threadPool.enqueue([&, seedIndex]() {
+                growSeed(volume, seedIndex, lowerThreshold, upperThreshold, words);
+            });
+        }
+    }
+    return mask;
+}
+
+void RegionGrower::growSeed(const VolumeData& volume, const std::size_t seedIndex,
+                            const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                            uint64_t* const mask) {
+    const std::size_t sizeX = volume.getSize().getX();
+    const std::size_t sizeY = volume.getSize().getY();
+    const std::size_t sizeZ = volume.getSize().getZ();
+    const uint16_t* const voxels = volume.getRawVolumeData().data();
+
+    const auto isInside = [&](const std::size_t index) {
+        return voxels[index] >= lowerThreshold && voxels[index] <= upperThreshold;
+    };
+    // other tasks may claim voxels at any time
+    const auto isVisited = [&](const std::size_t index) {
+        return ((__atomic_load_n(mask + index / 64, __ATOMIC_RELAXED) >> (index % 64)) & 1) != 0;
+    };
+
+    // first voxels of runs that still have to be filled
+    std::vector<std::size_t> pendingRuns(1, seedIndex);
+    // bits of the current run claimed by this task, from the word of the first voxel on
+    std::vector<uint64_t> claimedBits;
+
+    while (!pendingRuns.empty()) {
+        const std::size_t index = pendingRuns.back();
+        pendingRuns.pop_back();
+        if (!isInside(index) || isVisited(index)) {
+            continue;
+        }
+
+        // the run reaches as far along x as the voxels are inside and not visited
+        const std::size_t rowStart = index - index % sizeX;
+        std::size_t first = index;
+        while (first > rowStart && isInside(first - 1) && !isVisited(first - 1)) {
+            first--;
+        }
+        std::size_t last = index;
+        while (last + 1 < rowStart + sizeX && isInside(last + 1) && !isVisited(last + 1)) {
+            last++;
+        }
+
+        // claims the whole run word by word, voxels another task claimed in between belong to
+        // that task
+        const std::size_t firstWord = first / 64;
+        claimedBits.assign(last / 64 - firstWord + 1, 0);
+        for (std::size_t word = firstWord; word <= last / 64; word++) {
+            const std::size_t firstBit = (word == firstWord) ? first % 64 : 0;
+            const std::size_t lastBit = (word == last / 64) ? last % 64 : 63;
+            const uint64_t bits = (~uint64_t(0) >> (63 - lastBit)) & (~uint64_t(0) << firstBit);
+            claimedBits[word - firstWord] =
+                bits & ~__atomic_fetch_or(mask + word, bits, __ATOMIC_RELAXED);
+        }
+        const auto isClaimed = [&](const std::size_t voxel) {
+            return ((claimedBits[voxel / 64 - firstWord] >> (voxel % 64)) & 1) != 0;
+        };
+
+        // every piece of a neighbouring row next to the claimed voxels gets one pending run
+        const std::size_t y = (index / sizeX) % sizeY;
+        const std::size_t z = index / (sizeX * sizeY);
+        const std::size_t sliceSize = sizeX * sizeY;
+        const std::array<bool, 4> hasNeighbourRow = {y > 0, y + 1 < sizeY, z > 0, z + 1 < sizeZ};
+        const std::array<std::size_t, 4> neighbourOffsets = {sizeX, sizeX, sliceSize, sliceSize};
+        for (std::size_t row = 0; row < 4; row++) {
+            if (!hasNeighbourRow[row]) {
+                continue;
+            }
+            bool previousPending = false;
+            for (std::size_t voxel = first; voxel <= last; voxel++) {
+                const std::size_t neighbour =
+                    (row % 2 == 0) ? voxel - neighbourOffsets[row] : voxel + neighbourOffsets[row];
+                const bool pending =
+                    isClaimed(voxel) && isInside(neighbour) && !isVisited(neighbour);
+                if (pending && !previousPending) {
+                    pendingRuns.push_back(neighbour);
+                }
+                previousPending = pending;
+            }
+        }
+    }
+}
+} // namespace VDTK
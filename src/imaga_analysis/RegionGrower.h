@@ -0,0 +1,25 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Scanline flood fill of the voxels inside of a value interval (6 neighbours). Whole runs along x
+// get claimed at once in a shared bit mask (atomic or on its words) and only the start of every
+// run in the neighbouring rows gets pushed. Every seed is grown by its own task, regions of seeds
+// that meet are filled only once
+class RegionGrower {
+public:
+    RegionGrower();
+    ~RegionGrower();
+
+    // voxels in [lowerThreshold, upperThreshold] connected to one of the seeds, seeds outside of
+    // the volume or the interval are ignored
+    static VolumeMask grow(const VolumeData& volume, const std::vector<VolumeSize>& seeds,
+                           const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                           const std::size_t numberOfThreads);
+
+private:
+    static void growSeed(const VolumeData& volume, const std::size_t seedIndex,
+                         const uint16_t lowerThreshold, const uint16_t upperThreshold,
+                         uint64_t* const mask);
+};
+} // namespace VDTK
@@ -0,0 +1,192 @@
+#include <random>
+#include <threadpool/ThreadPool.h>
+
+#include "StatisticsSampler.h"
+
+namespace VDTK {
+namespace {
+struct PartialSample {
+    std::vector<double> histogram;
+    uint64_t sampleCount = 0;
+    bool exact = true;
+};
+} // namespace
+
+StatisticsSampler::StatisticsSampler() {}
+
+StatisticsSampler::~StatisticsSampler() {
+    stopRefinement();
+}
+
+ApproximateVolumeStatistics StatisticsSampler::sample(const VolumeData& volume,
+                                                      const std::size_t samplesPerBrick,
+                                                      const std::size_t numberOfThreads) {
+    ApproximateVolumeStatistics statistics;
+    sampleBricks(volume, samplesPerBrick, numberOfThreads, nullptr, &statistics);
+    return statistics;
+}
+
+void StatisticsSampler::startRefinement(const VolumeData& volume,
+                                        const std::size_t initialSamplesPerBrick,
+                                        const std::size_t numberOfThreads) {
+    stopRefinement();
+    m_stopRefinement = false;
+
+    m_refinement = std::async(std::launch::async, [this, &volume, initialSamplesPerBrick,
+                                                   numberOfThreads]() {
+        const std::size_t brickVoxelCount = m_brickSize * m_brickSize * m_brickSize;
+        std::size_t samplesPerBrick = std::max<std::size_t>(initialSamplesPerBrick, 1);
+        while (!m_stopRefinement) {
+            ApproximateVolumeStatistics statistics;
+            if (!sampleBricks(volume, samplesPerBrick, numberOfThreads, &m_stopRefinement,
+                              &statistics)) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_refinedStatisticsMutex);
+                m_refinedStatistics = std::move(statistics);
+            }
+            if (samplesPerBrick >= brickVoxelCount) {
+                // every voxel was counted
+                return;
+            }
+            samplesPerBrick = std::min(samplesPerBrick * m_refinementFactor, brickVoxelCount);
+        }
+    });
+}
+
+void StatisticsSampler::stopRefinement() {
+    if (m_refinement.valid()) {
+        m_stopRefinement = true;
+        m_refinement.wait();
+        m_refinement = std::future<void>();
+    }
+}
+
+ApproximateVolumeStatistics StatisticsSampler::getRefinedStatistics() const {
+    std::lock_guard<std::mutex> lock(m_refinedStatisticsMutex);
+    return m_refinedStatistics;
+}
+
+bool StatisticsSampler::sampleBricks(const VolumeData& volume, const std::size_t samplesPerBrick,
+                                     const std::size_t numberOfThreads,
+                                     const std::atomic<bool>* const stop,
+                                     ApproximateVolumeStatistics* const statistics) {
+    const VolumeSize size = volume.getSize();
+    const uint16_t* const data = volume.getRawVolumeData().data();
+    const VolumeSize gridSize((size.getX() + m_brickSize - 1) / m_brickSize,
+                              (size.getY() + m_brickSize - 1) / m_brickSize,
+                              (size.getZ() + m_brickSize - 1) / m_brickSize);
+    const std::size_t brickCount = gridSize.getX() * gridSize.getY() * gridSize.getZ();
+    if (brickCount == 0 || samplesPerBrick == 0) {
+        return false;
+    }
+
+    // every task samples a range of bricks into its own histogram
+    const std::size_t bricksPerTask = (brickCount + numberOfThreads - 1) / numberOfThreads;
+    std::vector<std::future<PartialSample>> results;
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t firstBrick = 0; firstBrick < brickCount; firstBrick += bricksPerTask) {
+            const std::size_t lastBrick = std::min(firstBrick + bricksPerTask, brickCount);
+            results.push_back(threadPool.enqueue([&, firstBrick, lastBrick]() {
+                PartialSample sample;
+                sample.histogram.resize(UINT16_MAX + 1, 0.0);
+                // positions inside of a brick in order and the swaps of the shuffle that draws
+                // the samples
+                std::vector<uint32_t> positions(m_brickSize * m_brickSize * m_brickSize);
+                std::vector<uint32_t> swaps(positions.size());
+                for (std::size_t i = 0; i < positions.size(); i++) {
+                    positions[i] = static_cast<uint32_t>(i);
+                }
+
+                for (std::size_t brickIndex = firstBrick; brickIndex < lastBrick; brickIndex++) {
+                    if (stop != nullptr && *stop) {
+                        sample.exact = false;
+                        sample.sampleCount = 0;
+                        return sample;
+                    }
+
+                    const std::size_t offsetX = (brickIndex % gridSize.getX()) * m_brickSize;
+                    const std::size_t offsetY =
+                        ((brickIndex / gridSize.getX()) % gridSize.getY()) * m_brickSize;
+                    const std::size_t offsetZ =
+                        (brickIndex / (gridSize.getX() * gridSize.getY())) * m_brickSize;
+                    const std::size_t sizeX = std::min(m_brickSize, size.getX() - offsetX);
+                    const std::size_t sizeY = std::min(m_brickSize, size.getY() - offsetY);
+                    const std::size_t sizeZ = std::min(m_brickSize, size.getZ() - offsetZ);
+                    const std::size_t brickVoxelCount = sizeX * sizeY * sizeZ;
+                    const auto getIndex = [&](const std::size_t x, const std::size_t y,
+                                              const std::size_t z) {
+                        return offsetX + x +
+                               size.getX() * (offsetY + y + size.getY() * (offsetZ + z));
+                    };
+
+                    if (samplesPerBrick >= brickVoxelCount) {
+                        // small bricks are counted completely
+                        for (std::size_t z = 0; z < sizeZ; z++) {
+                            for (std::size_t y = 0; y < sizeY; y++) {
+                                const uint16_t* const row = data + getIndex(0, y, z);
+                                for (std::size_t x = 0; x < sizeX; x++) {
+                                    sample.histogram[row[x]] += 1.0;
+                                }
+                            }
+                        }
+                        sample.sampleCount += brickVoxelCount;
+                        continue;
+                    }
+
+                    // the same brick gets the same samples in every call
+                    std::mt19937 generator(static_cast<uint32_t>(brickIndex * 2654435761u) ^
+                                           static_cast<uint32_t>(samplesPerBrick));
+                    // every sample stands for brick voxel count / samples voxels
+                    const double weight = static_cast<double>(brickVoxelCount) /
+                                          static_cast<double>(samplesPerBrick);
+                    // partial Fisher-Yates shuffle, so no voxel is drawn twice
+                    for (std::size_t i = 0; i < samplesPerBrick; i++) {
+                        std::uniform_int_distribution<uint32_t> distribution(
+                            static_cast<uint32_t>(i), static_cast<uint32_t>(brickVoxelCount - 1));
+                        swaps[i] = distribution(generator);
+                        std::swap(positions[i], positions[swaps[i]]);
+                        const std::size_t position = positions[i];
+                        const std::size_t x = position % sizeX;
+                        const std::size_t y = (position / sizeX) % sizeY;
+                        const std::size_t z = position / (sizeX * sizeY);
+                        sample.histogram[data[getIndex(x, y, z)]] += weight;
+                    }
+                    // undoing the swaps puts the positions back in order for the next brick
+                    for (std::size_t i = samplesPerBrick; i-- > 0;) {
+                        std::swap(positions[i], positions[swaps[i]]);
+                    }
+                    sample.sampleCount += samplesPerBrick;
+                    sample.exact = false;
+                }
+                return sample;
+            }));
+        }
+    }
+
+    std::vector<double> histogram(UINT16_MAX + 1, 0.0);
+    uint64_t sampleCount = 0;
+    bool exact = true;
+    for (std::future<PartialSample>& result : results) {
+        const PartialSample sample = result.get();
+        for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+            histogram[value] += sample.histogram[value];
+        }
+        sampleCount += sample.sampleCount;
+        exact = exact && sample.exact;
+    }
+
+    if (stop != nullptr && *stop) {
+        return false;
+    }
+    *statistics = ApproximateVolumeStatistics(std::move(histogram), sampleCount,
+                                              volume.getVoxelCount(), exact);
+    return true;
+}
+} // namespace VDTK
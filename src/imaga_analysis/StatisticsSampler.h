@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <future>
+#include <mutex>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Estimates statistics from a stratified random sample: every brick of the volume contributes
+// the same number of random voxels, so all regions are covered and the voxels of a brick are
+// close in memory. The estimate can be refined in the background until it is exact
+class StatisticsSampler {
+public:
+    StatisticsSampler();
+    // stops the refinement
+    ~StatisticsSampler();
+
+    static ApproximateVolumeStatistics sample(const VolumeData& volume,
+                                              const std::size_t samplesPerBrick,
+                                              const std::size_t numberOfThreads);
+
+    // samples with more and more voxels per brick until every voxel is counted. The volume must
+    // not change until the refinement is finished or stopped
+    void startRefinement(const VolumeData& volume, const std::size_t initialSamplesPerBrick,
+                         const std::size_t numberOfThreads);
+    // waits for the running sampling round to stop, the last estimate stays available
+    void stopRefinement();
+    // the most precise estimate so far
+    ApproximateVolumeStatistics getRefinedStatistics() const;
+
+private:
+    // false if stopped before all bricks were sampled
+    static bool sampleBricks(const VolumeData& volume, const std::size_t samplesPerBrick,
+                             const std::size_t numberOfThreads,
+                             const std::atomic<bool>* const stop,
+                             ApproximateVolumeStatistics* const statistics);
+
+    static constexpr std::size_t m_brickSize = 16;
+    // samples per brick grow by this factor every round
+    static constexpr std::size_t m_refinementFactor = 4;
+
+    std::future<void> m_refinement;
+    std::atomic<bool> m_stopRefinement = false;
+    mutable std::mutex m_refinedStatisticsMutex;
+    ApproximateVolumeStatistics m_refinedStatistics;
+};
+} // namespace VDTK
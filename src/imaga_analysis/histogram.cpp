@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <threadpool/ThreadPool.h>
 #include "histogram.h"
 #include "../filter/WindowFilter.h"
 
@@ -50,3 +51,65 @@ const std::vector<uint16_t> VDTK::HistogramGenerator::getHistogramWidthWindowing
     }
     return histo;
 }
+
+std::vector<uint64_t> VDTK::HistogramGenerator::getFullHistogram(
+    const VolumeData& volume, const std::size_t numberOfThreads) {
+    const uint16_t* const data = volume.getRawVolumeData().data();
+    const std::size_t voxelCount = volume.getVoxelCount();
+    std::vector<uint64_t> histogram(UINT16_MAX + 1, 0);
+    if (voxelCount == 0) {
+        return histogram;
+    }
+
+    // the 32 bit counts of a partial histogram can not overflow
+    const std::size_t taskVoxelCount =
+        std::min<std::size_t>((voxelCount + numberOfThreads - 1) / numberOfThreads, UINT32_MAX);
+    std::vector<std::future<std::vector<uint32_t>>> results;
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t first = 0; first < voxelCount; first += taskVoxelCount) {
+            const std::size_t last = std::min(first + taskVoxelCount, voxelCount);
+            results.push_back(threadPool.enqueue(&countValues, data + first, data + last));
+        }
+
+        // partial histograms get merged as soon as they are finished
+        for (std::future<std::vector<uint32_t>>& result : results) {
+            const std::vector<uint32_t> partialHistogram = result.get();
+            for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+                histogram[value] += partialHistogram[value];
+            }
+        }
+    }
+    return histogram;
+}
+
+std::vector<uint32_t> VDTK::HistogramGenerator::countValues(const uint16_t* const first,
+                                                            const uint16_t* const last) {
+    // runs of equal values would wait for the previous increment of the same counter, four
+    // interleaved histograms let consecutive voxels use different counters
+    std::vector<uint32_t> counts(4 * (UINT16_MAX + 1), 0);
+    uint32_t* const counts0 = counts.data();
+    uint32_t* const counts1 = counts0 + UINT16_MAX + 1;
+    uint32_t* const counts2 = counts1 + UINT16_MAX + 1;
+    uint32_t* const counts3 = counts2 + UINT16_MAX + 1;
+
+    const uint16_t* position = first;
+    for (; position + 4 <= last; position += 4) {
+        counts0[position[0]]++;
+        counts1[position[1]]++;
+        counts2[position[2]]++;
+        counts3[position[3]]++;
+    }
+    for (; position < last; position++) {
+        counts0[*position]++;
+    }
+
+    for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+        counts0[value] += counts1[value] + counts2[value] + counts3[value];
+    }
+    counts.resize(UINT16_MAX + 1);
+    return counts;
+}
@@ -11,8 +11,14 @@ public:
                                                                   int32_t windowCenter,
                                                                   int32_t windowWidth,
                                                                   int32_t windowOffset);
+    // number of voxels per value without overflow, counted in parallel
+    static std::vector<uint64_t> getFullHistogram(const VolumeData& volume,
+                                                  const std::size_t numberOfThreads);
 
 private:
+    // counts [first, last) into a partial histogram
+    static std::vector<uint32_t> countValues(const uint16_t* const first,
+                                             const uint16_t* const last);
 };
 
 } // namespace VDTK
\ No newline at end of file
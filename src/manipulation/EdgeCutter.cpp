@@ -1,144 +1,240 @@
+#include <cstring>
+#include <threadpool/ThreadPool.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../imaga_analysis/BrickMinMaxMap.h"
 #include "EdgeCutter.h"
 
 namespace VDTK {
+namespace {
+struct BoundingBox {
+    bool found = false;
+    std::size_t firstX = SIZE_MAX;
+    std::size_t firstY = SIZE_MAX;
+    std::size_t firstZ = SIZE_MAX;
+    std::size_t lastX = 0;
+    std::size_t lastY = 0;
+    std::size_t lastZ = 0;
+};
+} // namespace
+
 EdgeCutter::EdgeCutter() {}
 
 EdgeCutter::~EdgeCutter() {}
 
-void EdgeCutter::cutBorders(VolumeData* const volume, const uint16_t threshold) {
-    std::size_t lowerBorderX = 0;
-    std::size_t upperBorderX = 0;
-    std::size_t lowerBorderY = 0;
-    std::size_t upperBorderY = 0;
-    std::size_t lowerBorderZ = 0;
-    std::size_t upperBorderZ = 0;
-
-    bool borderNotFound = true;
-
-    // find lowerBorderX
-    for (std::size_t positionX = 0; borderNotFound && positionX < volume->getSize().getX();
-         positionX++) {
-        for (std::size_t positionY = 0; borderNotFound && positionY < volume->getSize().getY();
-             positionY++) {
-            for (std::size_t positionZ = 0; borderNotFound && positionZ < volume->getSize().getZ();
-                 positionZ++) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    lowerBorderX = positionX;
-                    borderNotFound = false;
-                }
-            }
-        }
+void EdgeCutter::cutBorders(VolumeData* const volume, const uint16_t threshold,
+                            const std::size_t numberOfThreads,
+                            const BrickMinMaxMap* const bricks) {
+    VolumeSize offset(0);
+    VolumeSize size(0);
+    if (!findBoundingBox(*volume, threshold, &offset, &size, numberOfThreads, bricks)) {
+        // nothing above the threshold, there is nothing to keep
+        return;
     }
 
-    borderNotFound = true;
-
-    // find upperBorderX
-    for (std::size_t positionX = volume->getSize().getX() - 1;
-         borderNotFound && positionX > lowerBorderX; positionX--) {
-        for (std::size_t positionY = volume->getSize().getY() - 1; borderNotFound && positionY > 0;
-             positionY--) {
-            for (std::size_t positionZ = volume->getSize().getZ() - 1;
-                 borderNotFound && positionZ > 0; positionZ--) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    upperBorderX = positionX;
-                    borderNotFound = false;
-                }
-            }
-        }
+    // if no borders have to be cut, no creation of a new volume is needed
+    if (size != volume->getSize()) {
+        crop(volume, offset, size, numberOfThreads);
     }
+}
 
-    borderNotFound = true;
+bool EdgeCutter::crop(VolumeData* const volume, const VolumeSize& offset, const VolumeSize& size,
+                      const std::size_t numberOfThreads) {
+    const VolumeSize volumeSize = volume->getSize();
+    if (size.getX() == 0 || size.getY() == 0 || size.getZ() == 0 ||
+        offset.getX() + size.getX() > volumeSize.getX() ||
+        offset.getY() + size.getY() > volumeSize.getY() ||
+        offset.getZ() + size.getZ() > volumeSize.getZ()) {
+        // box is not inside of the volume
+        return false;
+    }
 
-    // find lowerBorderY
-    for (std::size_t positionY = 0; borderNotFound && positionY < volume->getSize().getY();
-         positionY++) {
-        for (std::size_t positionX = lowerBorderX; borderNotFound && positionX <= upperBorderX;
-             positionX++) {
-            for (std::size_t positionZ = 0; borderNotFound && positionZ < volume->getSize().getZ();
-                 positionZ++) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    lowerBorderY = positionY;
-                    borderNotFound = false;
+    VolumeData newVolume(size, volume->getSpacing());
+    const uint16_t* const source = volume->getRawVolumeData().data();
+    uint16_t* const destination = newVolume.getRawVolumeData().data();
+
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t positionZ = 0; positionZ < size.getZ(); positionZ++) {
+            threadPool.enqueue([&, positionZ]() {
+                // rows of the box are contiguous in both volumes
+                for (std::size_t positionY = 0; positionY < size.getY(); positionY++) {
+                    const std::size_t sourceIndex =
+                        offset.getX() +
+                        volumeSize.getX() * (offset.getY() + positionY +
+                                             volumeSize.getY() * (offset.getZ() + positionZ));
+                    const std::size_t destinationIndex =
+                        size.getX() * (positionY + size.getY() * positionZ);
+                    std::memcpy(destination + destinationIndex, source + sourceIndex,
+                                size.getX() * sizeof(uint16_t));
                 }
-            }
+            });
         }
     }
 
-    borderNotFound = true;
+    *volume = std::move(newVolume);
+    return true;
+}
 
-    // find upperBorderY
-    for (std::size_t positionY = volume->getSize().getY() - 1;
-         borderNotFound && positionY > lowerBorderY; positionY--) {
-        for (std::size_t positionX = lowerBorderX; borderNotFound && positionX <= upperBorderX;
-             positionX++) {
-            for (std::size_t positionZ = 0; borderNotFound && positionZ < volume->getSize().getZ();
-                 positionZ++) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    upperBorderY = positionY;
-                    borderNotFound = false;
-                }
-            }
-        }
+bool EdgeCutter::findBoundingBox(const VolumeData& volume, const uint16_t threshold,
+                                 VolumeSize* const offset, VolumeSize* const size,
+                                 const std::size_t numberOfThreads,
+                                 const BrickMinMaxMap* const bricks) {
+    const VolumeSize volumeSize = volume.getSize();
+    const uint16_t* const data = volume.getRawVolumeData().data();
+    if (volume.getVoxelCount() == 0) {
+        return false;
     }
 
-    borderNotFound = true;
-
-    // find lowerBorderZ
-    for (std::size_t positionZ = 0; borderNotFound && positionZ < volume->getSize().getZ();
-         positionZ++) {
-        for (std::size_t positionX = lowerBorderX; borderNotFound && positionX < upperBorderX;
-             positionX++) {
-            for (std::size_t positionY = lowerBorderY; borderNotFound && positionY < upperBorderY;
-                 positionY++) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    lowerBorderZ = positionZ;
-                    borderNotFound = false;
+    // a brick map of another volume can not be used
+    const bool skipBricks =
+        bricks != nullptr && bricks->isValid() && bricks->getVolumeSize() == volumeSize;
+
+    // every task reduces a range of slices row by row, the results get merged afterwards
+    const std::size_t slicesPerTask =
+        (volumeSize.getZ() + numberOfThreads * 4 - 1) / (numberOfThreads * 4);
+    std::vector<std::future<BoundingBox>> results;
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t firstZ = 0; firstZ < volumeSize.getZ(); firstZ += slicesPerTask) {
+            const std::size_t lastZ = std::min(firstZ + slicesPerTask, volumeSize.getZ());
+            results.push_back(threadPool.enqueue([&, firstZ, lastZ]() {
+                BoundingBox box;
+                for (std::size_t positionZ = firstZ; positionZ < lastZ; positionZ++) {
+                    for (std::size_t positionY = 0; positionY < volumeSize.getY(); positionY++) {
+                        std::size_t searchFirst = 0;
+                        std::size_t searchLast = volumeSize.getX();
+                        if (skipBricks && !findRowSearchRange(*bricks, threshold, positionY,
+                                                              positionZ, &searchFirst,
+                                                              &searchLast)) {
+                            continue;
+                        }
+
+                        const uint16_t* const row =
+                            data + volumeSize.getX() * (positionY + volumeSize.getY() * positionZ);
+                        std::size_t first = 0;
+                        std::size_t last = 0;
+                        if (!findRowExtent(row + searchFirst, searchLast - searchFirst,
+                                           threshold, &first, &last)) {
+                            continue;
+                        }
+                        first += searchFirst;
+                        last += searchFirst;
+
+                        box.found = true;
+                        box.firstX = std::min(box.firstX, first);
+                        box.lastX = std::max(box.lastX, last);
+                        box.firstY = std::min(box.firstY, positionY);
+                        box.lastY = std::max(box.lastY, positionY);
+                        box.firstZ = std::min(box.firstZ, positionZ);
+                        box.lastZ = std::max(box.lastZ, positionZ);
+                    }
                 }
-            }
+                return box;
+            }));
         }
     }
 
-    borderNotFound = true;
-
-    // find upperBorderZ
-    for (std::size_t positionZ = volume->getSize().getZ() - 1;
-         borderNotFound && positionZ > lowerBorderZ; positionZ--) {
-        for (std::size_t positionX = lowerBorderX; borderNotFound && positionX <= upperBorderX;
-             positionX++) {
-            for (std::size_t positionY = lowerBorderY; borderNotFound && positionY < upperBorderY;
-                 positionY++) {
-                if (volume->getVoxelValue(positionX, positionY, positionZ) > threshold) {
-                    upperBorderZ = positionZ;
-                    borderNotFound = false;
-                }
-            }
+    BoundingBox box;
+    for (std::future<BoundingBox>& result : results) {
+        const BoundingBox partialBox = result.get();
+        if (partialBox.found) {
+            box.found = true;
+            box.firstX = std::min(box.firstX, partialBox.firstX);
+            box.lastX = std::max(box.lastX, partialBox.lastX);
+            box.firstY = std::min(box.firstY, partialBox.firstY);
+            box.lastY = std::max(box.lastY, partialBox.lastY);
+            box.firstZ = std::min(box.firstZ, partialBox.firstZ);
+            box.lastZ = std::max(box.lastZ, partialBox.lastZ);
         }
     }
 
+    if (!box.found) {
+        return false;
+    }
+
+    *offset = VolumeSize(box.firstX, box.firstY, box.firstZ);
     // + 1 because size starts counting with 1 and not 0
-    const std::size_t newVolumeSizeX = upperBorderX - lowerBorderX + 1;
-    const std::size_t newVolumeSizeY = upperBorderY - lowerBorderY + 1;
-    const std::size_t newVolumeSizeZ = upperBorderZ - lowerBorderZ + 1;
-    const VDTK::VolumeSize newVolumeSize(newVolumeSizeX, newVolumeSizeY, newVolumeSizeZ);
+    *size = VolumeSize(box.lastX - box.firstX + 1, box.lastY - box.firstY + 1,
+                       box.lastZ - box.firstZ + 1);
+    return true;
+}
 
-    // if no borders have to be cut, no creation of a new volume is needed
-    if (newVolumeSize != volume->getSize()) {
-        VolumeData newVolume(newVolumeSize, volume->getSpacing());
-
-        // copy values into new volume
-        for (std::size_t positionX = 0; positionX < newVolumeSizeX; positionX++) {
-            for (std::size_t positionY = 0; positionY < newVolumeSizeY; positionY++) {
-                for (std::size_t positionZ = 0; positionZ < newVolumeSizeZ; positionZ++) {
-                    const uint16_t value =
-                        volume->getVoxelValue(positionX + lowerBorderX, positionY + lowerBorderY,
-                                              positionZ + lowerBorderZ);
-                    newVolume.setVoxelValue(positionX, positionY, positionZ, value);
-                }
-            }
-        }
+bool EdgeCutter::findRowSearchRange(const BrickMinMaxMap& bricks, const uint16_t threshold,
+                                    const std::size_t positionY, const std::size_t positionZ,
+                                    std::size_t* const first, std::size_t* const last) {
+    const std::size_t brickSize = bricks.getBrickSize();
+    const std::size_t firstBrick =
+        bricks.getBrickIndex(0, positionY / brickSize, positionZ / brickSize);
+    const std::size_t brickCount = bricks.getGridSize().getX();
+
+    std::size_t brickX = 0;
+    while (brickX < brickCount && bricks.getMaximum(firstBrick + brickX) <= threshold) {
+        brickX++;
+    }
+    if (brickX == brickCount) {
+        return false;
+    }
+    *first = brickX * brickSize;
+
+    brickX = brickCount;
+    while (bricks.getMaximum(firstBrick + brickX - 1) <= threshold) {
+        brickX--;
+    }
+    *last = std::min(brickX * brickSize, bricks.getVolumeSize().getX());
+    return true;
+}
 
-        *volume = newVolume;
+bool EdgeCutter::findRowExtent(const uint16_t* const row, const std::size_t length,
+                               const uint16_t threshold, std::size_t* const first,
+                               std::size_t* const last) {
+    // search from the front for the first voxel above the threshold
+    std::size_t position = 0;
+#if defined(__SSE2__)
+    // a saturated subtraction of the threshold is zero for all voxels not above it
+    const __m128i thresholds = _mm_set1_epi16(static_cast<short>(threshold));
+    const __m128i zero = _mm_setzero_si128();
+    for (; position + 8 <= length; position += 8) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + position));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_subs_epu16(values, thresholds), zero)) !=
+            0xFFFF) {
+            break;
+        }
+    }
+#endif
+    while (position < length && row[position] <= threshold) {
+        position++;
+    }
+    if (position == length) {
+        return false;
+    }
+    *first = position;
+
+    // search from the back, the first voxel found above limits this search
+    position = length;
+#if defined(__SSE2__)
+    for (; position >= *first + 8; position -= 8) {
+        const __m128i values =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + position - 8));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_subs_epu16(values, thresholds), zero)) !=
+            0xFFFF) {
+            break;
+        }
+    }
+#endif
+    while (row[position - 1] <= threshold) {
+        position--;
     }
+    *last = position - 1;
+    return true;
 }
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
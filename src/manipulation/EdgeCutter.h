@@ -2,13 +2,37 @@
 #include "../include/VDTK/common/CommonDataTypes.h"
 
 namespace VDTK {
+class BrickMinMaxMap;
+
 class EdgeCutter {
 public:
     EdgeCutter();
     ~EdgeCutter();
 
-    static void cutBorders(VolumeData* const volume, const uint16_t threshold = 0);
+    // crops the volume to the bounding box of all voxels above the threshold
+    // the volume stays unchanged if no voxel is above the threshold
+    // bricks of a valid brick map without voxels above the threshold are skipped
+    static void cutBorders(VolumeData* const volume, const uint16_t threshold,
+                           const std::size_t numberOfThreads,
+                           const BrickMinMaxMap* const bricks = nullptr);
+    // crops the volume to the box [offset, offset + size), which has to be inside of the volume
+    static bool crop(VolumeData* const volume, const VolumeSize& offset, const VolumeSize& size,
+                     const std::size_t numberOfThreads);
+
+    // bounding box of all voxels above the threshold, false if there are none
+    static bool findBoundingBox(const VolumeData& volume, const uint16_t threshold,
+                                VolumeSize* const offset, VolumeSize* const size,
+                                const std::size_t numberOfThreads,
+                                const BrickMinMaxMap* const bricks = nullptr);
 
 private:
+    // part [first, last) of the row that is covered by bricks with voxels above the threshold
+    static bool findRowSearchRange(const BrickMinMaxMap& bricks, const uint16_t threshold,
+                                   const std::size_t positionY, const std::size_t positionZ,
+                                   std::size_t* const first, std::size_t* const last);
+    // first and last position of the row above the threshold, false if there are none
+    static bool findRowExtent(const uint16_t* const row, const std::size_t length,
+                              const uint16_t threshold, std::size_t* const first,
+                              std::size_t* const last);
 };
-} // namespace VDTK
\ No newline at end of file
+} // namespace VDTK
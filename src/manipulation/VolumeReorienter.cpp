@@ -0,0 +1,297 @@
+#include <cstring>
+#include <threadpool/ThreadPool.h>
+
+#include "VolumeReorienter.h"
+
+namespace VDTK {
+VolumeReorienter::VolumeReorienter() {}
+
+VolumeReorienter::~VolumeReorienter() {}
+
+void VolumeReorienter::permuteAxes(VolumeData* const volume, const Axis newX, const Axis newY,
+                                   const Axis newZ, const std::size_t numberOfThreads) {
+    // permutation[newAxis] = oldAxis
+    const std::array<std::size_t, 3> permutation = {static_cast<std::size_t>(newX),
+                                                    static_cast<std::size_t>(newY),
+                                                    static_cast<std::size_t>(newZ)};
+
+    // check if every axis is used exactly once
+    const bool validPermutation = permutation[0] != permutation[1] &&
+                                  permutation[0] != permutation[2] &&
+                                  permutation[1] != permutation[2];
+    assert(validPermutation);
+    if (!validPermutation || (permutation[0] == 0 && permutation[1] == 1)) {
+        // nothing to do for the identity
+        return;
+    }
+
+    const std::array<std::size_t, 3> size = {volume->getSize().getX(), volume->getSize().getY(),
+                                             volume->getSize().getZ()};
+    const std::array<float, 3> spacing = {volume->getSpacing().getX(),
+                                          volume->getSpacing().getY(),
+                                          volume->getSpacing().getZ()};
+    const std::array<std::size_t, 3> strides = {1, size[0], size[0] * size[1]};
+
+    const VolumeSize newSize(size[permutation[0]], size[permutation[1]], size[permutation[2]]);
+    const VolumeSpacing newSpacing(spacing[permutation[0]], spacing[permutation[1]],
+                                   spacing[permutation[2]]);
+
+    std::vector<uint16_t>& data = volume->getRawVolumeData();
+
+    // swap X and Y, only a transposition inside of each XY slice
+    if (permutation[2] == 2 && size[0] == size[1]) {
+        {
+            // create own scope to use destructor of thread pool (wait for all task to
+            // finish)
+            ThreadPool threadPool(numberOfThreads);
+            for (std::size_t z = 0; z < size[2]; z++) {
+                threadPool.enqueue(&VolumeReorienter::transposeSquareInPlace,
+                                   data.data() + z * strides[2], size[0], strides[1], strides[0],
+                                   1, 0, size[0]);
+            }
+        }
+        *volume = VolumeData(newSize, newSpacing, std::move(data));
+        return;
+    }
+
+    // swap X and Z, a transposition inside of each XZ slice
+    if (permutation[1] == 1 && size[0] == size[2]) {
+        {
+            ThreadPool threadPool(numberOfThreads);
+            for (std::size_t y = 0; y < size[1]; y++) {
+                threadPool.enqueue(&VolumeReorienter::transposeSquareInPlace,
+                                   data.data() + y * strides[1], size[0], strides[2], strides[0],
+                                   1, 0, size[0]);
+            }
+        }
+        *volume = VolumeData(newSize, newSpacing, std::move(data));
+        return;
+    }
+
+    // swap Y and Z, whole X rows get swapped
+    if (permutation[0] == 0) {
+        if (size[1] == size[2]) {
+            ThreadPool threadPool(numberOfThreads);
+            for (std::size_t firstRow = 0; firstRow < size[1]; firstRow += m_blockSize) {
+                threadPool.enqueue(&VolumeReorienter::transposeSquareInPlace, data.data(),
+                                   size[1], strides[2], strides[1], size[0], firstRow,
+                                   std::min(firstRow + m_blockSize, size[1]));
+            }
+        } else {
+            std::vector<uint16_t> permutedData(data.size());
+            {
+                ThreadPool threadPool(numberOfThreads);
+                // new slice z is old slice y, new row y is old slice z
+                for (std::size_t newPositionZ = 0; newPositionZ < size[1]; newPositionZ++) {
+                    threadPool.enqueue([&, newPositionZ]() {
+                        for (std::size_t newPositionY = 0; newPositionY < size[2];
+                             newPositionY++) {
+                            std::memcpy(
+                                permutedData.data() +
+                                    (newPositionY + newPositionZ * size[2]) * size[0],
+                                data.data() + newPositionZ * strides[1] +
+                                    newPositionY * strides[2],
+                                size[0] * sizeof(uint16_t));
+                        }
+                    });
+                }
+            }
+            data.swap(permutedData);
+        }
+        *volume = VolumeData(newSize, newSpacing, std::move(data));
+        return;
+    }
+
+    // general case, needs a second buffer
+    const std::array<std::size_t, 3> sourceStrides = {
+        strides[permutation[0]], strides[permutation[1]], strides[permutation[2]]};
+    const std::array<std::size_t, 3> destinationSize = {newSize.getX(), newSize.getY(),
+                                                        newSize.getZ()};
+    std::vector<uint16_t> permutedData(data.size());
+    {
+        ThreadPool threadPool(numberOfThreads);
+        // slabs of several slices, so the recursion can also tile along z
+        for (std::size_t firstZ = 0; firstZ < destinationSize[2]; firstZ += m_blockSize) {
+            threadPool.enqueue(&VolumeReorienter::transposeSlab, data.data(),
+                               permutedData.data(), sourceStrides, destinationSize, firstZ,
+                               std::min(firstZ + m_blockSize, destinationSize[2]));
+        }
+    }
+    *volume = VolumeData(newSize, newSpacing, std::move(permutedData));
+}
+
+void VolumeReorienter::flipAxis(VolumeData* const volume, const Axis axis,
+                                const std::size_t numberOfThreads) {
+    // create own scope to use destructor of thread pool (wait for all task to
+    // finish)
+    ThreadPool threadPool(numberOfThreads);
+
+    switch (axis) {
+    case Axis::X: {
+        for (std::size_t z = 0; z < volume->getSize().getZ(); z++) {
+            threadPool.enqueue(&VolumeReorienter::flipRowsX, volume, z);
+        }
+        break;
+    }
+    case Axis::Y: {
+        for (std::size_t z = 0; z < volume->getSize().getZ(); z++) {
+            threadPool.enqueue(&VolumeReorienter::flipRowsY, volume, z);
+        }
+        break;
+    }
+    case Axis::Z: {
+        for (std::size_t z = 0; z < volume->getSize().getZ() / 2; z++) {
+            threadPool.enqueue(&VolumeReorienter::swapSlicesZ, volume, z);
+        }
+        break;
+    }
+    default: { break; }
+    }
+}
+
+void VolumeReorienter::rotate90(VolumeData* const volume, const Axis rotationAxis,
+                                const int quarterTurns, const std::size_t numberOfThreads) {
+    const int turns = ((quarterTurns % 4) + 4) % 4;
+
+    // the two axes spanning the rotation plane, a positive rotation moves the first onto the
+    // second axis
+    Axis first = Axis::X;
+    Axis second = Axis::Y;
+    switch (rotationAxis) {
+    case Axis::X: {
+        first = Axis::Y;
+        second = Axis::Z;
+        break;
+    }
+    case Axis::Y: {
+        first = Axis::Z;
+        second = Axis::X;
+        break;
+    }
+    case Axis::Z:
+    default: { break; }
+    }
+
+    if (turns == 0) {
+        return;
+    } else if (turns == 2) {
+        flipAxis(volume, first, numberOfThreads);
+        flipAxis(volume, second, numberOfThreads);
+        return;
+    }
+
+    // a quarter turn is a swap of the two plane axes followed by a flip
+    std::array<Axis, 3> newAxes = {Axis::X, Axis::Y, Axis::Z};
+    std::swap(newAxes[static_cast<std::size_t>(first)], newAxes[static_cast<std::size_t>(second)]);
+    permuteAxes(volume, newAxes[0], newAxes[1], newAxes[2], numberOfThreads);
+    flipAxis(volume, (turns == 1) ? first : second, numberOfThreads);
+}
+
+void VolumeReorienter::flipRowsX(VolumeData* const volume, const std::size_t positionZ) {
+    const std::size_t sizeX = volume->getSize().getX();
+    const std::size_t sizeY = volume->getSize().getY();
+    uint16_t* const slice = volume->getRawVolumeData().data() + positionZ * sizeX * sizeY;
+
+    for (std::size_t y = 0; y < sizeY; y++) {
+        std::reverse(slice + y * sizeX, slice + (y + 1) * sizeX);
+    }
+}
+
+void VolumeReorienter::flipRowsY(VolumeData* const volume, const std::size_t positionZ) {
+    const std::size_t sizeX = volume->getSize().getX();
+    const std::size_t sizeY = volume->getSize().getY();
+    uint16_t* const slice = volume->getRawVolumeData().data() + positionZ * sizeX * sizeY;
+
+    for (std::size_t y = 0; y < sizeY / 2; y++) {
+        std::swap_ranges(slice + y * sizeX, slice + (y + 1) * sizeX,
+                         slice + (sizeY - 1 - y) * sizeX);
+    }
+}
+
+void VolumeReorienter::swapSlicesZ(VolumeData* const volume, const std::size_t positionZ) {
+    const std::size_t sliceSize = volume->getSize().getX() * volume->getSize().getY();
+    uint16_t* const data = volume->getRawVolumeData().data();
+    uint16_t* const slice = data + positionZ * sliceSize;
+    uint16_t* const mirroredSlice =
+        data + (volume->getSize().getZ() - 1 - positionZ) * sliceSize;
+
+    std::swap_ranges(slice, slice + sliceSize, mirroredSlice);
+}
+
+void VolumeReorienter::transposeSquareInPlace(uint16_t* const data, const std::size_t n,
+                                              const std::size_t strideI,
+                                              const std::size_t strideJ,
+                                              const std::size_t elementLength,
+                                              const std::size_t firstRow,
+                                              const std::size_t lastRow) {
+    // blocked, so both the (i, j) and the mirrored (j, i) tile stay in the cache
+    for (std::size_t blockI = firstRow; blockI < lastRow; blockI += m_blockSize) {
+        const std::size_t blockEndI = std::min(blockI + m_blockSize, lastRow);
+        for (std::size_t blockJ = blockI; blockJ < n; blockJ += m_blockSize) {
+            const std::size_t blockEndJ = std::min(blockJ + m_blockSize, n);
+            for (std::size_t i = blockI; i < blockEndI; i++) {
+                for (std::size_t j = std::max(blockJ, i + 1); j < blockEndJ; j++) {
+                    uint16_t* const element = data + i * strideI + j * strideJ;
+                    uint16_t* const mirroredElement = data + j * strideI + i * strideJ;
+                    if (elementLength == 1) {
+                        std::swap(*element, *mirroredElement);
+                    } else {
+                        std::swap_ranges(element, element + elementLength, mirroredElement);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void VolumeReorienter::transposeRecursive(const uint16_t* const source,
+                                          uint16_t* const destination,
+                                          const std::array<std::size_t, 3>& sourceStrides,
+                                          const std::array<std::size_t, 3>& destinationSize,
+                                          const std::array<std::size_t, 3>& begin,
+                                          const std::array<std::size_t, 3>& end) {
+    const std::array<std::size_t, 3> extent = {end[0] - begin[0], end[1] - begin[1],
+                                               end[2] - begin[2]};
+
+    if (extent[0] * extent[1] * extent[2] > m_leafVoxelCount) {
+        // split along the largest dimension
+        std::size_t axis = 0;
+        if (extent[1] > extent[axis]) {
+            axis = 1;
+        }
+        if (extent[2] > extent[axis]) {
+            axis = 2;
+        }
+
+        std::array<std::size_t, 3> middleEnd = end;
+        std::array<std::size_t, 3> middleBegin = begin;
+        middleEnd[axis] = begin[axis] + extent[axis] / 2;
+        middleBegin[axis] = middleEnd[axis];
+
+        transposeRecursive(source, destination, sourceStrides, destinationSize, begin,
+                           middleEnd);
+        transposeRecursive(source, destination, sourceStrides, destinationSize, middleBegin,
+                           end);
+        return;
+    }
+
+    for (std::size_t z = begin[2]; z < end[2]; z++) {
+        for (std::size_t y = begin[1]; y < end[1]; y++) {
+            uint16_t* const destinationRow =
+                destination + destinationSize[0] * (y + destinationSize[1] * z);
+            const uint16_t* const sourceRow = source + y * sourceStrides[1] + z * sourceStrides[2];
+            for (std::size_t x = begin[0]; x < end[0]; x++) {
+                destinationRow[x] = sourceRow[x * sourceStrides[0]];
+            }
+        }
+    }
+}
+
+void VolumeReorienter::transposeSlab(const uint16_t* const source, uint16_t* const destination,
+                                     const std::array<std::size_t, 3>& sourceStrides,
+                                     const std::array<std::size_t, 3>& destinationSize,
+                                     const std::size_t firstZ, const std::size_t lastZ) {
+    transposeRecursive(source, destination, sourceStrides, destinationSize, {0, 0, firstZ},
+                       {destinationSize[0], destinationSize[1], lastZ});
+}
+} // namespace VDTK
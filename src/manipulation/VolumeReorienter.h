@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+class VolumeReorienter {
+public:
+    VolumeReorienter();
+    ~VolumeReorienter();
+
+    // new axis X, Y and Z are taken from the given old axes. Every old axis has to be used once
+    // works in place if the two swapped axes have the same size, otherwise a copy is needed
+    static void permuteAxes(VolumeData* const volume, const Axis newX, const Axis newY,
+                            const Axis newZ, const std::size_t numberOfThreads);
+    // always works in place
+    static void flipAxis(VolumeData* const volume, const Axis axis,
+                         const std::size_t numberOfThreads);
+    // rotates by quarterTurns * 90 degree counterclockwise around the given axis (right hand rule)
+    static void rotate90(VolumeData* const volume, const Axis rotationAxis,
+                         const int quarterTurns, const std::size_t numberOfThreads);
+
+private:
+    // edge length of the tiles processed at once by the transpositions
+    static constexpr std::size_t m_blockSize = 32;
+    // sub volumes with less voxels get copied directly by the cache oblivious transposition
+    static constexpr std::size_t m_leafVoxelCount = 4096;
+
+    static void flipRowsX(VolumeData* const volume, const std::size_t positionZ);
+    static void flipRowsY(VolumeData* const volume, const std::size_t positionZ);
+    static void swapSlicesZ(VolumeData* const volume, const std::size_t positionZ);
+
+    // swaps element (i, j) with element (j, i) for all i < j of a n x n matrix inside of data
+    // elements are elementLength voxels long (1 for single voxels, size x for whole rows)
+    // only rows i in [firstRow, lastRow) are processed so that tasks do not overlap
+    static void transposeSquareInPlace(uint16_t* const data, const std::size_t n,
+                                       const std::size_t strideI, const std::size_t strideJ,
+                                       const std::size_t elementLength,
+                                       const std::size_t firstRow, const std::size_t lastRow);
+
+    // recursively splits the output box along its largest dimension until it fits into the cache
+    static void transposeRecursive(const uint16_t* const source, uint16_t* const destination,
+                                   const std::array<std::size_t, 3>& sourceStrides,
+                                   const std::array<std::size_t, 3>& destinationSize,
+                                   const std::array<std::size_t, 3>& begin,
+                                   const std::array<std::size_t, 3>& end);
+    static void transposeSlab(const uint16_t* const source, uint16_t* const destination,
+                              const std::array<std::size_t, 3>& sourceStrides,
+                              const std::array<std::size_t, 3>& destinationSize,
+                              const std::size_t firstZ, const std::size_t lastZ);
+};
+} // namespace VDTK
@@ -0,0 +1,233 @@
+#include <cstring>
+#include <threadpool/ThreadPool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "IntensityProjector.h"
+
+namespace VDTK {
+IntensityProjector::IntensityProjector() {}
+
+IntensityProjector::~IntensityProjector() {}
+
+VolumeSlice IntensityProjector::project(const VolumeData& volume, const ProjectionMode mode,
+                                        const VolumeAxis axis, const std::size_t firstSlice,
+                                        const std::size_t lastSlice,
+                                        const std::size_t numberOfThreads) {
+    const VolumeSize size = volume.getSize();
+    const uint16_t* const data = volume.getRawVolumeData().data();
+    const std::size_t sliceSize = size.getX() * size.getY();
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t numberOfSlices = 0;
+    switch (axis) {
+    case VolumeAxis::YZAxis: {
+        width = size.getY();
+        height = size.getZ();
+        numberOfSlices = size.getX();
+        break;
+    }
+    case VolumeAxis::XZAxis: {
+        width = size.getX();
+        height = size.getZ();
+        numberOfSlices = size.getY();
+        break;
+    }
+    case VolumeAxis::XYAxis: {
+        width = size.getX();
+        height = size.getY();
+        numberOfSlices = size.getZ();
+        break;
+    }
+    default: { break; }
+    }
+
+    const std::size_t last = std::min(lastSlice, numberOfSlices - 1);
+    if (width == 0 || height == 0 || numberOfSlices == 0 || firstSlice > last) {
+        return VolumeSlice(axis, 0, 0);
+    }
+    const std::size_t sliceCount = last - firstSlice + 1;
+
+    // pixel (column, row) of a VolumeSlice is stored at row + height * column
+    std::vector<uint16_t> pixels(width * height);
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        switch (axis) {
+        case VolumeAxis::YZAxis: {
+            // every pixel is one whole X row
+            for (std::size_t z = 0; z < size.getZ(); z++) {
+                threadPool.enqueue([&, z]() {
+                    for (std::size_t y = 0; y < size.getY(); y++) {
+                        pixels[z + height * y] =
+                            reduceRow(data + firstSlice + size.getX() * y + sliceSize * z,
+                                      sliceCount, mode);
+                    }
+                });
+            }
+            break;
+        }
+        case VolumeAxis::XZAxis: {
+            // every image row combines the X rows of one Z slice
+            for (std::size_t z = 0; z < size.getZ(); z++) {
+                threadPool.enqueue([&, z]() {
+                    thread_local std::vector<uint16_t> row;
+                    row.resize(width);
+                    reduceRows(data + size.getX() * firstSlice + sliceSize * z, size.getX(),
+                               sliceCount, width, mode, row.data());
+                    for (std::size_t x = 0; x < width; x++) {
+                        pixels[z + height * x] = row[x];
+                    }
+                });
+            }
+            break;
+        }
+        case VolumeAxis::XYAxis: {
+            // every image row combines the X rows with the same y of all Z slices
+            for (std::size_t y = 0; y < size.getY(); y++) {
+                threadPool.enqueue([&, y]() {
+                    thread_local std::vector<uint16_t> row;
+                    row.resize(width);
+                    reduceRows(data + size.getX() * y + sliceSize * firstSlice, sliceSize,
+                               sliceCount, width, mode, row.data());
+                    for (std::size_t x = 0; x < width; x++) {
+                        pixels[y + height * x] = row[x];
+                    }
+                });
+            }
+            break;
+        }
+        default: { break; }
+        }
+    }
+
+    return VolumeSlice(axis, pixels, width, height);
+}
+
+void IntensityProjector::reduceRows(const uint16_t* const source, const std::size_t rowStride,
+                                    const std::size_t rowCount, const std::size_t length,
+                                    const ProjectionMode mode, uint16_t* const destination) {
+    if (mode != ProjectionMode::Average) {
+        std::memcpy(destination, source, length * sizeof(uint16_t));
+        for (std::size_t rowIndex = 1; rowIndex < rowCount; rowIndex++) {
+            const uint16_t* const row = source + rowIndex * rowStride;
+            std::size_t x = 0;
+#if defined(__SSE2__)
+            // SSE2 has no unsigned 16 bit min and max, but saturated subtraction:
+            // max(a, b) = (a -sat b) + b and min(a, b) = a - (a -sat b)
+            for (; x + 8 <= length; x += 8) {
+                const __m128i a =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + x));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                const __m128i difference = _mm_subs_epu16(a, b);
+                const __m128i result = (mode == ProjectionMode::Maximum)
+                                           ? _mm_add_epi16(difference, b)
+                                           : _mm_sub_epi16(a, difference);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x), result);
+            }
+#endif
+            for (; x < length; x++) {
+                destination[x] = (mode == ProjectionMode::Maximum)
+                                     ? std::max(destination[x], row[x])
+                                     : std::min(destination[x], row[x]);
+            }
+        }
+        return;
+    }
+
+    // 32 bit sums get added to the total before they can overflow
+    thread_local std::vector<uint32_t> sums;
+    thread_local std::vector<uint64_t> totals;
+    sums.assign(length, 0);
+    totals.assign(length, 0);
+    for (std::size_t rowIndex = 0; rowIndex < rowCount; rowIndex++) {
+        const uint16_t* const row = source + rowIndex * rowStride;
+        std::size_t x = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 8 <= length; x += 8) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i* const lowerSums = reinterpret_cast<__m128i*>(sums.data() + x);
+            __m128i* const upperSums = reinterpret_cast<__m128i*>(sums.data() + x + 4);
+            _mm_storeu_si128(lowerSums, _mm_add_epi32(_mm_loadu_si128(lowerSums),
+                                                      _mm_unpacklo_epi16(values, zero)));
+            _mm_storeu_si128(upperSums, _mm_add_epi32(_mm_loadu_si128(upperSums),
+                                                      _mm_unpackhi_epi16(values, zero)));
+        }
+#endif
+        for (; x < length; x++) {
+            sums[x] += row[x];
+        }
+
+        if ((rowIndex + 1) % m_maximumSumCount == 0 || rowIndex + 1 == rowCount) {
+            for (x = 0; x < length; x++) {
+                totals[x] += sums[x];
+                sums[x] = 0;
+            }
+        }
+    }
+
+    for (std::size_t x = 0; x < length; x++) {
+        destination[x] = static_cast<uint16_t>((totals[x] + rowCount / 2) / rowCount);
+    }
+}
+
+uint16_t IntensityProjector::reduceRow(const uint16_t* const row, const std::size_t length,
+                                       const ProjectionMode mode) {
+    std::size_t x = 0;
+    if (mode != ProjectionMode::Average) {
+        uint16_t result = row[0];
+#if defined(__SSE2__)
+        if (length >= 8) {
+            __m128i results = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+            for (x = 8; x + 8 <= length; x += 8) {
+                const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                const __m128i difference = _mm_subs_epu16(results, values);
+                results = (mode == ProjectionMode::Maximum) ? _mm_add_epi16(difference, values)
+                                                            : _mm_sub_epi16(results, difference);
+            }
+
+            alignas(16) uint16_t lanes[8];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), results);
+            for (const uint16_t lane : lanes) {
+                result = (mode == ProjectionMode::Maximum) ? std::max(result, lane)
+                                                           : std::min(result, lane);
+            }
+        }
+#endif
+        for (; x < length; x++) {
+            result = (mode == ProjectionMode::Maximum) ? std::max(result, row[x])
+                                                       : std::min(result, row[x]);
+        }
+        return result;
+    }
+
+    uint64_t total = 0;
+#if defined(__SSE2__)
+    // every 32 bit lane adds up to m_maximumSumCount values before it is added to the total
+    const __m128i zero = _mm_setzero_si128();
+    while (x + 8 <= length) {
+        __m128i sums = zero;
+        const std::size_t blockEnd = std::min(length, x + 4 * m_maximumSumCount);
+        for (; x + 8 <= blockEnd; x += 8) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            sums = _mm_add_epi32(sums, _mm_unpacklo_epi16(values, zero));
+            sums = _mm_add_epi32(sums, _mm_unpackhi_epi16(values, zero));
+        }
+
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sums);
+        total += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+    for (; x < length; x++) {
+        total += row[x];
+    }
+    return static_cast<uint16_t>((total + length / 2) / length);
+}
+} // namespace VDTK
@@ -0,0 +1,30 @@
+#pragma once
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+// Maximum, minimum and average intensity projections. Whole X rows are combined at once, so the
+// volume is read in memory order for every axis
+class IntensityProjector {
+public:
+    IntensityProjector();
+    ~IntensityProjector();
+
+    // projects the slices [firstSlice, lastSlice] of the axis (lastSlice gets clamped) onto one
+    // slice with the same width and height as VolumeData::getSlice
+    static VolumeSlice project(const VolumeData& volume, const ProjectionMode mode,
+                               const VolumeAxis axis, const std::size_t firstSlice,
+                               const std::size_t lastSlice, const std::size_t numberOfThreads);
+
+private:
+    // combines rowCount rows of length voxels, rowStride apart, voxel by voxel
+    static void reduceRows(const uint16_t* const source, const std::size_t rowStride,
+                           const std::size_t rowCount, const std::size_t length,
+                           const ProjectionMode mode, uint16_t* const destination);
+    // combines all voxels of one row
+    static uint16_t reduceRow(const uint16_t* const row, const std::size_t length,
+                              const ProjectionMode mode);
+
+    // sums of 16 bit values in 32 bit can take this many values without overflow
+    static constexpr std::size_t m_maximumSumCount = 65536;
+};
+} // namespace VDTK
@@ -0,0 +1,329 @@
+
+#include <algorithm>
+#include <future>
+#include <threadpool/ThreadPool.h>
+
+#include "../imaga_analysis/BrickMinMaxMap.h"
+#include "MarchingCubes.h"
+
+namespace VDTK {
+namespace {
+// corner i of a cube is at (i & 1, (i >> 1) & 1, (i >> 2) & 1)
+std::size_t getCornerOffset(const std::size_t corner, const std::size_t axis) {
+    return (corner >> axis) & 1;
+}
+
+// edge 4 * axis + k starts at the k-th corner whose bit of the axis is not set
+std::size_t getEdgeStart(const std::size_t edge) {
+    const std::size_t axis = edge / 4;
+    const std::size_t k = edge % 4;
+    const std::size_t lowMask = (std::size_t(1) << axis) - 1;
+    return (k & lowMask) | ((k & ~lowMask) << 1);
+}
+
+std::size_t getEdge(const std::size_t cornerA, const std::size_t cornerB) {
+    const std::size_t start = std::min(cornerA, cornerB);
+    const std::size_t axis = ((cornerA ^ cornerB) == 1) ? 0 : ((cornerA ^ cornerB) == 2) ? 1 : 2;
+    const std::size_t lowMask = (std::size_t(1) << axis) - 1;
+    return 4 * axis + ((start & lowMask) | ((start >> 1) & ~lowMask));
+}
+
+// true if both cube edges lie on a common face of the cube
+bool shareFace(const std::size_t edgeA, const std::size_t edgeB) {
+    const std::size_t startA = getEdgeStart(edgeA);
+    const std::size_t startB = getEdgeStart(edgeB);
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (axis != edgeA / 4 && axis != edgeB / 4 &&
+            getCornerOffset(startA, axis) == getCornerOffset(startB, axis)) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+MarchingCubes::MarchingCubes() {}
+
+MarchingCubes::~MarchingCubes() {}
+
+SurfaceMesh MarchingCubes::extract(const VolumeData& volume, const uint16_t isoValue,
+                                   const BrickMinMaxMap& bricks,
+                                   const std::size_t numberOfThreads) {
+    const VolumeSize& size = volume.getSize();
+    if (size.getX() < 2 || size.getY() < 2 || size.getZ() < 2) {
+        // no cells
+        return SurfaceMesh();
+    }
+
+    // several slabs per thread to balance surfaces that only cover a part of the volume
+    const std::size_t layerCount = size.getZ() - 1;
+    const std::size_t slabThickness =
+        std::max<std::size_t>(1, layerCount / (4 * std::max<std::size_t>(numberOfThreads, 1)));
+    const std::size_t slabCount = (layerCount + slabThickness - 1) / slabThickness;
+    std::vector<SlabMesh> slabs(slabCount);
+
+    // the table is created before the tasks start
+    getCubeCases();
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t slab = 0; slab < slabCount; slab++) {
+            threadPool.enqueue([&, slab]() {
+                const std::size_t firstLayer = slab * slabThickness;
+                const std::size_t lastLayer = std::min(firstLayer + slabThickness, layerCount);
+                slabs[slab] = extractSlab(volume, isoValue, bricks, firstLayer, lastLayer);
+            });
+        }
+    }
+
+    return mergeSlabs(slabs);
+}
+
+const std::array<MarchingCubes::CubeCase, 256>& MarchingCubes::getCubeCases() {
+    static const std::array<CubeCase, 256> cubeCases = []() {
+        std::array<CubeCase, 256> cases;
+        for (std::size_t configuration = 0; configuration < cases.size(); configuration++) {
+            cases[configuration] = createCubeCase(configuration);
+        }
+        return cases;
+    }();
+    return cubeCases;
+}
+
+MarchingCubes::CubeCase MarchingCubes::createCubeCase(const std::size_t configuration) {
+    // Every face of the cube contributes segments between its cut edges, the segments are joined
+    // to polygons and those get triangulated. Faces with two diagonal inside corners always
+    // separate the inside corners. Both cubes of a face decide the same way, so the surface has
+    // no holes between cells
+    const auto isInside = [configuration](const std::size_t corner) {
+        return ((configuration >> corner) & 1) != 0;
+    };
+
+    // next[edge] is the following edge of the polygon through the edge
+    std::array<std::size_t, 12> next;
+    next.fill(SIZE_MAX);
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        // the other axes in right handed order
+        const std::size_t u = (axis + 1) % 3;
+        const std::size_t v = (axis + 2) % 3;
+        for (std::size_t side = 0; side < 2; side++) {
+            // corners of the face counterclockwise seen from outside
+            std::array<std::size_t, 4> corners;
+            const std::array<std::size_t, 4> uOffsets = {0, 1, 1, 0};
+            const std::array<std::size_t, 4> vOffsets = {0, 0, 1, 1};
+            for (std::size_t i = 0; i < 4; i++) {
+                const std::size_t j = (side == 1) ? i : 3 - i;
+                corners[i] = (side << axis) | (uOffsets[j] << u) | (vOffsets[j] << v);
+            }
+
+            // a segment enters the face where an inside run of corners starts and leaves where it
+            // ends, the inside corners are on its right
+            for (std::size_t i = 0; i < 4; i++) {
+                if (isInside(corners[i]) || !isInside(corners[(i + 1) % 4])) {
+                    continue;
+                }
+                std::size_t last = (i + 1) % 4;
+                while (isInside(corners[(last + 1) % 4])) {
+                    last = (last + 1) % 4;
+                }
+                next[getEdge(corners[i], corners[(i + 1) % 4])] =
+                    getEdge(corners[last], corners[(last + 1) % 4]);
+            }
+        }
+    }
+
+    // triangle fans of the polygons, counterclockwise seen from the outside. The fan starts at a
+    // vertex whose diagonals do not run along a face, otherwise the neighbouring cube could use
+    // the same diagonal and the surface would not be a manifold
+    CubeCase cubeCase;
+    std::array<bool, 12> used = {};
+    for (std::size_t first = 0; first < 12; first++) {
+        if (next[first] == SIZE_MAX || used[first]) {
+            continue;
+        }
+        std::vector<std::size_t> polygon;
+        for (std::size_t edge = first; !used[edge]; edge = next[edge]) {
+            used[edge] = true;
+            polygon.push_back(edge);
+        }
+        const std::size_t count = polygon.size();
+        std::size_t start = 0;
+        for (std::size_t candidate = 0; candidate < count; candidate++) {
+            bool interiorDiagonals = true;
+            for (std::size_t i = 2; i + 1 < count; i++) {
+                interiorDiagonals &=
+                    !shareFace(polygon[candidate], polygon[(candidate + i) % count]);
+            }
+            if (interiorDiagonals) {
+                start = candidate;
+                break;
+            }
+        }
+        for (std::size_t i = 1; i + 1 < count; i++) {
+            const std::size_t index = 3 * cubeCase.triangleCount;
+            cubeCase.edges[index] = static_cast<uint8_t>(polygon[start]);
+            cubeCase.edges[index + 1] = static_cast<uint8_t>(polygon[(start + i) % count]);
+            cubeCase.edges[index + 2] = static_cast<uint8_t>(polygon[(start + i + 1) % count]);
+            cubeCase.triangleCount++;
+        }
+    }
+    return cubeCase;
+}
+
+MarchingCubes::SlabMesh MarchingCubes::extractSlab(const VolumeData& volume,
+                                                   const uint16_t isoValue,
+                                                   const BrickMinMaxMap& bricks,
+                                                   const std::size_t firstLayer,
+                                                   const std::size_t lastLayer) {
+    const std::array<CubeCase, 256>& cubeCases = getCubeCases();
+    const std::size_t sizeX = volume.getSize().getX();
+    const std::size_t sizeY = volume.getSize().getY();
+    const std::size_t planeSize = sizeX * sizeY;
+    const std::size_t brickSize = bricks.getBrickSize();
+    const uint16_t* const voxels = volume.getRawVolumeData().data();
+    const std::array<float, 3> spacing = {volume.getSpacing().getX(), volume.getSpacing().getY(),
+                                          volume.getSpacing().getZ()};
+
+    // vertex cache: x and y edges of the two planes of the current layer (by plane parity) and
+    // z edges between them, indexed by the position of the edge start in the plane
+    std::array<std::vector<uint32_t>, 2> planeVertices;
+    planeVertices[0].assign(2 * planeSize, m_noVertex);
+    planeVertices[1].assign(2 * planeSize, m_noVertex);
+    std::vector<uint32_t> layerVertices(planeSize, m_noVertex);
+
+    SlabMesh slab;
+    const auto getVertex = [&](const std::size_t x, const std::size_t y, const std::size_t z,
+                               const std::size_t axis) {
+        const std::size_t planeIndex = x + sizeX * y;
+        uint32_t& vertex = (axis == 2) ? layerVertices[planeIndex]
+                                       : planeVertices[z & 1][2 * planeIndex + axis];
+        if (vertex != m_noVertex) {
+            return vertex;
+        }
+
+        const std::array<std::size_t, 3> start = {x, y, z};
+        std::array<std::size_t, 3> end = start;
+        end[axis]++;
+        const float startValue = voxels[planeIndex + planeSize * z];
+        const float endValue = voxels[end[0] + sizeX * end[1] + planeSize * end[2]];
+        const float t = (isoValue - startValue) / (endValue - startValue);
+
+        std::array<float, 3> position;
+        for (std::size_t i = 0; i < 3; i++) {
+            position[i] = (static_cast<float>(start[i]) + ((i == axis) ? t : 0.0f)) * spacing[i];
+        }
+        vertex = static_cast<uint32_t>(slab.mesh.vertices.size());
+        slab.mesh.vertices.push_back(position);
+
+        if (axis != 2 && z == firstLayer) {
+            slab.firstPlaneVertices.emplace_back(2 * planeIndex + axis, vertex);
+        } else if (axis != 2 && z == lastLayer) {
+            slab.lastPlaneVertices.emplace_back(2 * planeIndex + axis, vertex);
+        }
+        return vertex;
+    };
+
+    for (std::size_t z = firstLayer; z < lastLayer; z++) {
+        // the upper plane still holds the vertices of the plane below the lower one
+        std::fill(planeVertices[(z + 1) & 1].begin(), planeVertices[(z + 1) & 1].end(), m_noVertex);
+        std::fill(layerVertices.begin(), layerVertices.end(), m_noVertex);
+        if (z == firstLayer) {
+            std::fill(planeVertices[z & 1].begin(), planeVertices[z & 1].end(), m_noVertex);
+        }
+
+        for (std::size_t y = 0; y + 1 < sizeY; y++) {
+            const uint16_t* const rows[4] = {
+                voxels + sizeX * y + planeSize * z, voxels + sizeX * (y + 1) + planeSize * z,
+                voxels + sizeX * y + planeSize * (z + 1),
+                voxels + sizeX * (y + 1) + planeSize * (z + 1)};
+            const std::size_t firstBrick =
+                bricks.getBrickIndex(0, y / brickSize, z / brickSize);
+
+            for (std::size_t x = 0; x + 1 < sizeX; x++) {
+                if (!bricks.containsRange(firstBrick + x / brickSize, isoValue, isoValue)) {
+                    // no cell of the brick is cut, continue with the next brick
+                    x = (x / brickSize + 1) * brickSize - 1;
+                    continue;
+                }
+
+                std::size_t configuration = 0;
+                for (std::size_t corner = 0; corner < 8; corner++) {
+                    const uint16_t value = rows[corner >> 1][x + (corner & 1)];
+                    configuration |= static_cast<std::size_t>(value >= isoValue) << corner;
+                }
+
+                const CubeCase& cubeCase = cubeCases[configuration];
+                for (std::size_t triangle = 0; triangle < cubeCase.triangleCount; triangle++) {
+                    std::array<uint32_t, 3> indices;
+                    for (std::size_t i = 0; i < 3; i++) {
+                        const std::size_t edge = cubeCase.edges[3 * triangle + i];
+                        const std::size_t start = getEdgeStart(edge);
+                        indices[i] = getVertex(x + getCornerOffset(start, 0),
+                                               y + getCornerOffset(start, 1),
+                                               z + getCornerOffset(start, 2), edge / 4);
+                    }
+                    slab.mesh.triangles.push_back(indices);
+                }
+            }
+        }
+    }
+    return slab;
+}
+
+SurfaceMesh MarchingCubes::mergeSlabs(std::vector<SlabMesh>& slabs) {
+    std::size_t vertexCount = 0;
+    std::size_t triangleCount = 0;
+    for (const SlabMesh& slab : slabs) {
+        vertexCount += slab.mesh.vertices.size();
+        triangleCount += slab.mesh.triangles.size();
+    }
+
+    SurfaceMesh mesh;
+    mesh.vertices.reserve(vertexCount);
+    mesh.triangles.reserve(triangleCount);
+
+    // shared plane of the previous slab, sorted by edge key and with merged vertex indices
+    std::vector<std::pair<std::size_t, uint32_t>> previousPlane;
+    std::vector<uint32_t> vertexMap;
+    for (SlabMesh& slab : slabs) {
+        vertexMap.assign(slab.mesh.vertices.size(), m_noVertex);
+
+        // vertices of the first plane already exist in the previous slab if its cells cut the
+        // same edge
+        std::sort(slab.firstPlaneVertices.begin(), slab.firstPlaneVertices.end());
+        std::size_t previous = 0;
+        for (const std::pair<std::size_t, uint32_t>& vertex : slab.firstPlaneVertices) {
+            while (previous < previousPlane.size() &&
+                   previousPlane[previous].first < vertex.first) {
+                previous++;
+            }
+            if (previous < previousPlane.size() && previousPlane[previous].first == vertex.first) {
+                vertexMap[vertex.second] = previousPlane[previous].second;
+            }
+        }
+
+        for (std::size_t vertex = 0; vertex < slab.mesh.vertices.size(); vertex++) {
+            if (vertexMap[vertex] == m_noVertex) {
+                vertexMap[vertex] = static_cast<uint32_t>(mesh.vertices.size());
+                mesh.vertices.push_back(slab.mesh.vertices[vertex]);
+            }
+        }
+        for (const std::array<uint32_t, 3>& triangle : slab.mesh.triangles) {
+            mesh.triangles.push_back(
+                {vertexMap[triangle[0]], vertexMap[triangle[1]], vertexMap[triangle[2]]});
+        }
+
+        previousPlane = std::move(slab.lastPlaneVertices);
+        for (std::pair<std::size_t, uint32_t>& vertex : previousPlane) {
+            vertex.second = vertexMap[vertex.second];
+        }
+        std::sort(previousPlane.begin(), previousPlane.end());
+
+        // the slab is not needed anymore
+        slab = SlabMesh();
+    }
+    return mesh;
+}
+} // namespace VDTK
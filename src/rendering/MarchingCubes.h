@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+class BrickMinMaxMap;
+
+// Isosurface extraction with marching cubes. Slabs of cell layers are processed in parallel, every
+// slab shares the vertices of neighbouring cells through a vertex cache of two layers. Cells in
+// bricks whose value range excludes the iso value are skipped. The slab meshes get merged into one
+// mesh without duplicated vertices, so the surface is closed wherever it does not leave the volume
+class MarchingCubes {
+public:
+    MarchingCubes();
+    ~MarchingCubes();
+
+    // surface between voxels below and voxels greater or equal to the iso value, the normals point
+    // towards lower values, bricks have to belong to the volume
+    static SurfaceMesh extract(const VolumeData& volume, const uint16_t isoValue,
+                               const BrickMinMaxMap& bricks, const std::size_t numberOfThreads);
+
+private:
+    // triangles of one cube configuration, indices are cube edges
+    struct CubeCase {
+        std::array<uint8_t, 15> edges = {};
+        uint8_t triangleCount = 0;
+    };
+
+    // mesh of one slab, vertices on its first and last plane are shared with the neighbours
+    struct SlabMesh {
+        SurfaceMesh mesh;
+        // (edge key, local vertex index) of the vertices on the x and y edges of the planes
+        std::vector<std::pair<std::size_t, uint32_t>> firstPlaneVertices;
+        std::vector<std::pair<std::size_t, uint32_t>> lastPlaneVertices;
+    };
+
+    static constexpr uint32_t m_noVertex = UINT32_MAX;
+
+    // cases of all 256 corner configurations, created once on first use
+    static const std::array<CubeCase, 256>& getCubeCases();
+    static CubeCase createCubeCase(const std::size_t configuration);
+
+    static SlabMesh extractSlab(const VolumeData& volume, const uint16_t isoValue,
+                                const BrickMinMaxMap& bricks, const std::size_t firstLayer,
+                                const std::size_t lastLayer);
+    static SurfaceMesh mergeSlabs(std::vector<SlabMesh>& slabs);
+};
+} // namespace VDTK
@@ -0,0 +1,395 @@
+#include <cmath>
+#include <threadpool/ThreadPool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../filter/WindowFilter.h"
+#include "../imaga_analysis/BrickMinMaxMap.h"
+#include "VolumeRenderer.h"
+
+namespace VDTK {
+VolumeRenderer::VolumeRenderer() {}
+
+VolumeRenderer::~VolumeRenderer() {}
+
+VolumeSlice VolumeRenderer::render(const VolumeData& volume, const RenderSettings& settings,
+                                   const BrickMinMaxMap& bricks,
+                                   const std::size_t numberOfThreads) {
+    const std::size_t width = settings.imageWidth;
+    const std::size_t height = settings.imageHeight;
+    if (width == 0 || height == 0 || volume.getVoxelCount() == 0 || !bricks.isValid() ||
+        bricks.getVolumeSize() != volume.getSize() || !(settings.sampleDistance > 0.0f)) {
+        return VolumeSlice(VolumeAxis::XYAxis, 0, 0);
+    }
+
+    const VolumeSpacing spacing = volume.getSpacing();
+    const float stepLength =
+        settings.sampleDistance *
+        std::min(std::min(spacing.getX(), spacing.getY()), spacing.getZ());
+    const Camera camera = createCamera(volume, settings);
+    const TransferFunction transferFunction =
+        createTransferFunction(settings, bricks, stepLength);
+
+    // pixel (column, row) of a VolumeSlice is stored at row + height * column
+    std::vector<uint16_t> pixels(width * height, 0);
+    {
+        // create own scope to use destructor of thread pool (wait for all task to
+        // finish)
+        ThreadPool threadPool(numberOfThreads);
+
+        for (std::size_t firstRow = 0; firstRow < height; firstRow += m_tileSize) {
+            for (std::size_t firstColumn = 0; firstColumn < width; firstColumn += m_tileSize) {
+                threadPool.enqueue([&, firstColumn, firstRow]() {
+                    renderTile(volume, camera, transferFunction, bricks, stepLength, width,
+                               height, firstColumn, firstRow, &pixels);
+                });
+            }
+        }
+    }
+
+    return VolumeSlice(VolumeAxis::XYAxis, pixels, width, height);
+}
+
+VolumeRenderer::Camera VolumeRenderer::createCamera(const VolumeData& volume,
+                                                    const RenderSettings& settings) {
+    const VolumeSize size = volume.getSize();
+    const VolumeSpacing spacing = volume.getSpacing();
+    const Vector extent = {static_cast<float>(size.getX() - 1) * spacing.getX(),
+                           static_cast<float>(size.getY() - 1) * spacing.getY(),
+                           static_cast<float>(size.getZ() - 1) * spacing.getZ()};
+    const float diagonal = std::max(
+        std::sqrt(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]), 1.0f);
+    const float halfFieldOfView =
+        std::min(std::max(settings.fieldOfView, 1.0f), 179.0f) * 3.14159265f / 360.0f;
+
+    Vector eye = {settings.eye.getX(), settings.eye.getY(), settings.eye.getZ()};
+    Vector target = {settings.target.getX(), settings.target.getY(), settings.target.getZ()};
+    Vector up = {settings.up.getX(), settings.up.getY(), settings.up.getZ()};
+    if (eye == target) {
+        // look from the front, far enough away to see the whole volume
+        target = {extent[0] / 2.0f, extent[1] / 2.0f, extent[2] / 2.0f};
+        eye = target;
+        eye[1] -= (settings.projection == RenderSettings::Projection::Perspective)
+                      ? diagonal / 2.0f / std::sin(halfFieldOfView)
+                      : diagonal;
+        up = {0.0f, 0.0f, 1.0f};
+    }
+
+    Camera camera;
+    camera.eye = eye;
+    camera.forward =
+        normalize({target[0] - eye[0], target[1] - eye[1], target[2] - eye[2]});
+    camera.right = normalize(cross(camera.forward, up));
+    if (camera.right == Vector{0.0f, 0.0f, 0.0f}) {
+        // up is parallel to the view direction, any perpendicular direction will do
+        camera.right = normalize(cross(camera.forward, {1.0f, 0.0f, 0.0f}));
+        if (camera.right == Vector{0.0f, 0.0f, 0.0f}) {
+            camera.right = normalize(cross(camera.forward, {0.0f, 1.0f, 0.0f}));
+        }
+    }
+    camera.up = cross(camera.right, camera.forward);
+
+    const float aspectRatio =
+        static_cast<float>(settings.imageWidth) / static_cast<float>(settings.imageHeight);
+    camera.perspective = settings.projection == RenderSettings::Projection::Perspective;
+    camera.halfHeight = camera.perspective
+                            ? std::tan(halfFieldOfView)
+                            : ((settings.viewHeight > 0.0f) ? settings.viewHeight : diagonal) /
+                                  2.0f;
+    camera.halfWidth = camera.halfHeight * aspectRatio;
+    return camera;
+}
+
+VolumeRenderer::TransferFunction VolumeRenderer::createTransferFunction(
+    const RenderSettings& settings, const BrickMinMaxMap& bricks, const float stepLength) {
+    auto window = &WindowFilter::getValueWithWindowingFunctionLinear;
+    switch (settings.windowingFunction) {
+    case WindowingFunction::LinearExact: {
+        window = &WindowFilter::getValueWithWindowingFunctionLinearExact;
+        break;
+    }
+    case WindowingFunction::Sigmoid: {
+        window = &WindowFilter::getValueWithWindowingFunctionSigmoid;
+        break;
+    }
+    default: { break; }
+    }
+
+    TransferFunction transferFunction;
+    transferFunction.brightness.resize(UINT16_MAX + 1);
+    transferFunction.opacity.resize(UINT16_MAX + 1);
+    // number of visible values below every value, so bricks are checked in constant time
+    std::vector<uint32_t> visibleValues(UINT16_MAX + 2, 0);
+    for (std::size_t value = 0; value <= UINT16_MAX; value++) {
+        const float brightness =
+            static_cast<float>(window(static_cast<uint16_t>(value), settings.windowCenter,
+                                      settings.windowWidth, settings.windowOffset)) /
+            static_cast<float>(UINT16_MAX);
+        transferFunction.brightness[value] = brightness;
+        // opacity of one step of the ray (Beer-Lambert law)
+        transferFunction.opacity[value] =
+            1.0f - std::exp(-std::max(settings.density, 0.0f) * brightness * stepLength);
+        visibleValues[value + 1] =
+            visibleValues[value] + ((transferFunction.opacity[value] > 0.0f) ? 1 : 0);
+    }
+
+    transferFunction.transparentBricks.resize(bricks.getBrickCount());
+    for (std::size_t brickIndex = 0; brickIndex < bricks.getBrickCount(); brickIndex++) {
+        transferFunction.transparentBricks[brickIndex] =
+            visibleValues[bricks.getMaximum(brickIndex) + 1] ==
+            visibleValues[bricks.getMinimum(brickIndex)];
+    }
+    return transferFunction;
+}
+
+void VolumeRenderer::renderTile(const VolumeData& volume, const Camera& camera,
+                                const TransferFunction& transferFunction,
+                                const BrickMinMaxMap& bricks, const float stepLength,
+                                const std::size_t width, const std::size_t height,
+                                const std::size_t firstColumn, const std::size_t firstRow,
+                                std::vector<uint16_t>* const pixels) {
+    const VolumeSize size = volume.getSize();
+    const VolumeSpacing spacing = volume.getSpacing();
+    const std::array<float, 3> inverseSpacing = {1.0f / spacing.getX(), 1.0f / spacing.getY(),
+                                                 1.0f / spacing.getZ()};
+    const std::array<float, 3> upperBorder = {static_cast<float>(size.getX() - 1),
+                                              static_cast<float>(size.getY() - 1),
+                                              static_cast<float>(size.getZ() - 1)};
+    const std::size_t brickSize = bricks.getBrickSize();
+    const std::size_t lastColumn = std::min(firstColumn + m_tileSize, width);
+    const std::size_t lastRow = std::min(firstRow + m_tileSize, height);
+
+    // rays of a packet, in voxel coordinates with the ray parameter t in physical units
+    alignas(16) float originX[4], originY[4], originZ[4];
+    alignas(16) float directionX[4], directionY[4], directionZ[4];
+    alignas(16) float t[4], tFar[4];
+    alignas(16) float brightness[4], opacity[4];
+    alignas(16) float positionX[4], positionY[4], positionZ[4];
+    alignas(16) float sampleBrightness[4], sampleOpacity[4], advance[4];
+
+    for (std::size_t row = firstRow; row < lastRow; row += 2) {
+        for (std::size_t column = firstColumn; column < lastColumn; column += 2) {
+            // packet of 2x2 neighbouring pixels, their rays stay close in the volume
+            for (std::size_t lane = 0; lane < 4; lane++) {
+                const std::size_t laneColumn = column + (lane & 1);
+                const std::size_t laneRow = row + (lane >> 1);
+                brightness[lane] = 0.0f;
+                opacity[lane] = 0.0f;
+                t[lane] = 1.0f;
+                tFar[lane] = 0.0f;
+                if (laneColumn >= lastColumn || laneRow >= lastRow) {
+                    continue;
+                }
+
+                const float u = (2.0f * (static_cast<float>(laneColumn) + 0.5f) /
+                                     static_cast<float>(width) -
+                                 1.0f) *
+                                camera.halfWidth;
+                const float v = (1.0f - 2.0f * (static_cast<float>(laneRow) + 0.5f) /
+                                            static_cast<float>(height)) *
+                                camera.halfHeight;
+                Vector origin = camera.eye;
+                Vector direction = camera.forward;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    if (camera.perspective) {
+                        direction[axis] += u * camera.right[axis] + v * camera.up[axis];
+                    } else {
+                        origin[axis] += u * camera.right[axis] + v * camera.up[axis];
+                    }
+                }
+                direction = normalize(direction);
+
+                // clip the ray against the volume box, half a voxel around the voxel centers
+                float tNear = 0.0f;
+                float tExit = INFINITY;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    origin[axis] *= inverseSpacing[axis];
+                    direction[axis] *= inverseSpacing[axis];
+                    const float lower = -0.5f;
+                    const float upper = upperBorder[axis] + 0.5f;
+                    if (direction[axis] == 0.0f) {
+                        if (origin[axis] < lower || origin[axis] > upper) {
+                            tExit = -INFINITY;
+                        }
+                        continue;
+                    }
+                    const float t0 = (lower - origin[axis]) / direction[axis];
+                    const float t1 = (upper - origin[axis]) / direction[axis];
+                    tNear = std::max(tNear, std::min(t0, t1));
+                    tExit = std::min(tExit, std::max(t0, t1));
+                }
+
+                originX[lane] = origin[0];
+                originY[lane] = origin[1];
+                originZ[lane] = origin[2];
+                directionX[lane] = direction[0];
+                directionY[lane] = direction[1];
+                directionZ[lane] = direction[2];
+                t[lane] = tNear;
+                tFar[lane] = tExit;
+            }
+
+            while (true) {
+                int activeLanes = 0;
+#if defined(__SSE2__)
+                const __m128 rayT = _mm_load_ps(t);
+                const __m128 active =
+                    _mm_and_ps(_mm_cmple_ps(rayT, _mm_load_ps(tFar)),
+                               _mm_cmplt_ps(_mm_load_ps(opacity), _mm_set1_ps(m_opaqueThreshold)));
+                activeLanes = _mm_movemask_ps(active);
+                if (activeLanes == 0) {
+                    break;
+                }
+
+                // sample positions, clamped to the voxel centers at the border
+                const auto getPosition = [&rayT](const float* const origin,
+                                                 const float* const direction,
+                                                 const float upper) {
+                    const __m128 position = _mm_add_ps(_mm_load_ps(origin),
+                                                       _mm_mul_ps(rayT, _mm_load_ps(direction)));
+                    return _mm_min_ps(_mm_max_ps(position, _mm_setzero_ps()), _mm_set1_ps(upper));
+                };
+                _mm_store_ps(positionX, getPosition(originX, directionX, upperBorder[0]));
+                _mm_store_ps(positionY, getPosition(originY, directionY, upperBorder[1]));
+                _mm_store_ps(positionZ, getPosition(originZ, directionZ, upperBorder[2]));
+#else
+                for (std::size_t lane = 0; lane < 4; lane++) {
+                    if (t[lane] <= tFar[lane] && opacity[lane] < m_opaqueThreshold) {
+                        activeLanes |= 1 << lane;
+                    }
+                    positionX[lane] = std::min(
+                        std::max(originX[lane] + t[lane] * directionX[lane], 0.0f), upperBorder[0]);
+                    positionY[lane] = std::min(
+                        std::max(originY[lane] + t[lane] * directionY[lane], 0.0f), upperBorder[1]);
+                    positionZ[lane] = std::min(
+                        std::max(originZ[lane] + t[lane] * directionZ[lane], 0.0f), upperBorder[2]);
+                }
+                if (activeLanes == 0) {
+                    break;
+                }
+#endif
+
+                // voxels get fetched lane by lane, SSE has no gather
+                for (std::size_t lane = 0; lane < 4; lane++) {
+                    sampleBrightness[lane] = 0.0f;
+                    sampleOpacity[lane] = 0.0f;
+                    advance[lane] = stepLength;
+                    if ((activeLanes & (1 << lane)) == 0) {
+                        continue;
+                    }
+
+                    const std::size_t brickX =
+                        static_cast<std::size_t>(positionX[lane]) / brickSize;
+                    const std::size_t brickY =
+                        static_cast<std::size_t>(positionY[lane]) / brickSize;
+                    const std::size_t brickZ =
+                        static_cast<std::size_t>(positionZ[lane]) / brickSize;
+                    if (transferFunction
+                            .transparentBricks[bricks.getBrickIndex(brickX, brickY, brickZ)]) {
+                        // jump to the point where the ray leaves the brick
+                        const std::array<float, 3> direction = {directionX[lane], directionY[lane],
+                                                                directionZ[lane]};
+                        const std::array<float, 3> origin = {originX[lane], originY[lane],
+                                                             originZ[lane]};
+                        const std::array<std::size_t, 3> brick = {brickX, brickY, brickZ};
+                        float tBrickExit = INFINITY;
+                        for (std::size_t axis = 0; axis < 3; axis++) {
+                            if (direction[axis] != 0.0f) {
+                                const float border = static_cast<float>(
+                                    (brick[axis] + ((direction[axis] > 0.0f) ? 1 : 0)) *
+                                    brickSize);
+                                tBrickExit = std::min(tBrickExit, (border - origin[axis]) /
+                                                                      direction[axis]);
+                            }
+                        }
+                        advance[lane] = std::max(tBrickExit - t[lane] + 1e-3f, stepLength);
+                        continue;
+                    }
+
+                    const uint16_t value =
+                        sample(volume, positionX[lane], positionY[lane], positionZ[lane]);
+                    sampleBrightness[lane] = transferFunction.brightness[value];
+                    sampleOpacity[lane] = transferFunction.opacity[value];
+                }
+
+                // front to back compositing
+#if defined(__SSE2__)
+                const __m128 currentOpacity = _mm_load_ps(opacity);
+                const __m128 contribution = _mm_mul_ps(
+                    _mm_sub_ps(_mm_set1_ps(1.0f), currentOpacity), _mm_load_ps(sampleOpacity));
+                _mm_store_ps(brightness,
+                             _mm_add_ps(_mm_load_ps(brightness),
+                                        _mm_mul_ps(contribution, _mm_load_ps(sampleBrightness))));
+                _mm_store_ps(opacity, _mm_add_ps(currentOpacity, contribution));
+                _mm_store_ps(t, _mm_add_ps(rayT, _mm_load_ps(advance)));
+#else
+                for (std::size_t lane = 0; lane < 4; lane++) {
+                    const float contribution = (1.0f - opacity[lane]) * sampleOpacity[lane];
+                    brightness[lane] += contribution * sampleBrightness[lane];
+                    opacity[lane] += contribution;
+                    t[lane] += advance[lane];
+                }
+#endif
+            }
+
+            for (std::size_t lane = 0; lane < 4; lane++) {
+                const std::size_t laneColumn = column + (lane & 1);
+                const std::size_t laneRow = row + (lane >> 1);
+                if (laneColumn < lastColumn && laneRow < lastRow) {
+                    (*pixels)[laneRow + height * laneColumn] = static_cast<uint16_t>(
+                        std::min(brightness[lane], 1.0f) * static_cast<float>(UINT16_MAX) + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+uint16_t VolumeRenderer::sample(const VolumeData& volume, const float x, const float y,
+                                const float z) {
+    const VolumeSize size = volume.getSize();
+    const uint16_t* const data = volume.getRawVolumeData().data();
+
+    const std::size_t x0 = static_cast<std::size_t>(x);
+    const std::size_t y0 = static_cast<std::size_t>(y);
+    const std::size_t z0 = static_cast<std::size_t>(z);
+    const std::size_t x1 = std::min(x0 + 1, size.getX() - 1);
+    const std::size_t y1 = std::min(y0 + 1, size.getY() - 1);
+    const std::size_t z1 = std::min(z0 + 1, size.getZ() - 1);
+    const float fractionX = x - static_cast<float>(x0);
+    const float fractionY = y - static_cast<float>(y0);
+    const float fractionZ = z - static_cast<float>(z0);
+
+    const auto getValue = [&](const std::size_t positionX, const std::size_t positionY,
+                              const std::size_t positionZ) {
+        return static_cast<float>(
+            data[positionX + size.getX() * (positionY + size.getY() * positionZ)]);
+    };
+    const auto interpolate = [](const float a, const float b, const float fraction) {
+        return a + (b - a) * fraction;
+    };
+
+    const float value = interpolate(
+        interpolate(interpolate(getValue(x0, y0, z0), getValue(x1, y0, z0), fractionX),
+                    interpolate(getValue(x0, y1, z0), getValue(x1, y1, z0), fractionX), fractionY),
+        interpolate(interpolate(getValue(x0, y0, z1), getValue(x1, y0, z1), fractionX),
+                    interpolate(getValue(x0, y1, z1), getValue(x1, y1, z1), fractionX), fractionY),
+        fractionZ);
+    return static_cast<uint16_t>(value + 0.5f);
+}
+
+VolumeRenderer::Vector VolumeRenderer::normalize(const Vector& vector) {
+    const float length =
+        std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+    if (length == 0.0f) {
+        return {0.0f, 0.0f, 0.0f};
+    }
+    return {vector[0] / length, vector[1] / length, vector[2] / length};
+}
+
+VolumeRenderer::Vector VolumeRenderer::cross(const Vector& lhs, const Vector& rhs) {
+    return {lhs[1] * rhs[2] - lhs[2] * rhs[1], lhs[2] * rhs[0] - lhs[0] * rhs[2],
+            lhs[0] * rhs[1] - lhs[1] * rhs[0]};
+}
+} // namespace VDTK
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+
+#include "../include/VDTK/common/CommonDataTypes.h"
+
+namespace VDTK {
+class BrickMinMaxMap;
+
+// Direct volume rendering on the CPU. Tiles of the image are rendered in parallel, every task
+// traces packets of 2x2 rays with SSE. Rays stop once they are almost opaque and jump over
+// bricks whose value range is transparent in the transfer function
+class VolumeRenderer {
+public:
+    VolumeRenderer();
+    ~VolumeRenderer();
+
+    // brightness image (VolumeAxis::XYAxis, row 0 is the top row), bricks have to belong to the
+    // volume
+    static VolumeSlice render(const VolumeData& volume, const RenderSettings& settings,
+                              const BrickMinMaxMap& bricks, const std::size_t numberOfThreads);
+
+private:
+    typedef std::array<float, 3> Vector;
+
+    struct Camera {
+        Vector eye = {0.0f, 0.0f, 0.0f};
+        Vector forward = {0.0f, 0.0f, 0.0f};
+        Vector right = {0.0f, 0.0f, 0.0f};
+        Vector up = {0.0f, 0.0f, 0.0f};
+        // half of the image plane at distance 1 (perspective) or in physical units
+        float halfWidth = 0.0f;
+        float halfHeight = 0.0f;
+        bool perspective = true;
+    };
+
+    // brightness and opacity of one sample for every voxel value
+    struct TransferFunction {
+        std::vector<float> brightness;
+        std::vector<float> opacity;
+        // per brick, true if no value of its range is visible
+        std::vector<bool> transparentBricks;
+    };
+
+    // edge length of the image tiles rendered by one task
+    static constexpr std::size_t m_tileSize = 32;
+    // rays stop at this accumulated opacity
+    static constexpr float m_opaqueThreshold = 0.99f;
+
+    static Camera createCamera(const VolumeData& volume, const RenderSettings& settings);
+    static TransferFunction createTransferFunction(const RenderSettings& settings,
+                                                   const BrickMinMaxMap& bricks,
+                                                   const float stepLength);
+
+    static void renderTile(const VolumeData& volume, const Camera& camera,
+                           const TransferFunction& transferFunction,
+                           const BrickMinMaxMap& bricks, const float stepLength,
+                           const std::size_t width, const std::size_t height,
+                           const std::size_t firstColumn, const std::size_t firstRow,
+                           std::vector<uint16_t>* const pixels);
+
+    // trilinear interpolation at a position in voxel coordinates inside of the volume
+    static uint16_t sample(const VolumeData& volume, const float x, const float y, const float z);
+
+    static Vector normalize(const Vector& vector);
+    static Vector cross(const Vector& lhs, const Vector& rhs);
+};
+} // namespace VDTK